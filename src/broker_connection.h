@@ -8,6 +8,7 @@
 
 #include "helpers/logger.h"
 #include "config/worker_config.h"
+#include "helpers/calibration.h"
 #include "commands/command_holder.h"
 #include "commands/broker_commands.h"
 #include "commands/jobs_server_commands.h"
@@ -38,6 +39,7 @@ private:
 	std::shared_ptr<const worker_config> config_;
 	std::shared_ptr<proxy> socket_;
 	std::shared_ptr<spdlog::logger> logger_;
+	std::shared_ptr<helpers::calibrator> calibrator_;
 	std::shared_ptr<command_holder<broker_connection_context<proxy>>> broker_cmds_;
 	std::shared_ptr<command_holder<broker_connection_context<proxy>>> jobs_server_cmds_;
 	std::chrono::seconds reconnect_delay = std::chrono::seconds(1);
@@ -52,6 +54,9 @@ private:
 		std::vector<std::string> msg = {"init", config_->get_hwgroup()};
 
 		for (auto &it : headers) { msg.push_back(it.first + "=" + it.second); }
+		if (calibrator_ != nullptr) {
+			for (auto &header : calibrator_->get_headers()) { msg.push_back(header); }
+		}
 		msg.push_back("");
 		msg.push_back("description=" + config_->get_worker_description());
 		if (!current_job_.empty()) { msg.push_back("current_job=" + current_job_); }
@@ -85,11 +90,13 @@ public:
 	 * @param config configuration of the worker
 	 * @param socket a proxy of ZeroMQ communication channels
 	 * @param logger a logging service
+	 * @param calibrator calibration of the host, its scores are sent as headers (optional)
 	 */
 	broker_connection(std::shared_ptr<const worker_config> config,
 		std::shared_ptr<proxy> socket,
-		std::shared_ptr<spdlog::logger> logger = nullptr)
-		: config_(config), socket_(socket), logger_(logger), current_job_("")
+		std::shared_ptr<spdlog::logger> logger = nullptr,
+		std::shared_ptr<helpers::calibrator> calibrator = nullptr)
+		: config_(config), socket_(socket), logger_(logger), calibrator_(calibrator), current_job_("")
 	{
 		if (logger_ == nullptr) { logger_ = helpers::create_null_logger(); }
 
@@ -2,6 +2,7 @@
 #define RECODEX_WORKER_JOB_CONFIG_H
 
 #include <yaml-cpp/node/node.h>
+#include <cfloat>
 #include "task_metadata.h"
 
 
@@ -20,6 +21,10 @@ public:
 	bool log = false;
 	/** List of hwgroup for which this job can be applied. */
 	std::vector<std::string> hwgroups;
+	/** Determines whether results of this job can be memoized and reused for identical jobs. */
+	bool memoize = true;
+	/** Wall time budget of whole job in seconds, FLT_MAX if not set (worker default is used). */
+	float job_wall_time = FLT_MAX;
 
 	/** List of tasks in same order as in configuration file. */
 	std::vector<std::shared_ptr<task_metadata>> tasks;
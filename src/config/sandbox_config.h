@@ -60,6 +60,11 @@ public:
 	 * Working directory relative to the directory with the source files.
 	 */
 	std::string working_directory = "";
+	/**
+	 * Maximal number of runs of the program. When a run exceeds the time limit, the program is run again on the
+	 * original data until a run does not time out. 1 means the program runs only once.
+	 */
+	std::size_t repeat = 1;
 	/**
 	 * Associative array of loaded limits with textual index identifying its hw group.
 	 */
@@ -109,6 +109,11 @@ public:
 	 * 0 means no limit.
 	 */
 	std::size_t processes = 0;
+	/**
+	 * Limit number of instructions executed by the program in user mode, counted by hardware performance counters.
+	 * 0 means no limit. Enforced only by sandboxes which measure performance counters.
+	 */
+	std::size_t instructions = 0;
 	/**
 	 * Set environment variables before run command inside the sandbox.
 	 */
@@ -161,8 +166,8 @@ public:
 			helpers::almost_equal(cpu_time, second.cpu_time) && helpers::almost_equal(wall_time, second.wall_time) &&
 			helpers::almost_equal(extra_time, second.extra_time) && stack_size == second.stack_size &&
 			files_size == second.files_size && disk_size == second.disk_size && disk_files == second.disk_files &&
-			processes == second.processes && share_net == second.share_net && environ_vars == second.environ_vars &&
-			bound_dirs == second.bound_dirs);
+			processes == second.processes && instructions == second.instructions && share_net == second.share_net &&
+			environ_vars == second.environ_vars && bound_dirs == second.bound_dirs);
 	}
 
 	/**
@@ -37,7 +37,8 @@ public:
 		std::shared_ptr<sandbox_config> sandbox = nullptr,
 		std::string test_id = "")
 		: task_id(task_id), priority(priority), dependencies(deps), test_id(test_id), type(type), fatal_failure(fatal),
-		  binary(cmd), cmd_args(args), success_exit_codes({true}), sandbox(sandbox)
+		  binary(cmd), cmd_args(args), success_exit_codes({true}), sandbox(sandbox), memoize(true),
+		  order_hint(0)
 	{
 	}
 
@@ -76,6 +77,15 @@ public:
 
 	/** If not null than this task is external and will be executed in given sandbox. */
 	std::shared_ptr<sandbox_config> sandbox;
+
+	/** If false, results of the job containing this task must not be memoized (e.g., timing-dependent tasks). */
+	bool memoize;
+
+	/**
+	 * Scheduling hint used among tasks with equal priority, tasks with bigger hint are executed first.
+	 * Not part of job configuration, it is filled by the worker (e.g., from failure history of the test).
+	 */
+	double order_hint;
 };
 
 
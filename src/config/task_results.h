@@ -3,6 +3,8 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include "helpers/timings.h"
 
 /**
  * Return error codes of sandbox. Code names corresponds isolate's meta file error codes.
@@ -21,6 +23,82 @@ enum class isolate_status {
 enum class task_status { OK, FAILED, SKIPPED };
 
 
+/**
+ * Resource usage of sandboxed program read from its cgroup (v2).
+ */
+struct cgroup_metrics {
+	/** Total CPU time (s), from cpu.stat usage_usec */
+	float cpu_usage = 0;
+	/** CPU time in user mode (s) */
+	float cpu_user = 0;
+	/** CPU time in kernel mode (s) */
+	float cpu_system = 0;
+	/** Number of periods in which the cgroup was throttled */
+	std::size_t throttled_periods = 0;
+	/** Total time the cgroup was throttled (s) */
+	float throttled_time = 0;
+	/** Peak memory usage of the cgroup (kB), from memory.peak or sampled memory.current */
+	std::size_t memory_peak = 0;
+	/** Number of times the cgroup reached its memory limit, from memory.events */
+	std::size_t oom = 0;
+	/** Number of processes killed by OOM killer */
+	std::size_t oom_kill = 0;
+	/** Bytes read from block devices, from io.stat */
+	std::size_t io_read = 0;
+	/** Bytes written to block devices */
+	std::size_t io_write = 0;
+};
+
+/**
+ * Performance counters of sandboxed program (perf_event_open), which do not depend on load of the machine.
+ */
+struct perf_metrics {
+	/** True if hardware counters (instructions, cycles) were available */
+	bool hardware = false;
+	/** Number of instructions executed in user mode */
+	std::size_t instructions = 0;
+	/** Number of CPU cycles in user mode */
+	std::size_t cycles = 0;
+	/** CPU time measured by task clock (s) */
+	float task_clock = 0;
+};
+
+/**
+ * Times of all runs of a program which was run repeatedly (see sandbox_config::repeat).
+ */
+struct repeat_samples {
+	/** CPU time of each run in order of the runs (s) */
+	std::vector<float> time;
+	/** Wall time of each run (s) */
+	std::vector<float> wall_time;
+	/** Minimal CPU time (s) */
+	float time_min = 0;
+	/** Median of CPU times (s) */
+	float time_median = 0;
+};
+
+/**
+ * Context of the host during a sandboxed run, which tells whether the run could be slowed down by the host.
+ */
+struct host_context {
+	/** Fraction of CPU time of the host stolen by the hypervisor during the run */
+	float steal = 0;
+	/** Average CPU frequency at the start of the run (MHz), zero if unknown */
+	std::size_t frequency_start = 0;
+	/** Average CPU frequency at the end of the run (MHz), zero if unknown */
+	std::size_t frequency_end = 0;
+	/** 1-minute load average of the host at the end of the run */
+	float load = 0;
+	/** Number of periods in which the cgroup of the program was throttled */
+	std::size_t throttled_periods = 0;
+	/** Total time the cgroup of the program was throttled (s) */
+	float throttled_time = 0;
+	/** True if any value exceeded its threshold, the measured times are not reliable */
+	bool tainted = false;
+	/** Names of the exceeded thresholds (steal, frequency, load, throttling) */
+	std::vector<std::string> taints;
+};
+
 /**
  * Sandbox results.
  * @note Not all items must be returned from sandbox, so some defaults may aply.
@@ -81,6 +159,26 @@ struct sandbox_results {
 	 * Default: 0
 	 */
 	std::size_t csw_forced = 0;
+	/**
+	 * Metrics read from cgroup of the sandbox.
+	 * Default: nullptr (not collected)
+	 */
+	std::shared_ptr<cgroup_metrics> cgroup = nullptr;
+	/**
+	 * Performance counters of the sandboxed program.
+	 * Default: nullptr (not measured)
+	 */
+	std::shared_ptr<perf_metrics> perf = nullptr;
+	/**
+	 * Times of all runs if the program was run repeatedly, other values are from the last run.
+	 * Default: nullptr (run once)
+	 */
+	std::shared_ptr<repeat_samples> repeat = nullptr;
+	/**
+	 * Context of the host during the run (if enabled in worker config).
+	 * Default: nullptr
+	 */
+	std::shared_ptr<host_context> host = nullptr;
 
 	/**
 	 * Constructor with default values initialization.
@@ -137,6 +235,11 @@ struct task_results {
 	 * Default: nullptr (other types of tasks)
 	 */
 	std::unique_ptr<sandbox_results> sandbox_status = nullptr;
+	/**
+	 * Durations of individual phases of task execution.
+	 * Default: empty
+	 */
+	helpers::phase_timings timings;
 
 	/**
 	 * Constructor with default values initiazation.
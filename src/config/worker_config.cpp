@@ -144,6 +144,9 @@ worker_config::worker_config(const YAML::Node &config)
 			if (limits["disk-files"] && limits["disk-files"].IsScalar()) {
 				limits_.disk_files = limits["disk-files"].as<std::size_t>();
 			} // no throw... can be omitted
+			if (limits["instructions"] && limits["instructions"].IsScalar()) {
+				limits_.instructions = limits["instructions"].as<std::size_t>();
+			} // no throw... can be omitted
 
 			try {
 				auto bound_dirs = helpers::get_bind_dirs(limits);
@@ -169,6 +172,11 @@ worker_config::worker_config(const YAML::Node &config)
 			throw config_error("Item max-output-length not defined properly");
 		}
 
+		// load output-tail-length
+		if (config["output-tail-length"] && config["output-tail-length"].IsScalar()) {
+			output_tail_length_ = config["output-tail-length"].as<std::size_t>();
+		} // can be omitted... no throw
+
 		// load max-carboncopy-length
 		if (config["max-carboncopy-length"] && config["max-carboncopy-length"].IsScalar()) {
 			max_carboncopy_length_ = config["max-carboncopy-length"].as<std::size_t>();
@@ -183,6 +191,215 @@ worker_config::worker_config(const YAML::Node &config)
 			throw config_error("Item cleanup-submission not defined properly");
 		}
 
+		// load result-cache item
+		if (config["result-cache"] && config["result-cache"].IsMap()) {
+			auto &cache = config["result-cache"];
+
+			if (cache["enabled"] && cache["enabled"].IsScalar()) {
+				result_cache_enabled_ = cache["enabled"].as<bool>();
+			} // can be omitted... no throw
+			if (cache["cache-dir"] && cache["cache-dir"].IsScalar()) {
+				result_cache_dir_ = cache["cache-dir"].as<std::string>();
+			} // can be omitted... no throw
+		} // can be omitted... no throw
+
+		// load result-timings
+		if (config["result-timings"] && config["result-timings"].IsScalar()) {
+			result_timings_ = config["result-timings"].as<bool>();
+		} // can be omitted... no throw
+
+		// load stream-results
+		if (config["stream-results"] && config["stream-results"].IsScalar()) {
+			stream_results_ = config["stream-results"].as<bool>();
+		} // can be omitted... no throw
+
+		// load job-wall-time
+		if (config["job-wall-time"] && config["job-wall-time"].IsScalar()) {
+			job_wall_time_ = config["job-wall-time"].as<float>();
+		} // can be omitted... no throw
+
+		// load failure-history item
+		if (config["failure-history"] && config["failure-history"].IsMap()) {
+			auto &history = config["failure-history"];
+
+			if (history["enabled"] && history["enabled"].IsScalar()) {
+				failure_history_enabled_ = history["enabled"].as<bool>();
+			} // can be omitted... no throw
+			if (history["file"] && history["file"].IsScalar()) {
+				failure_history_file_ = history["file"].as<std::string>();
+			} // can be omitted... no throw
+		} // can be omitted... no throw
+
+		// load result-format
+		if (config["result-format"] && config["result-format"].IsScalar()) {
+			result_format_ = config["result-format"].as<std::string>();
+			if (result_format_ != "yaml" && result_format_ != "cbor") {
+				throw config_error("Item result-format has unknown value");
+			}
+		} // can be omitted... no throw
+
+		// load box-pool item
+		if (config["box-pool"] && config["box-pool"].IsMap()) {
+			auto &pool = config["box-pool"];
+
+			if (pool["size"] && pool["size"].IsScalar()) {
+				box_pool_size_ = pool["size"].as<std::size_t>();
+			} // can be omitted... no throw
+			if (pool["first-box-id"] && pool["first-box-id"].IsScalar()) {
+				box_pool_first_id_ = pool["first-box-id"].as<std::size_t>();
+			} else if (box_pool_size_ > 0) {
+				throw config_error("Item first-box-id of box-pool not defined properly");
+			}
+		} // can be omitted... no throw
+
+		// load box-data-transfer
+		if (config["box-data-transfer"] && config["box-data-transfer"].IsScalar()) {
+			box_data_transfer_ = config["box-data-transfer"].as<std::string>();
+			if (box_data_transfer_ != "copy" && box_data_transfer_ != "rename") {
+				throw config_error("Item box-data-transfer has unknown value");
+			}
+		} // can be omitted... no throw
+
+		// load cgroup-metrics item
+		if (config["cgroup-metrics"] && config["cgroup-metrics"].IsMap()) {
+			auto &cgroup = config["cgroup-metrics"];
+
+			if (cgroup["enabled"] && cgroup["enabled"].IsScalar()) {
+				cgroup_metrics_enabled_ = cgroup["enabled"].as<bool>();
+			} // can be omitted... no throw
+			if (cgroup["root"] && cgroup["root"].IsScalar()) {
+				cgroup_root_ = cgroup["root"].as<std::string>();
+			} else if (cgroup_metrics_enabled_) {
+				throw config_error("Item root of cgroup-metrics not defined properly");
+			}
+			if (cgroup["sample-interval"] && cgroup["sample-interval"].IsScalar()) {
+				cgroup_sample_interval_ = cgroup["sample-interval"].as<std::size_t>();
+			} // can be omitted... no throw
+		} // can be omitted... no throw
+
+		// load namespace-sandbox item
+		if (config["namespace-sandbox"] && config["namespace-sandbox"].IsMap()) {
+			auto &ns = config["namespace-sandbox"];
+			if (ns["cgroup-root"] && ns["cgroup-root"].IsScalar()) {
+				namespace_cgroup_root_ = ns["cgroup-root"].as<std::string>();
+			} // can be omitted... no throw
+			if (ns["uid"] && ns["uid"].IsScalar()) {
+				namespace_uid_ = ns["uid"].as<std::size_t>();
+			} // can be omitted... no throw
+			if (ns["gid"] && ns["gid"].IsScalar()) {
+				namespace_gid_ = ns["gid"].as<std::size_t>();
+			} // can be omitted... no throw
+		} // can be omitted... no throw
+
+		// load cpuset item
+		if (config["cpuset"] && config["cpuset"].IsMap()) {
+			auto &cpuset = config["cpuset"];
+			try {
+				if (cpuset["cpus"] && cpuset["cpus"].IsScalar()) {
+					cpu_placement_.cpus = helpers::parse_cpu_list(cpuset["cpus"].as<std::string>());
+				} // can be omitted... no throw
+				if (cpuset["mems"] && cpuset["mems"].IsScalar()) {
+					cpu_placement_.mems = helpers::parse_cpu_list(cpuset["mems"].as<std::string>());
+				} // can be omitted... no throw
+				if (cpuset["boxes"] && cpuset["boxes"].IsMap()) {
+					for (const auto &box : cpuset["boxes"]) {
+						cpu_placement_.box_cpus[box.first.as<std::size_t>()] =
+							helpers::parse_cpu_list(box.second.as<std::string>());
+					}
+				} // can be omitted... no throw
+			} catch (std::invalid_argument &e) {
+				throw config_error("Item cpuset not defined properly: " + std::string(e.what()));
+			}
+			if (cpuset["exclusive"] && cpuset["exclusive"].IsScalar()) {
+				cpuset_exclusive_ = cpuset["exclusive"].as<bool>();
+			} // can be omitted... no throw
+		} // can be omitted... no throw
+
+		// load tmpfs item
+		if (config["tmpfs"] && config["tmpfs"].IsMap()) {
+			auto &tmpfs = config["tmpfs"];
+			if (tmpfs["dir"] && tmpfs["dir"].IsScalar()) {
+				tmpfs_dir_ = tmpfs["dir"].as<std::string>();
+			} // can be omitted... no throw
+			if (tmpfs["min-free"] && tmpfs["min-free"].IsScalar()) {
+				tmpfs_min_free_ = tmpfs["min-free"].as<std::size_t>();
+			} // can be omitted... no throw
+		} // can be omitted... no throw
+
+		// load box-session
+		if (config["box-session"] && config["box-session"].IsScalar()) {
+			box_session_ = config["box-session"].as<bool>();
+		} // can be omitted... no throw
+
+		// load perf-counters
+		if (config["perf-counters"] && config["perf-counters"].IsScalar()) {
+			perf_counters_ = config["perf-counters"].as<bool>();
+		} // can be omitted... no throw
+
+		// load max-repeat
+		if (config["max-repeat"] && config["max-repeat"].IsScalar()) {
+			max_repeat_ = config["max-repeat"].as<std::size_t>();
+		} // can be omitted... no throw
+
+		// load host-noise item
+		if (config["host-noise"] && config["host-noise"].IsMap()) {
+			auto &noise = config["host-noise"];
+			if (noise["enabled"] && noise["enabled"].IsScalar()) {
+				host_noise_.enabled = noise["enabled"].as<bool>();
+			} // can be omitted... no throw
+			if (noise["max-steal"] && noise["max-steal"].IsScalar()) {
+				host_noise_.max_steal = noise["max-steal"].as<float>();
+			} // can be omitted... no throw
+			if (noise["max-frequency-change"] && noise["max-frequency-change"].IsScalar()) {
+				host_noise_.max_frequency_change = noise["max-frequency-change"].as<float>();
+			} // can be omitted... no throw
+			if (noise["max-load"] && noise["max-load"].IsScalar()) {
+				host_noise_.max_load = noise["max-load"].as<float>();
+			} // can be omitted... no throw
+			if (noise["max-throttled"] && noise["max-throttled"].IsScalar()) {
+				host_noise_.max_throttled = noise["max-throttled"].as<float>();
+			} // can be omitted... no throw
+		} // can be omitted... no throw
+
+		// load calibration item
+		if (config["calibration"] && config["calibration"].IsMap()) {
+			auto &calibration = config["calibration"];
+			if (calibration["enabled"] && calibration["enabled"].IsScalar()) {
+				calibration_.enabled = calibration["enabled"].as<bool>();
+			} // can be omitted... no throw
+			if (calibration["duration"] && calibration["duration"].IsScalar()) {
+				calibration_.duration = calibration["duration"].as<std::size_t>();
+			} // can be omitted... no throw
+		} // can be omitted... no throw
+
+		// load output-capture
+		if (config["output-capture"] && config["output-capture"].IsScalar()) {
+			output_capture_ = config["output-capture"].as<std::string>();
+			if (output_capture_ != "file" && output_capture_ != "pipe") {
+				throw config_error("Item output-capture has unknown value");
+			}
+		} // can be omitted... no throw
+
+		// items which change results of jobs, memoized results are valid only with the same values
+		YAML::Node results_config;
+		for (auto item : {"limits",
+				 "max-output-length",
+				 "output-tail-length",
+				 "max-carboncopy-length",
+				 "result-format",
+				 "result-timings",
+				 "job-wall-time",
+				 "cgroup-metrics",
+				 "perf-counters",
+				 "max-repeat",
+				 "host-noise",
+				 "calibration"}) {
+			if (config[item]) { results_config[item] = config[item]; }
+		}
+		YAML::Emitter results_out;
+		results_out << results_config;
+		results_config_ = results_out.c_str();
+
 	} catch (YAML::Exception &ex) {
 		throw config_error("Default worker configuration was not loaded: " + std::string(ex.what()));
 	}
@@ -256,6 +473,11 @@ size_t worker_config::get_max_output_length() const
 	return max_output_length_;
 }
 
+size_t worker_config::get_output_tail_length() const
+{
+	return output_tail_length_;
+}
+
 size_t worker_config::get_max_carboncopy_length() const
 {
 	return max_carboncopy_length_;
@@ -265,3 +487,143 @@ bool worker_config::get_cleanup_submission() const
 {
 	return cleanup_submission_;
 }
+
+bool worker_config::get_result_cache_enabled() const
+{
+	return result_cache_enabled_;
+}
+
+const std::string &worker_config::get_result_cache_dir() const
+{
+	return result_cache_dir_;
+}
+
+bool worker_config::get_result_timings() const
+{
+	return result_timings_;
+}
+
+bool worker_config::get_stream_results() const
+{
+	return stream_results_;
+}
+
+float worker_config::get_job_wall_time() const
+{
+	return job_wall_time_;
+}
+
+bool worker_config::get_failure_history_enabled() const
+{
+	return failure_history_enabled_;
+}
+
+const std::string &worker_config::get_failure_history_file() const
+{
+	return failure_history_file_;
+}
+
+const std::string &worker_config::get_result_format() const
+{
+	return result_format_;
+}
+
+std::size_t worker_config::get_box_pool_size() const
+{
+	return box_pool_size_;
+}
+
+std::size_t worker_config::get_box_pool_first_id() const
+{
+	return box_pool_first_id_;
+}
+
+const std::string &worker_config::get_box_data_transfer() const
+{
+	return box_data_transfer_;
+}
+
+bool worker_config::get_cgroup_metrics_enabled() const
+{
+	return cgroup_metrics_enabled_;
+}
+
+const std::string &worker_config::get_cgroup_root() const
+{
+	return cgroup_root_;
+}
+
+std::size_t worker_config::get_cgroup_sample_interval() const
+{
+	return cgroup_sample_interval_;
+}
+
+const std::string &worker_config::get_namespace_cgroup_root() const
+{
+	return namespace_cgroup_root_;
+}
+
+std::size_t worker_config::get_namespace_uid() const
+{
+	return namespace_uid_;
+}
+
+std::size_t worker_config::get_namespace_gid() const
+{
+	return namespace_gid_;
+}
+
+const helpers::cpu_placement &worker_config::get_cpu_placement() const
+{
+	return cpu_placement_;
+}
+
+bool worker_config::get_cpuset_exclusive() const
+{
+	return cpuset_exclusive_;
+}
+
+const std::string &worker_config::get_tmpfs_dir() const
+{
+	return tmpfs_dir_;
+}
+
+std::size_t worker_config::get_tmpfs_min_free() const
+{
+	return tmpfs_min_free_;
+}
+
+bool worker_config::get_box_session() const
+{
+	return box_session_;
+}
+
+bool worker_config::get_perf_counters() const
+{
+	return perf_counters_;
+}
+
+std::size_t worker_config::get_max_repeat() const
+{
+	return max_repeat_;
+}
+
+const helpers::host_noise_limits &worker_config::get_host_noise() const
+{
+	return host_noise_;
+}
+
+const helpers::calibration_config &worker_config::get_calibration() const
+{
+	return calibration_;
+}
+
+const std::string &worker_config::get_output_capture() const
+{
+	return output_capture_;
+}
+
+const std::string &worker_config::get_results_config() const
+{
+	return results_config_;
+}
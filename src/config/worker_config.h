@@ -11,6 +11,9 @@
 #include "log_config.h"
 #include "fileman_config.h"
 #include "sandbox/sandbox_base.h"
+#include "helpers/cpuset.h"
+#include "helpers/host_noise.h"
+#include "helpers/calibration.h"
 
 namespace fs = std::filesystem;
 
@@ -111,6 +114,12 @@ public:
 	 */
 	virtual std::size_t get_max_output_length() const;
 
+	/**
+	 * Get length of the end of longer outputs which is written to the results together with their beginning.
+	 * @return length of the end of output in bytes, part of maximal length of output
+	 */
+	virtual std::size_t get_output_tail_length() const;
+
 	/**
 	 * Get maximal length of output which can be copied into results folder.
 	 * @return length of output in bytes
@@ -123,6 +132,176 @@ public:
 	 */
 	virtual bool get_cleanup_submission() const;
 
+	/**
+	 * Get flag which determines if whole job results are memoized and reused for identical jobs.
+	 * @return true if memoization is enabled
+	 */
+	virtual bool get_result_cache_enabled() const;
+
+	/**
+	 * Get path to the directory where memoized job results are stored.
+	 * @return textual representation of path, empty if default location should be used
+	 */
+	virtual const std::string &get_result_cache_dir() const;
+
+	/**
+	 * Get flag which determines if durations of evaluation phases are written to the results.
+	 * @return true if timings section should be present in results
+	 */
+	virtual bool get_result_timings() const;
+
+	/**
+	 * Get flag which determines if results of evaluation tasks are sent through progress channel as soon as
+	 * the tasks finish.
+	 * @return true if results should be streamed
+	 */
+	virtual bool get_stream_results() const;
+
+	/**
+	 * Get wall time budget of whole job. When exceeded, remaining tasks of the job are skipped.
+	 * @return budget in seconds, zero if unlimited
+	 */
+	virtual float get_job_wall_time() const;
+
+	/**
+	 * Get flag which determines if tests which failed most often are run first among tasks with equal priority.
+	 * @return true if failure history is used
+	 */
+	virtual bool get_failure_history_enabled() const;
+
+	/**
+	 * Get path to the file where failure history of tests is stored.
+	 * @return textual representation of path, empty if default location should be used
+	 */
+	virtual const std::string &get_failure_history_file() const;
+
+	/**
+	 * Get format of the results file.
+	 * @return "yaml" (result.yml) or "cbor" (result.cbor)
+	 */
+	virtual const std::string &get_result_format() const;
+
+	/**
+	 * Get number of isolate boxes which are kept initialized ahead of time.
+	 * @return size of the box pool, zero if the pool is disabled
+	 */
+	virtual std::size_t get_box_pool_size() const;
+
+	/**
+	 * Get identifier of the first isolate box of the pool, the pool uses consecutive identifiers.
+	 * @return box identifier
+	 */
+	virtual std::size_t get_box_pool_first_id() const;
+
+	/**
+	 * Get the way evaluation directory is transferred into isolate box.
+	 * @return "copy" (recursive copy) or "rename" (move within one filesystem)
+	 */
+	virtual const std::string &get_box_data_transfer() const;
+
+	/**
+	 * Get flag whether metrics of cgroups of sandboxes are collected.
+	 * @return true if metrics are collected
+	 */
+	virtual bool get_cgroup_metrics_enabled() const;
+
+	/**
+	 * Get cgroup v2 directory which contains cgroups of isolate boxes (box-<id> subdirectories).
+	 * @return path to the directory
+	 */
+	virtual const std::string &get_cgroup_root() const;
+
+	/**
+	 * Get interval of sampling memory usage of sandboxes.
+	 * @return interval in milliseconds, zero if sampling is disabled
+	 */
+	virtual std::size_t get_cgroup_sample_interval() const;
+
+	/**
+	 * Get delegated cgroup v2 directory in which namespace sandbox creates cgroups with limits.
+	 * @return path to the directory, empty if resource limits of processes are used instead
+	 */
+	virtual const std::string &get_namespace_cgroup_root() const;
+
+	/**
+	 * Get user of programs in namespace sandbox, required if the worker runs as root.
+	 * @return uid, zero if the worker user is used
+	 */
+	virtual std::size_t get_namespace_uid() const;
+
+	/**
+	 * Get group of programs in namespace sandbox, required if the worker runs as root.
+	 * @return gid, zero if the worker group is used
+	 */
+	virtual std::size_t get_namespace_gid() const;
+
+	/**
+	 * Get CPUs and memory nodes on which sandboxed programs run.
+	 * @return placement of the worker and its boxes, empty lists mean no restriction
+	 */
+	virtual const helpers::cpu_placement &get_cpu_placement() const;
+
+	/**
+	 * Get flag whether CPUs of sandboxes are reserved for them, so the worker itself does not run there.
+	 * @return true if the CPUs are exclusive
+	 */
+	virtual bool get_cpuset_exclusive() const;
+
+	/**
+	 * Get memory backed directory for evaluation and temporary directories of jobs.
+	 * @return path to the directory, empty if working directory is used
+	 */
+	virtual const std::string &get_tmpfs_dir() const;
+
+	/**
+	 * Get free space of tmpfs directory required to place a job there.
+	 * @return size in kilobytes, zero if disk size limit of the worker is used
+	 */
+	virtual std::size_t get_tmpfs_min_free() const;
+
+	/**
+	 * Get flag whether consecutive sandboxed tasks of a job share one isolate box with their data.
+	 * @return true if isolate sessions are used
+	 */
+	virtual bool get_box_session() const;
+
+	/**
+	 * Get flag whether performance counters of sandboxed programs are measured.
+	 * @return true if the counters are measured
+	 */
+	virtual bool get_perf_counters() const;
+
+	/**
+	 * Get maximal number of runs of a program which is repeated because it ran close to its time limit.
+	 * @return maximal count of runs
+	 */
+	virtual std::size_t get_max_repeat() const;
+
+	/**
+	 * Get thresholds of host noise and whether the context of the host is recorded for sandboxed runs.
+	 * @return thresholds of host noise
+	 */
+	virtual const helpers::host_noise_limits &get_host_noise() const;
+
+	/**
+	 * Get settings of the calibration benchmark of the host.
+	 * @return settings of the calibration
+	 */
+	virtual const helpers::calibration_config &get_calibration() const;
+
+	/**
+	 * Get how outputs of sandboxed programs are captured.
+	 * @return "file" (temporary files in the sandbox) or "pipe" (directly into memory)
+	 */
+	virtual const std::string &get_output_capture() const;
+
+	/**
+	 * Get items of the configuration which change results of jobs (default limits, output lengths, format and
+	 * optional sections of results), used as a part of the memoization key.
+	 * @return the items serialized into YAML
+	 */
+	virtual const std::string &get_results_config() const;
+
 private:
 	/** Unique worker number in context of one machine (0-100 preferably) */
 	std::size_t worker_id_ = 0;
@@ -150,10 +329,68 @@ private:
 	sandbox_limits limits_ = {};
 	/** Maximal length of output from sandbox which can be written to the results file, in bytes. */
 	std::size_t max_output_length_ = 0;
+	/** Part of the maximal length of output taken from the end of longer outputs, in bytes. */
+	std::size_t output_tail_length_ = 0;
 	/** Maximal lenght of output from sandbox which can be copied into results folder, in bytes */
 	std::size_t max_carboncopy_length_ = 0;
 	/** If true then all files created during evaluation of job will be deleted at the end. */
 	bool cleanup_submission_ = true;
+	/** If true then results of whole jobs are memoized and reused when identical job arrives. */
+	bool result_cache_enabled_ = false;
+	/** Directory for memoized job results */
+	std::string result_cache_dir_ = "";
+	/** If true then durations of job and task phases are written to the results file. */
+	bool result_timings_ = false;
+	/** If true then results of evaluation tasks are sent to the broker immediately after the task ends. */
+	bool stream_results_ = false;
+	/** Wall time budget of whole job in seconds, zero means unlimited. */
+	float job_wall_time_ = 0;
+	/** If true then failure rates of tests are tracked and used for ordering of tasks. */
+	bool failure_history_enabled_ = false;
+	/** File with failure history of tests */
+	std::string failure_history_file_ = "";
+	/** Format of the results file */
+	std::string result_format_ = "yaml";
+	/** Number of pre-initialized isolate boxes */
+	std::size_t box_pool_size_ = 0;
+	/** Identifier of the first box of the pool */
+	std::size_t box_pool_first_id_ = 0;
+	/** Mode of transferring evaluation directory into isolate box */
+	std::string box_data_transfer_ = "copy";
+	/** Whether metrics of cgroups of sandboxes are collected */
+	bool cgroup_metrics_enabled_ = false;
+	/** Directory containing cgroups of isolate boxes */
+	std::string cgroup_root_ = "";
+	/** Interval of memory sampling in milliseconds */
+	std::size_t cgroup_sample_interval_ = 0;
+	/** Delegated cgroup directory of namespace sandbox */
+	std::string namespace_cgroup_root_ = "";
+	/** User of programs in namespace sandbox, zero for the worker user */
+	std::size_t namespace_uid_ = 0;
+	/** Group of programs in namespace sandbox, zero for the worker group */
+	std::size_t namespace_gid_ = 0;
+	/** CPUs and memory nodes of sandboxes */
+	helpers::cpu_placement cpu_placement_;
+	/** Whether CPUs of sandboxes are not used by the worker */
+	bool cpuset_exclusive_ = false;
+	/** Memory backed directory for evaluation of jobs */
+	std::string tmpfs_dir_ = "";
+	/** Free space needed in tmpfs directory in kilobytes */
+	std::size_t tmpfs_min_free_ = 0;
+	/** Whether isolate boxes are kept open across tasks of a job */
+	bool box_session_ = false;
+	/** Whether performance counters of sandboxed programs are measured */
+	bool perf_counters_ = false;
+	/** Maximal number of runs of a repeated program */
+	std::size_t max_repeat_ = 5;
+	/** Thresholds of host noise of sandboxed runs */
+	helpers::host_noise_limits host_noise_;
+	/** Settings of the calibration benchmark */
+	helpers::calibration_config calibration_;
+	/** How outputs of sandboxed programs are captured */
+	std::string output_capture_ = "file";
+	/** Items of the configuration which change results of jobs, serialized into YAML */
+	std::string results_config_;
 };
 
 
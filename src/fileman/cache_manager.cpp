@@ -50,6 +50,30 @@ void cache_manager::get_file(const std::string &src_name, const std::string &dst
 	}
 }
 
+void cache_manager::get_readonly_file(const std::string &src_name, const std::string &dst_path)
+{
+	fs::path source_file = caching_dir_ / fs::path(src_name).relative_path();
+	fs::path destination_file = dst_path;
+	logger_->debug("Linking file {} from cache to {}", src_name, dst_path);
+
+	if (!fs::is_regular_file(source_file)) {
+		auto message = "Cache miss. File " + src_name + " is not present in cache.";
+		logger_->debug(message);
+		throw fm_exception(message);
+	}
+
+	try {
+		fs::remove(destination_file);
+		fs::create_hard_link(source_file, destination_file);
+		// change last modification time of the file
+		fs::last_write_time(source_file, fs::file_time_type::clock::now());
+	} catch (fs::filesystem_error &e) {
+		// most likely the cache is on another filesystem
+		logger_->debug("Failed to link file '{}', copying it instead. Error: {}", source_file.string(), e.what());
+		get_file(src_name, dst_path);
+	}
+}
+
 void cache_manager::put_file(const std::string &src_name, const std::string &dst_name)
 {
 	fs::path source_file(src_name);
@@ -43,6 +43,13 @@ public:
 	 *					can be renamed during fetching.
 	 */
 	void get_file(const std::string &src_name, const std::string &dst_name) override;
+	/**
+	 * Hardlink a file from cache to destination, copy it if hardlink cannot be created.
+	 * Destination must not be modified, it shares data with the cache.
+	 * @param src_name Name of the file without path.
+	 * @param dst_name Name of the destination path with requested filename.
+	 */
+	void get_readonly_file(const std::string &src_name, const std::string &dst_name) override;
 	/**
 	 * Copy file to cache.
 	 * @param src_name Path and name of the file to be copied.
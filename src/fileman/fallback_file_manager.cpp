@@ -19,6 +19,18 @@ void fallback_file_manager::get_file(const std::string &src_name, const std::str
 	primary_manager_->put_file(dst_name, src_name);
 }
 
+void fallback_file_manager::get_readonly_file(const std::string &src_name, const std::string &dst_name)
+{
+	try {
+		primary_manager_->get_readonly_file(src_name, dst_name);
+		return;
+	} catch (...) {
+	}
+
+	secondary_manager_->get_file(src_name, dst_name);
+	primary_manager_->put_file(dst_name, src_name);
+}
+
 void fallback_file_manager::put_file(const std::string &src_name, const std::string &dst_url)
 {
 	secondary_manager_->put_file(src_name, dst_url);
@@ -45,6 +45,13 @@ public:
 	 *					caching is transparent from this point of view).
 	 */
 	void get_file(const std::string &src_name, const std::string &dst_name) override;
+	/**
+	 * Try to get read-only file from primary file manager (it may be shared with the cache).
+	 * If that fails, the file is retrieved from secondary manager and put into primary one as in @ref get_file.
+	 * @param src_name Name of requested file.
+	 * @param dst_name Path where to store the file.
+	 */
+	void get_readonly_file(const std::string &src_name, const std::string &dst_name) override;
 
 	/**
 	 * Save file using only secondary manager (i.e. upload file to remote server).
@@ -25,6 +25,16 @@ public:
 	 * @param dst_name Path to file, where the data will be copied.
 	 */
 	virtual void get_file(const std::string &src_name, const std::string &dst_name) = 0;
+	/**
+	 * Get the file which will never be modified by the caller. Managers storing files locally
+	 * may share the data with the destination (hardlink) instead of copying them.
+	 * @param src_name Name of the file to retrieve. Mostly this is sha1sum of the file.
+	 * @param dst_name Path to file, where the data will be available.
+	 */
+	virtual void get_readonly_file(const std::string &src_name, const std::string &dst_name)
+	{
+		get_file(src_name, dst_name);
+	}
 	/**
 	 * Put the file.
 	 * @param src_name Name of the file, which should be put somewhere. Possible use cases are
@@ -0,0 +1,114 @@
+#include "calibration.h"
+#include "timings.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+	/** Results of the kernels are stored here, so the compiler cannot optimize the computation out */
+	volatile double sink;
+
+	/** Size of each of the buffers of the memory kernel, larger than caches of common processors */
+	const std::size_t memory_buffer_size = 32 * 1024 * 1024;
+
+	/**
+	 * Run given chunk of work repeatedly until the duration elapses.
+	 * @return number of chunks per second
+	 */
+	template <typename F> double measure(std::chrono::milliseconds duration, F chunk)
+	{
+		double limit = std::chrono::duration<double>(duration).count();
+		std::size_t count = 0;
+		helpers::stopwatch watch;
+		do {
+			chunk();
+			++count;
+		} while (watch.elapsed() < limit);
+		return count / watch.elapsed();
+	}
+
+	double integer_kernel(std::chrono::milliseconds duration)
+	{
+		const std::size_t iterations = 1 << 16;
+		std::uint64_t x = 88172645463325252ull;
+		std::uint64_t sum = 0;
+		auto rate = measure(duration, [&]() {
+			for (std::size_t i = 0; i < iterations; ++i) {
+				x ^= x << 13;
+				x ^= x >> 7;
+				x ^= x << 17;
+				sum += x % 1000003;
+			}
+		});
+		sink = static_cast<double>(sum);
+		return rate * iterations / 1e6;
+	}
+
+	double floating_kernel(std::chrono::milliseconds duration)
+	{
+		const std::size_t iterations = 1 << 16;
+		const std::size_t chains = 4; // independent chains hide latency of the operations
+		double values[chains] = {1, 2, 3, 4};
+		auto rate = measure(duration, [&]() {
+			for (std::size_t i = 0; i < iterations; ++i) {
+				for (auto &value : values) { value = value * 0.999999 + 0.000001; }
+			}
+		});
+		sink = values[0] + values[1] + values[2] + values[3];
+		return rate * iterations * chains * 2 / 1e6;
+	}
+
+	double memory_kernel(std::chrono::milliseconds duration)
+	{
+		std::vector<char> source(memory_buffer_size, 1);
+		std::vector<char> target(memory_buffer_size, 0);
+		auto rate = measure(duration, [&]() {
+			std::memcpy(target.data(), source.data(), memory_buffer_size);
+			source[0] = target[memory_buffer_size - 1] + 1;
+		});
+		sink = target[0];
+		return rate * memory_buffer_size / 1e6;
+	}
+} // namespace
+
+helpers::calibration_scores helpers::run_calibration(std::chrono::milliseconds duration)
+{
+	calibration_scores scores;
+	scores.integer = integer_kernel(duration);
+	scores.floating = floating_kernel(duration);
+	scores.memory = memory_kernel(duration);
+	scores.measured = true;
+	return scores;
+}
+
+helpers::calibrator::calibrator(const calibration_config &config) : config_(config)
+{
+}
+
+helpers::calibration_scores helpers::calibrator::run()
+{
+	// the suite runs without the lock, so the previous scores can be read meanwhile
+	auto scores = run_calibration(std::chrono::milliseconds(config_.duration));
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	scores_ = scores;
+	return scores;
+}
+
+helpers::calibration_scores helpers::calibrator::get() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return scores_;
+}
+
+std::vector<std::string> helpers::calibrator::get_headers() const
+{
+	auto scores = get();
+	if (!scores.measured) { return {}; }
+
+	auto format = [](double value) { return std::to_string(std::llround(value)); };
+	return {"calibration-integer=" + format(scores.integer),
+		"calibration-floating=" + format(scores.floating),
+		"calibration-memory=" + format(scores.memory)};
+}
@@ -0,0 +1,83 @@
+#ifndef RECODEX_WORKER_HELPERS_CALIBRATION_H
+#define RECODEX_WORKER_HELPERS_CALIBRATION_H
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace helpers
+{
+	/**
+	 * Settings of the calibration benchmark.
+	 */
+	struct calibration_config {
+		/** Whether the calibration is run */
+		bool enabled = false;
+		/** Duration of each kernel of the suite (ms) */
+		std::size_t duration = 100;
+	};
+
+	/**
+	 * Speed of the host measured by the calibration suite, higher is faster.
+	 */
+	struct calibration_scores {
+		/** True if the suite has already been run */
+		bool measured = false;
+		/** Integer arithmetic (millions of iterations of xorshift generator per second) */
+		double integer = 0;
+		/** Floating-point arithmetic (millions of floating-point operations per second) */
+		double floating = 0;
+		/** Memory bandwidth (MB/s copied between buffers larger than caches) */
+		double memory = 0;
+	};
+
+	/**
+	 * Run the calibration suite (integer, floating-point and memory bandwidth kernels) in the current thread.
+	 * @param duration duration of each kernel
+	 * @return measured scores
+	 */
+	calibration_scores run_calibration(std::chrono::milliseconds duration);
+
+	/**
+	 * Holder of the latest calibration of the host, shared by the threads of the worker.
+	 * Host machines in one hardware group may differ in speed, the scores let operators detect slow hosts
+	 * and scale limits per host.
+	 */
+	class calibrator
+	{
+	public:
+		/**
+		 * Constructor, the suite is not run yet.
+		 * @param config settings of the calibration
+		 */
+		explicit calibrator(const calibration_config &config);
+
+		/**
+		 * Run the calibration suite and store the scores.
+		 * @return new scores
+		 */
+		calibration_scores run();
+
+		/**
+		 * Get the latest scores.
+		 */
+		calibration_scores get() const;
+
+		/**
+		 * Get the latest scores formatted as headers of the worker ("calibration-integer=123").
+		 * @return headers, empty if the suite has not been run yet
+		 */
+		std::vector<std::string> get_headers() const;
+
+	private:
+		/** Settings of the calibration */
+		calibration_config config_;
+		/** Guards the scores */
+		mutable std::mutex mutex_;
+		/** Latest scores */
+		calibration_scores scores_;
+	};
+} // namespace helpers
+
+#endif // RECODEX_WORKER_HELPERS_CALIBRATION_H
@@ -0,0 +1,533 @@
+#include "cbor.h"
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdio>
+
+namespace
+{
+	/** Major types of CBOR items. */
+	const uint8_t major_uint = 0;
+	const uint8_t major_negint = 1;
+	const uint8_t major_bytes = 2;
+	const uint8_t major_text = 3;
+	const uint8_t major_array = 4;
+	const uint8_t major_map = 5;
+	const uint8_t major_tag = 6;
+	const uint8_t major_simple = 7;
+	/** Additional information denoting indefinite length. */
+	const uint8_t indefinite = 31;
+	/** Byte which closes items of indefinite length. */
+	const uint8_t break_byte = 0xff;
+
+	bool is_integer(const std::string &value)
+	{
+		std::size_t start = (value.size() > 1 && (value[0] == '-' || value[0] == '+')) ? 1 : 0;
+		if (value.size() == start) { return false; }
+		for (std::size_t i = start; i < value.size(); ++i) {
+			if (value[i] < '0' || value[i] > '9') { return false; }
+		}
+		return true;
+	}
+
+	bool is_float(const std::string &value)
+	{
+		if (value.empty() || value.find_first_not_of("0123456789+-.eE") != std::string::npos) { return false; }
+		char *end = nullptr;
+		std::strtod(value.c_str(), &end);
+		return end == value.c_str() + value.size();
+	}
+
+	uint8_t read_byte(const std::string &data, std::size_t &pos)
+	{
+		if (pos >= data.size()) { throw helpers::cbor_exception("Unexpected end of CBOR data"); }
+		return static_cast<uint8_t>(data[pos++]);
+	}
+
+	uint64_t read_argument(const std::string &data, std::size_t &pos, uint8_t info)
+	{
+		if (info < 24) { return info; }
+		if (info > 27) { throw helpers::cbor_exception("Malformed CBOR item head"); }
+
+		std::size_t length = std::size_t(1) << (info - 24);
+		uint64_t result = 0;
+		for (std::size_t i = 0; i < length; ++i) { result = (result << 8) | read_byte(data, pos); }
+		return result;
+	}
+
+	std::string read_string(const std::string &data, std::size_t &pos, uint64_t length)
+	{
+		if (length > data.size() - pos) { throw helpers::cbor_exception("Unexpected end of CBOR data"); }
+		std::string result = data.substr(pos, length);
+		pos += length;
+		return result;
+	}
+
+	double half_to_double(uint16_t half)
+	{
+		int exponent = (half >> 10) & 0x1f;
+		int mantissa = half & 0x3ff;
+		double value;
+		if (exponent == 0) {
+			value = std::ldexp(mantissa, -24);
+		} else if (exponent != 31) {
+			value = std::ldexp(mantissa + 1024, exponent - 25);
+		} else {
+			value = mantissa == 0 ? INFINITY : NAN;
+		}
+		return (half & 0x8000) ? -value : value;
+	}
+
+	/**
+	 * Shortest textual representation which is parsed back to the same value, so decoded numbers look like
+	 * the ones written by hand (0.1 instead of 0.10000000000000001).
+	 */
+	template <typename T> std::string format_floating(T value)
+	{
+		if (std::isnan(value)) { return ".nan"; }
+		if (std::isinf(value)) { return value > 0 ? ".inf" : "-.inf"; }
+
+		char buffer[32];
+		for (int precision = 1; precision < 17; ++precision) {
+			std::snprintf(buffer, sizeof(buffer), "%.*g", precision, static_cast<double>(value));
+			if (static_cast<T>(std::strtod(buffer, nullptr)) == value) { return buffer; }
+		}
+		std::snprintf(buffer, sizeof(buffer), "%.17g", static_cast<double>(value));
+		return buffer;
+	}
+
+	/**
+	 * Decode one item at given position, node can be nullptr if the item should be only skipped.
+	 */
+	void decode_item(const std::string &data, std::size_t &pos, YAML::Node *node)
+	{
+		uint8_t initial = read_byte(data, pos);
+		uint8_t major = initial >> 5;
+		uint8_t info = initial & 0x1f;
+
+		if (info == indefinite && (major == major_bytes || major == major_text)) {
+			// chunked string, all chunks have to be definite strings of the same type
+			std::string value;
+			while (true) {
+				if (pos >= data.size()) { throw helpers::cbor_exception("Unexpected end of CBOR data"); }
+				if (data[pos] == static_cast<char>(break_byte)) { break; }
+				uint8_t chunk = read_byte(data, pos);
+				if ((chunk >> 5) != major || (chunk & 0x1f) == indefinite) {
+					throw helpers::cbor_exception("Malformed chunk of CBOR string");
+				}
+				value += read_string(data, pos, read_argument(data, pos, chunk & 0x1f));
+			}
+			++pos;
+			if (node) { *node = value; }
+			return;
+		} else if (info == indefinite && (major == major_array || major == major_map)) {
+			if (node) { *node = YAML::Node(major == major_array ? YAML::NodeType::Sequence : YAML::NodeType::Map); }
+			while (true) {
+				if (pos >= data.size()) { throw helpers::cbor_exception("Unexpected end of CBOR data"); }
+				if (data[pos] == static_cast<char>(break_byte)) { break; }
+				YAML::Node key, value;
+				if (major == major_map) { decode_item(data, pos, node ? &key : nullptr); }
+				decode_item(data, pos, node ? &value : nullptr);
+				if (!node) { continue; }
+				if (major == major_array) {
+					node->push_back(value);
+				} else {
+					(*node)[key.as<std::string>()] = value;
+				}
+			}
+			++pos;
+			return;
+		}
+
+		if (major == major_simple) {
+			switch (info) {
+			case 20:
+				if (node) { *node = false; }
+				return;
+			case 21:
+				if (node) { *node = true; }
+				return;
+			case 22:
+			case 23:
+				if (node) { *node = YAML::Node(YAML::NodeType::Null); }
+				return;
+			case 25: {
+				auto half = static_cast<uint16_t>(read_argument(data, pos, info));
+				if (node) { *node = format_floating(half_to_double(half)); }
+				return;
+			}
+			case 26: {
+				auto bits = static_cast<uint32_t>(read_argument(data, pos, info));
+				float value;
+				std::memcpy(&value, &bits, sizeof(value));
+				if (node) { *node = format_floating(value); }
+				return;
+			}
+			case 27: {
+				uint64_t bits = read_argument(data, pos, info);
+				double value;
+				std::memcpy(&value, &bits, sizeof(value));
+				if (node) { *node = format_floating(value); }
+				return;
+			}
+			default:
+				if (info < 24) { return; }
+				throw helpers::cbor_exception("Unsupported CBOR simple value");
+			}
+		}
+
+		uint64_t argument = read_argument(data, pos, info);
+		switch (major) {
+		case major_uint:
+			if (node) { *node = argument; }
+			break;
+		case major_negint:
+			if (node) { *node = -1 - static_cast<int64_t>(argument); }
+			break;
+		case major_bytes:
+		case major_text: {
+			auto value = read_string(data, pos, argument);
+			if (node) { *node = value; }
+			break;
+		}
+		case major_array:
+			if (node) { *node = YAML::Node(YAML::NodeType::Sequence); }
+			for (uint64_t i = 0; i < argument; ++i) {
+				YAML::Node value;
+				decode_item(data, pos, node ? &value : nullptr);
+				if (node) { node->push_back(value); }
+			}
+			break;
+		case major_map:
+			if (node) { *node = YAML::Node(YAML::NodeType::Map); }
+			for (uint64_t i = 0; i < argument; ++i) {
+				YAML::Node key, value;
+				decode_item(data, pos, node ? &key : nullptr);
+				decode_item(data, pos, node ? &value : nullptr);
+				if (node) { (*node)[key.as<std::string>()] = value; }
+			}
+			break;
+		case major_tag: decode_item(data, pos, node); break;
+		}
+	}
+} // namespace
+
+
+helpers::cbor_writer::cbor_writer(std::ostream &out) : out_(out)
+{
+}
+
+void helpers::cbor_writer::write_head(uint8_t major, uint64_t argument)
+{
+	char buffer[9];
+	std::size_t length;
+	if (argument < 24) {
+		buffer[0] = static_cast<char>((major << 5) | argument);
+		length = 0;
+	} else if (argument <= 0xff) {
+		buffer[0] = static_cast<char>((major << 5) | 24);
+		length = 1;
+	} else if (argument <= 0xffff) {
+		buffer[0] = static_cast<char>((major << 5) | 25);
+		length = 2;
+	} else if (argument <= 0xffffffff) {
+		buffer[0] = static_cast<char>((major << 5) | 26);
+		length = 4;
+	} else {
+		buffer[0] = static_cast<char>((major << 5) | 27);
+		length = 8;
+	}
+
+	// big endian argument
+	for (std::size_t i = 0; i < length; ++i) { buffer[length - i] = static_cast<char>(argument >> (8 * i)); }
+	out_.write(buffer, length + 1);
+}
+
+void helpers::cbor_writer::write_uint(uint64_t value)
+{
+	write_head(major_uint, value);
+}
+
+void helpers::cbor_writer::write_int(int64_t value)
+{
+	if (value >= 0) {
+		write_head(major_uint, static_cast<uint64_t>(value));
+	} else {
+		write_head(major_negint, static_cast<uint64_t>(-1 - value));
+	}
+}
+
+void helpers::cbor_writer::write_float(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	char buffer[5] = {static_cast<char>((major_simple << 5) | 26)};
+	for (std::size_t i = 0; i < 4; ++i) { buffer[4 - i] = static_cast<char>(bits >> (8 * i)); }
+	out_.write(buffer, sizeof(buffer));
+}
+
+void helpers::cbor_writer::write_double(double value)
+{
+	uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	char buffer[9] = {static_cast<char>((major_simple << 5) | 27)};
+	for (std::size_t i = 0; i < 8; ++i) { buffer[8 - i] = static_cast<char>(bits >> (8 * i)); }
+	out_.write(buffer, sizeof(buffer));
+}
+
+void helpers::cbor_writer::write_bool(bool value)
+{
+	out_.put(static_cast<char>((major_simple << 5) | (value ? 21 : 20)));
+}
+
+void helpers::cbor_writer::write_null()
+{
+	out_.put(static_cast<char>((major_simple << 5) | 22));
+}
+
+void helpers::cbor_writer::write_string(const std::string &value)
+{
+	write_head(major_text, value.size());
+	out_.write(value.data(), value.size());
+}
+
+void helpers::cbor_writer::begin_array(std::size_t size)
+{
+	write_head(major_array, size);
+}
+
+void helpers::cbor_writer::begin_map(std::size_t size)
+{
+	write_head(major_map, size);
+}
+
+void helpers::cbor_writer::begin_array()
+{
+	out_.put(static_cast<char>((major_array << 5) | indefinite));
+}
+
+void helpers::cbor_writer::begin_map()
+{
+	out_.put(static_cast<char>((major_map << 5) | indefinite));
+}
+
+void helpers::cbor_writer::end_indefinite()
+{
+	out_.put(static_cast<char>(break_byte));
+}
+
+void helpers::cbor_writer::write_yaml(const YAML::Node &node)
+{
+	switch (node.Type()) {
+	case YAML::NodeType::Undefined:
+	case YAML::NodeType::Null: write_null(); break;
+	case YAML::NodeType::Sequence:
+		begin_array(node.size());
+		for (const auto &item : node) { write_yaml(item); }
+		break;
+	case YAML::NodeType::Map:
+		begin_map(node.size());
+		for (const auto &item : node) {
+			write_string(item.first.Scalar());
+			write_yaml(item.second);
+		}
+		break;
+	case YAML::NodeType::Scalar: {
+		auto &value = node.Scalar();
+		errno = 0;
+		if (node.Tag() == "!") {
+			// quoted scalar is always a string
+			write_string(value);
+		} else if (value == "true" || value == "false") {
+			write_bool(value == "true");
+		} else if (is_integer(value) && value[0] != '-') {
+			auto number = std::strtoull(value.c_str(), nullptr, 10);
+			if (errno == 0) {
+				write_uint(number);
+			} else {
+				write_string(value);
+			}
+		} else if (is_integer(value)) {
+			auto number = std::strtoll(value.c_str(), nullptr, 10);
+			if (errno == 0) {
+				write_int(number);
+			} else {
+				write_string(value);
+			}
+		} else if (is_float(value)) {
+			write_double(std::strtod(value.c_str(), nullptr));
+		} else {
+			write_string(value);
+		}
+		break;
+	}
+	}
+}
+
+void helpers::task_results_to_cbor(cbor_writer &writer, const std::string &task_id, const task_results &results)
+{
+	bool has_output = !results.output_stdout.empty() || !results.output_stderr.empty();
+	auto &sandbox = results.sandbox_status;
+	writer.begin_map(2 + !results.error_message.empty() + has_output + (sandbox != nullptr));
+
+	writer.write_string("task-id");
+	writer.write_string(task_id);
+
+	writer.write_string("status");
+	switch (results.status) {
+	case task_status::OK: writer.write_string("OK"); break;
+	case task_status::FAILED: writer.write_string("FAILED"); break;
+	case task_status::SKIPPED: writer.write_string("SKIPPED"); break;
+	}
+
+	if (!results.error_message.empty()) {
+		writer.write_string("error_message");
+		writer.write_string(results.error_message);
+	}
+
+	if (has_output) {
+		writer.write_string("output");
+		writer.begin_map(!results.output_stdout.empty() + !results.output_stderr.empty());
+		if (!results.output_stdout.empty()) {
+			writer.write_string("stdout");
+			writer.write_string(results.output_stdout);
+		}
+		if (!results.output_stderr.empty()) {
+			writer.write_string("stderr");
+			writer.write_string(results.output_stderr);
+		}
+	}
+
+	if (sandbox != nullptr) {
+		writer.write_string("sandbox_results");
+		writer.begin_map(11 + (sandbox->cgroup != nullptr) + (sandbox->perf != nullptr) +
+			(sandbox->repeat != nullptr) + (sandbox->host != nullptr));
+		writer.write_string("exitcode");
+		writer.write_int(sandbox->exitcode);
+		writer.write_string("time");
+		writer.write_float(sandbox->time);
+		writer.write_string("wall-time");
+		writer.write_float(sandbox->wall_time);
+		writer.write_string("memory");
+		writer.write_uint(sandbox->memory);
+		writer.write_string("max-rss");
+		writer.write_uint(sandbox->max_rss);
+
+		writer.write_string("status");
+		switch (sandbox->status) {
+		case isolate_status::OK: writer.write_string("OK"); break;
+		case isolate_status::RE: writer.write_string("RE"); break;
+		case isolate_status::SG: writer.write_string("SG"); break;
+		case isolate_status::TO: writer.write_string("TO"); break;
+		case isolate_status::XX: writer.write_string("XX"); break;
+		}
+
+		writer.write_string("exitsig");
+		writer.write_int(sandbox->exitsig);
+		writer.write_string("killed");
+		writer.write_bool(sandbox->killed);
+		writer.write_string("message");
+		writer.write_string(sandbox->message);
+		writer.write_string("csw-voluntary");
+		writer.write_uint(sandbox->csw_voluntary);
+		writer.write_string("csw-forced");
+		writer.write_uint(sandbox->csw_forced);
+
+		if (sandbox->cgroup != nullptr) {
+			writer.write_string("cgroup");
+			writer.begin_map(10);
+			writer.write_string("cpu-usage");
+			writer.write_float(sandbox->cgroup->cpu_usage);
+			writer.write_string("cpu-user");
+			writer.write_float(sandbox->cgroup->cpu_user);
+			writer.write_string("cpu-system");
+			writer.write_float(sandbox->cgroup->cpu_system);
+			writer.write_string("throttled-periods");
+			writer.write_uint(sandbox->cgroup->throttled_periods);
+			writer.write_string("throttled-time");
+			writer.write_float(sandbox->cgroup->throttled_time);
+			writer.write_string("memory-peak");
+			writer.write_uint(sandbox->cgroup->memory_peak);
+			writer.write_string("oom");
+			writer.write_uint(sandbox->cgroup->oom);
+			writer.write_string("oom-kill");
+			writer.write_uint(sandbox->cgroup->oom_kill);
+			writer.write_string("io-read");
+			writer.write_uint(sandbox->cgroup->io_read);
+			writer.write_string("io-write");
+			writer.write_uint(sandbox->cgroup->io_write);
+		}
+
+		if (sandbox->perf != nullptr) {
+			writer.write_string("perf");
+			writer.begin_map(4);
+			writer.write_string("hardware");
+			writer.write_bool(sandbox->perf->hardware);
+			writer.write_string("instructions");
+			writer.write_uint(sandbox->perf->instructions);
+			writer.write_string("cycles");
+			writer.write_uint(sandbox->perf->cycles);
+			writer.write_string("task-clock");
+			writer.write_float(sandbox->perf->task_clock);
+		}
+
+		if (sandbox->repeat != nullptr) {
+			writer.write_string("repeat");
+			writer.begin_map(4);
+			writer.write_string("time-min");
+			writer.write_float(sandbox->repeat->time_min);
+			writer.write_string("time-median");
+			writer.write_float(sandbox->repeat->time_median);
+			writer.write_string("time");
+			writer.begin_array(sandbox->repeat->time.size());
+			for (auto time : sandbox->repeat->time) { writer.write_float(time); }
+			writer.write_string("wall-time");
+			writer.begin_array(sandbox->repeat->wall_time.size());
+			for (auto time : sandbox->repeat->wall_time) { writer.write_float(time); }
+		}
+
+		if (sandbox->host != nullptr) {
+			writer.write_string("host");
+			writer.begin_map(8);
+			writer.write_string("steal");
+			writer.write_float(sandbox->host->steal);
+			writer.write_string("frequency-start");
+			writer.write_uint(sandbox->host->frequency_start);
+			writer.write_string("frequency-end");
+			writer.write_uint(sandbox->host->frequency_end);
+			writer.write_string("load");
+			writer.write_float(sandbox->host->load);
+			writer.write_string("throttled-periods");
+			writer.write_uint(sandbox->host->throttled_periods);
+			writer.write_string("throttled-time");
+			writer.write_float(sandbox->host->throttled_time);
+			writer.write_string("tainted");
+			writer.write_bool(sandbox->host->tainted);
+			writer.write_string("taints");
+			writer.begin_array(sandbox->host->taints.size());
+			for (auto &taint : sandbox->host->taints) { writer.write_string(taint); }
+		}
+	}
+}
+
+YAML::Node helpers::cbor_to_yaml(const std::string &data, std::size_t &pos)
+{
+	YAML::Node node;
+	decode_item(data, pos, &node);
+	return node;
+}
+
+YAML::Node helpers::cbor_to_yaml(const std::string &data)
+{
+	std::size_t pos = 0;
+	auto node = cbor_to_yaml(data, pos);
+	if (pos != data.size()) { throw cbor_exception("Trailing data after CBOR item"); }
+	return node;
+}
+
+std::size_t helpers::cbor_skip(const std::string &data, std::size_t pos)
+{
+	decode_item(data, pos, nullptr);
+	return pos;
+}
@@ -0,0 +1,147 @@
+#ifndef RECODEX_WORKER_HELPERS_CBOR_HPP
+#define RECODEX_WORKER_HELPERS_CBOR_HPP
+
+#include <string>
+#include <ostream>
+#include <cstdint>
+#include <yaml-cpp/yaml.h>
+#include "config/task_results.h"
+
+namespace helpers
+{
+	/**
+	 * Streaming writer of CBOR (RFC 8949) encoded data.
+	 * Items are written directly into given stream, containers can have definite or indefinite length.
+	 */
+	class cbor_writer
+	{
+	public:
+		/**
+		 * Construct writer over given stream.
+		 * @param out stream which receives encoded data, it has to outlive the writer
+		 */
+		cbor_writer(std::ostream &out);
+
+		/** Write unsigned integer. */
+		void write_uint(uint64_t value);
+		/** Write signed integer. */
+		void write_int(int64_t value);
+		/** Write single precision floating point number. */
+		void write_float(float value);
+		/** Write double precision floating point number. */
+		void write_double(double value);
+		/** Write boolean value. */
+		void write_bool(bool value);
+		/** Write null value. */
+		void write_null();
+		/** Write UTF-8 text string. */
+		void write_string(const std::string &value);
+
+		/**
+		 * Start array with given number of items.
+		 * @param size number of items which will follow
+		 */
+		void begin_array(std::size_t size);
+		/**
+		 * Start map with given number of pairs.
+		 * @param size number of key-value pairs which will follow
+		 */
+		void begin_map(std::size_t size);
+		/** Start array of indefinite length, has to be closed by @ref end_indefinite. */
+		void begin_array();
+		/** Start map of indefinite length, has to be closed by @ref end_indefinite. */
+		void begin_map();
+		/** Close the innermost container of indefinite length. */
+		void end_indefinite();
+
+		/**
+		 * Write yaml tree. Types of plain scalars are deduced the same way as yaml parsers do (bool, integer,
+		 * floating point number, string), quoted scalars are always strings.
+		 * @param node yaml tree
+		 */
+		void write_yaml(const YAML::Node &node);
+
+	private:
+		/** Write head of item with given major type and argument. */
+		void write_head(uint8_t major, uint64_t argument);
+
+		/** Output stream */
+		std::ostream &out_;
+	};
+
+	/**
+	 * Write results of one task in the same structure as @ref task_results_to_yaml does.
+	 * @param writer CBOR writer
+	 * @param task_id identification of the task
+	 * @param results results of the task
+	 */
+	void task_results_to_cbor(cbor_writer &writer, const std::string &task_id, const task_results &results);
+
+	/**
+	 * Decode one CBOR item into yaml tree. Byte strings are decoded as strings, tags are ignored.
+	 * @param data encoded data
+	 * @param pos position of the item, set to the position right after the item
+	 * @return decoded tree
+	 * @throws cbor_exception if the data are malformed
+	 */
+	YAML::Node cbor_to_yaml(const std::string &data, std::size_t &pos);
+
+	/**
+	 * Decode CBOR document containing one item into yaml tree.
+	 * @param data encoded data
+	 * @return decoded tree
+	 * @throws cbor_exception if the data are malformed
+	 */
+	YAML::Node cbor_to_yaml(const std::string &data);
+
+	/**
+	 * Skip one CBOR item without decoding it.
+	 * @param data encoded data
+	 * @param pos position of the item
+	 * @return position right after the item
+	 * @throws cbor_exception if the data are malformed
+	 */
+	std::size_t cbor_skip(const std::string &data, std::size_t pos);
+
+
+	/**
+	 * Special exception for CBOR helper functions/classes.
+	 */
+	class cbor_exception : public std::exception
+	{
+	public:
+		/**
+		 * Generic constructor.
+		 */
+		cbor_exception() : what_("Generic CBOR exception")
+		{
+		}
+		/**
+		 * Constructor with specified cause.
+		 * @param what cause of this exception
+		 */
+		cbor_exception(const std::string &what) : what_(what)
+		{
+		}
+
+		/**
+		 * Stated for completion.
+		 */
+		~cbor_exception() override = default;
+
+		/**
+		 * Returns description of exception.
+		 * @return c-style string
+		 */
+		const char *what() const noexcept override
+		{
+			return what_.c_str();
+		}
+
+	protected:
+		/** Message of the exception. */
+		std::string what_;
+	};
+} // namespace helpers
+
+#endif // RECODEX_WORKER_HELPERS_CBOR_HPP
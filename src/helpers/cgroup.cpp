@@ -0,0 +1,80 @@
+#include "cgroup.h"
+#include <fstream>
+#include <sstream>
+#include <map>
+
+namespace
+{
+	/**
+	 * Parse flat keyed file ("key value" on each line), like cpu.stat or memory.events.
+	 */
+	std::map<std::string, std::size_t> read_keyed_file(const fs::path &file)
+	{
+		std::map<std::string, std::size_t> values;
+		std::ifstream input(file);
+		std::string key;
+		std::size_t value;
+		while (input >> key >> value) { values[key] = value; }
+		return values;
+	}
+
+	std::size_t read_single_value(const fs::path &file)
+	{
+		std::size_t value = 0;
+		std::ifstream input(file);
+		input >> value;
+		return value;
+	}
+} // namespace
+
+std::shared_ptr<cgroup_metrics> helpers::read_cgroup_metrics(const fs::path &dir)
+{
+	std::error_code error;
+	if (!fs::is_directory(dir, error)) { return nullptr; }
+
+	auto metrics = std::make_shared<cgroup_metrics>();
+
+	auto cpu = read_keyed_file(dir / "cpu.stat");
+	metrics->cpu_usage = cpu["usage_usec"] / 1e6f;
+	metrics->cpu_user = cpu["user_usec"] / 1e6f;
+	metrics->cpu_system = cpu["system_usec"] / 1e6f;
+	metrics->throttled_periods = cpu["nr_throttled"];
+	metrics->throttled_time = cpu["throttled_usec"] / 1e6f;
+
+	metrics->memory_peak = read_single_value(dir / "memory.peak") / 1024;
+	auto events = read_keyed_file(dir / "memory.events");
+	metrics->oom = events["oom"];
+	metrics->oom_kill = events["oom_kill"];
+
+	// io.stat has one line per device: "8:0 rbytes=1 wbytes=2 rios=3 ..."
+	std::ifstream io(dir / "io.stat");
+	std::string line;
+	while (std::getline(io, line)) {
+		std::istringstream fields(line);
+		std::string field;
+		fields >> field; // device
+		while (fields >> field) {
+			auto pos = field.find('=');
+			if (pos == std::string::npos) { continue; }
+			auto name = field.substr(0, pos);
+			auto value = std::strtoull(field.c_str() + pos + 1, nullptr, 10);
+			if (name == "rbytes") {
+				metrics->io_read += value;
+			} else if (name == "wbytes") {
+				metrics->io_write += value;
+			}
+		}
+	}
+
+	return metrics;
+}
+
+std::size_t helpers::read_cgroup_memory(const fs::path &dir)
+{
+	return read_single_value(dir / "memory.current") / 1024;
+}
+
+double helpers::read_cgroup_cpu_time(const fs::path &dir)
+{
+	return read_keyed_file(dir / "cpu.stat")["usage_usec"] / 1e6;
+}
@@ -0,0 +1,35 @@
+#ifndef RECODEX_WORKER_HELPERS_CGROUP_H
+#define RECODEX_WORKER_HELPERS_CGROUP_H
+
+#include <memory>
+#include <filesystem>
+#include "config/task_results.h"
+
+namespace fs = std::filesystem;
+
+namespace helpers
+{
+	/**
+	 * Read resource usage of a cgroup from files of cgroup v2 interface (cpu.stat, memory.peak, memory.events
+	 * and io.stat). Files which are missing (e.g., disabled controller) are skipped.
+	 * @param dir directory of the cgroup
+	 * @return metrics of the cgroup, nullptr if the directory does not exist
+	 */
+	std::shared_ptr<cgroup_metrics> read_cgroup_metrics(const fs::path &dir);
+
+	/**
+	 * Read current memory usage of a cgroup (memory.current).
+	 * @param dir directory of the cgroup
+	 * @return memory usage in kB, zero if it cannot be read
+	 */
+	std::size_t read_cgroup_memory(const fs::path &dir);
+
+	/**
+	 * Read total CPU time of all processes of a cgroup (usage_usec of cpu.stat).
+	 * @param dir directory of the cgroup
+	 * @return CPU time in seconds, zero if it cannot be read
+	 */
+	double read_cgroup_cpu_time(const fs::path &dir);
+} // namespace helpers
+
+#endif // RECODEX_WORKER_HELPERS_CGROUP_H
@@ -92,6 +92,12 @@ std::shared_ptr<job_metadata> helpers::build_job_metadata(const YAML::Node &conf
 		} else {
 			throw config_exception("Submission.hw-groups item not loaded properly");
 		}
+		if (submiss["memoize"] && submiss["memoize"].IsScalar()) {
+			job_meta->memoize = submiss["memoize"].as<bool>();
+		} // can be omitted... no throw
+		if (submiss["job-wall-time"] && submiss["job-wall-time"].IsScalar()) {
+			job_meta->job_wall_time = submiss["job-wall-time"].as<float>();
+		} // can be omitted... no throw
 
 
 		// load datas for tasks and save them
@@ -137,6 +143,9 @@ std::shared_ptr<job_metadata> helpers::build_job_metadata(const YAML::Node &conf
 			if (ctask["test-id"] && ctask["test-id"].IsScalar()) {
 				task_meta->test_id = ctask["test-id"].as<std::string>();
 			}
+			if (ctask["memoize"] && ctask["memoize"].IsScalar()) {
+				task_meta->memoize = ctask["memoize"].as<bool>();
+			} // can be omitted... no throw
 
 			// load dependencies
 			if (ctask["dependencies"] && ctask["dependencies"].IsSequence()) {
@@ -190,6 +199,13 @@ std::shared_ptr<job_metadata> helpers::build_job_metadata(const YAML::Node &conf
 				if (ctask["sandbox"]["working-directory"] && ctask["sandbox"]["working-directory"].IsScalar()) {
 					sandbox->working_directory = ctask["sandbox"]["working-directory"].as<std::string>();
 				} // can be ommited... no throw
+				if (ctask["sandbox"]["repeat"] && ctask["sandbox"]["repeat"].IsMap()) {
+					auto repeat = ctask["sandbox"]["repeat"];
+					if (repeat["count"] && repeat["count"].IsScalar()) {
+						sandbox->repeat = repeat["count"].as<std::size_t>();
+					}
+					if (sandbox->repeat == 0) { throw config_exception("Repeat count of sandbox must be positive"); }
+				} // can be ommited... no throw
 
 				// load limits... if they are supplied
 				if (ctask["sandbox"]["limits"]) {
@@ -257,6 +273,11 @@ std::shared_ptr<job_metadata> helpers::build_job_metadata(const YAML::Node &conf
 						} else {
 							sl->disk_files = SIZE_MAX; // set undefined value (max std::size_t)
 						}
+						if (lim["instructions"] && lim["instructions"].IsScalar()) {
+							sl->instructions = lim["instructions"].as<std::size_t>();
+						} else {
+							sl->instructions = SIZE_MAX; // set undefined value (max std::size_t)
+						}
 
 						// find bound dirs from config and attach them to limits
 						auto bound_dirs = helpers::get_bind_dirs(lim);
@@ -0,0 +1,137 @@
+#include "cpuset.h"
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace
+{
+#ifndef _WIN32
+	/** Memory policies of set_mempolicy(2), numaif.h is not required */
+	const int mpol_default = 0;
+	const int mpol_bind = 2;
+	/** Maximal number of memory nodes supported */
+	const std::size_t max_nodes = 1024;
+	const std::size_t bits = 8 * sizeof(unsigned long);
+
+	void throw_errno(const std::string &what)
+	{
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+#endif
+} // namespace
+
+const std::vector<std::size_t> &helpers::cpu_placement::get_cpus(std::size_t box_id) const
+{
+	auto it = box_cpus.find(box_id);
+	return it != box_cpus.end() ? it->second : cpus;
+}
+
+std::vector<std::size_t> helpers::parse_cpu_list(const std::string &list)
+{
+	std::vector<std::size_t> result;
+	std::size_t pos = 0;
+	while (pos < list.size()) {
+		auto end = list.find(',', pos);
+		if (end == std::string::npos) { end = list.size(); }
+		auto item = list.substr(pos, end - pos);
+		pos = end + 1;
+
+		auto dash = item.find('-');
+		std::size_t first_len, last_len;
+		std::size_t first, last;
+		try {
+			first = std::stoul(item.substr(0, dash), &first_len);
+			last = dash == std::string::npos ? first : std::stoul(item.substr(dash + 1), &last_len);
+		} catch (std::logic_error &) {
+			throw std::invalid_argument("Malformed item '" + item + "' of CPU list");
+		}
+		if (first_len != item.substr(0, dash).size() ||
+			(dash != std::string::npos && last_len != item.size() - dash - 1) || first > last) {
+			throw std::invalid_argument("Malformed item '" + item + "' of CPU list");
+		}
+		for (auto i = first; i <= last; ++i) { result.push_back(i); }
+	}
+
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	return result;
+}
+
+std::string helpers::format_cpu_list(const std::vector<std::size_t> &cpus)
+{
+	std::string result;
+	for (auto cpu : cpus) {
+		if (!result.empty()) { result += ","; }
+		result += std::to_string(cpu);
+	}
+	return result;
+}
+
+#ifndef _WIN32
+
+helpers::scoped_placement::scoped_placement(const std::vector<std::size_t> &cpus, const std::vector<std::size_t> &mems)
+{
+	if (!cpus.empty()) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (auto cpu : cpus) {
+			if (cpu >= CPU_SETSIZE) { throw std::system_error(EINVAL, std::generic_category(), "sched_setaffinity"); }
+			CPU_SET(cpu, &set);
+		}
+		if (sched_getaffinity(0, sizeof(old_cpus_), &old_cpus_) != 0) { throw_errno("sched_getaffinity"); }
+		if (sched_setaffinity(0, sizeof(set), &set) != 0) { throw_errno("sched_setaffinity"); }
+		cpus_set_ = true;
+	}
+
+	if (!mems.empty()) {
+		old_mems_.resize(max_nodes / bits);
+		std::vector<unsigned long> nodes(max_nodes / bits);
+		for (auto node : mems) {
+			if (node >= max_nodes) { throw std::system_error(EINVAL, std::generic_category(), "set_mempolicy"); }
+			nodes[node / bits] |= 1UL << (node % bits);
+		}
+		try {
+			if (syscall(SYS_get_mempolicy, &old_mode_, old_mems_.data(), max_nodes, nullptr, 0) != 0) {
+				throw_errno("get_mempolicy");
+			}
+			if (syscall(SYS_set_mempolicy, mpol_bind, nodes.data(), max_nodes) != 0) { throw_errno("set_mempolicy"); }
+		} catch (...) {
+			if (cpus_set_) { sched_setaffinity(0, sizeof(old_cpus_), &old_cpus_); }
+			throw;
+		}
+		mems_set_ = true;
+	}
+}
+
+helpers::scoped_placement::~scoped_placement()
+{
+	if (cpus_set_) { sched_setaffinity(0, sizeof(old_cpus_), &old_cpus_); }
+	if (mems_set_) {
+		if (old_mode_ == mpol_default) {
+			syscall(SYS_set_mempolicy, mpol_default, nullptr, 0);
+		} else {
+			syscall(SYS_set_mempolicy, old_mode_, old_mems_.data(), max_nodes);
+		}
+	}
+}
+
+void helpers::exclude_cpus(const std::vector<std::size_t> &cpus)
+{
+	cpu_set_t set;
+	if (sched_getaffinity(0, sizeof(set), &set) != 0) { throw_errno("sched_getaffinity"); }
+	for (auto cpu : cpus) {
+		if (cpu < CPU_SETSIZE) { CPU_CLR(cpu, &set); }
+	}
+	if (CPU_COUNT(&set) == 0) {
+		throw std::system_error(EINVAL, std::generic_category(), "No CPU left for the worker");
+	}
+	if (sched_setaffinity(0, sizeof(set), &set) != 0) { throw_errno("sched_setaffinity"); }
+}
+
+#endif
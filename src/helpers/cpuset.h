@@ -0,0 +1,83 @@
+#ifndef RECODEX_WORKER_HELPERS_CPUSET_H
+#define RECODEX_WORKER_HELPERS_CPUSET_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sched.h>
+#endif
+
+namespace helpers
+{
+	/**
+	 * Placement of sandboxed programs on CPUs and NUMA memory nodes.
+	 */
+	struct cpu_placement {
+		/** CPUs of all sandboxes of the worker, empty if not restricted */
+		std::vector<std::size_t> cpus;
+		/** Memory nodes the sandboxes allocate from, empty if not restricted */
+		std::vector<std::size_t> mems;
+		/** CPUs of particular boxes (by box id), they override @ref cpus */
+		std::map<std::size_t, std::vector<std::size_t>> box_cpus;
+
+		/**
+		 * Get CPUs of given box.
+		 * @param box_id identifier of the box
+		 * @return CPUs of the box if it has its own, CPUs of the worker otherwise
+		 */
+		const std::vector<std::size_t> &get_cpus(std::size_t box_id) const;
+	};
+
+	/**
+	 * Parse list of CPUs or memory nodes in cpuset format, e.g., "0-3,8,10-11".
+	 * @param list textual list, may be empty
+	 * @return sorted numbers without duplicates
+	 * @throws std::invalid_argument if the list is malformed
+	 */
+	std::vector<std::size_t> parse_cpu_list(const std::string &list);
+
+	/**
+	 * Format list of CPUs or memory nodes in cpuset format (comma separated).
+	 */
+	std::string format_cpu_list(const std::vector<std::size_t> &cpus);
+
+#ifndef _WIN32
+	/**
+	 * Restrict CPU affinity and memory policy of the calling thread for the lifetime of the object. Processes
+	 * started by the thread in the meantime inherit both settings, even across exec.
+	 */
+	class scoped_placement
+	{
+	public:
+		/**
+		 * Apply the placement.
+		 * @param cpus CPUs to run on, not changed if empty
+		 * @param mems memory nodes to allocate from, not changed if empty
+		 * @throws std::system_error if the placement cannot be applied
+		 */
+		scoped_placement(const std::vector<std::size_t> &cpus, const std::vector<std::size_t> &mems);
+		/**
+		 * Restore original placement.
+		 */
+		~scoped_placement();
+
+	private:
+		bool cpus_set_ = false;
+		cpu_set_t old_cpus_;
+		bool mems_set_ = false;
+		int old_mode_ = 0;
+		std::vector<unsigned long> old_mems_;
+	};
+
+	/**
+	 * Remove CPUs from the affinity of the calling thread, threads created afterwards inherit it.
+	 * @param cpus CPUs which the thread should not use
+	 * @throws std::system_error if the affinity cannot be changed or no CPU would remain
+	 */
+	void exclude_cpus(const std::vector<std::size_t> &cpus);
+#endif
+} // namespace helpers
+
+#endif // RECODEX_WORKER_HELPERS_CPUSET_H
@@ -1,7 +1,20 @@
 #include "filesystem.h"
+#include <algorithm>
 #include <iostream>
+#include <fstream>
 #include <map>
 
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <linux/fs.h>
+#include <linux/magic.h>
+#endif
+
 /**
  * Try to find matching hardlink in hardlinks map. If src is found in the map, dest is filled with corresponding file.
  * @param hardlinks the hardlinks map (src -> dst)
@@ -69,8 +82,8 @@ void copy_diretory_internal(const fs::path &src, const fs::path &dest, bool skip
 					}
 				}
 
-				// no hardlink created, lets proceed with copying
-				fs::copy(it->path(), destPath);
+				// no hardlink created, lets proceed with copying (cloning if possible)
+				helpers::clone_file(it->path(), destPath);
 			}
 		}
 	} catch (fs::filesystem_error &e) {
@@ -92,6 +105,173 @@ void helpers::copy_directory(const fs::path &src, const fs::path &dest, bool ski
 	::copy_diretory_internal(src, dest, skip_symlinks, hardlinks);
 }
 
+void helpers::clone_file(const fs::path &src, const fs::path &dest)
+{
+#ifdef __linux__
+	// reflink shares data blocks of both files until one of them is modified (btrfs, xfs, ...)
+	if (fs::is_regular_file(src)) {
+		int src_fd = open(src.c_str(), O_RDONLY | O_CLOEXEC);
+		struct stat src_stat;
+		if (src_fd != -1 && fstat(src_fd, &src_stat) == 0) {
+			bool cloned = false;
+			int dest_fd = open(dest.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, src_stat.st_mode & 07777);
+			if (dest_fd != -1) {
+				cloned = ioctl(dest_fd, FICLONE, src_fd) == 0 && fchmod(dest_fd, src_stat.st_mode & 07777) == 0;
+				close(dest_fd);
+				if (!cloned) { unlink(dest.c_str()); }
+			}
+			close(src_fd);
+			if (cloned) { return; }
+		} else if (src_fd != -1) {
+			close(src_fd);
+		}
+	}
+#endif
+
+	// filesystem does not support cloning, errors are reported by regular copy
+	fs::copy(src, dest);
+}
+
+bool helpers::is_tmpfs(const fs::path &dir)
+{
+#ifdef __linux__
+	struct statfs stat;
+	if (statfs(dir.c_str(), &stat) == 0) { return stat.f_type == TMPFS_MAGIC; }
+#endif
+	return false;
+}
+
+namespace
+{
+	/**
+	 * Read part of a file into the buffer at given position.
+	 * @return number of bytes read, less than requested at the end of the file or on error
+	 */
+#ifdef __linux__
+	std::size_t read_part(int fd, std::size_t offset, char *buffer, std::size_t length)
+	{
+		std::size_t done = 0;
+		while (done < length) {
+			auto count = pread(fd, buffer + done, length - done, offset + done);
+			if (count < 0 && errno == EINTR) { continue; }
+			if (count <= 0) { break; }
+			done += count;
+		}
+		return done;
+	}
+#else
+	std::size_t read_part(std::ifstream &input, std::size_t offset, char *buffer, std::size_t length)
+	{
+		input.clear();
+		input.seekg(offset);
+		input.read(buffer, length);
+		return input.gcount();
+	}
+#endif
+} // namespace
+
+std::string helpers::read_file_bounded(const fs::path &file, std::size_t max_length, std::size_t tail_length)
+{
+	std::string result;
+	std::error_code error;
+	auto size = fs::file_size(file, error);
+	if (error || size == 0 || max_length == 0) { return result; }
+
+	tail_length = std::min(tail_length, max_length);
+	std::size_t head_length = size <= max_length ? size : max_length - tail_length;
+	std::size_t tail_offset = size - tail_length;
+	if (size <= max_length) { tail_length = 0; }
+
+#ifdef __linux__
+	int input = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+	if (input == -1) { return result; }
+#else
+	std::ifstream input(file.string(), std::ios::binary);
+	if (!input.is_open()) { return result; }
+#endif
+
+	result.resize(head_length + tail_length);
+	auto length = read_part(input, 0, &result[0], head_length);
+	// file may be shorter than reported, then the tail is not read at all
+	if (length == head_length && tail_length != 0) {
+		length += read_part(input, tail_offset, &result[length], tail_length);
+	}
+	result.resize(length);
+
+#ifdef __linux__
+	close(input);
+#endif
+	return result;
+}
+
+std::size_t helpers::copy_file_bounded(const fs::path &src, const fs::path &dest, std::size_t max_length)
+{
+	std::error_code error;
+	auto size = fs::file_size(src, error);
+	std::size_t length = error ? 0 : std::min<std::size_t>(size, max_length);
+
+#ifdef __linux__
+	int dest_fd = open(dest.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+	if (dest_fd == -1) { return 0; }
+	int src_fd = length == 0 ? -1 : open(src.c_str(), O_RDONLY | O_CLOEXEC);
+	if (src_fd == -1) {
+		close(dest_fd);
+		return 0;
+	}
+
+	// whole file is cloned and the rest cut off, extents are aligned to blocks, so partial clones are not possible
+	std::size_t done = 0;
+	if (ioctl(dest_fd, FICLONE, src_fd) == 0) {
+		done = length;
+		if (size > length && ftruncate(dest_fd, length) != 0) { done = 0; }
+	}
+	while (done < length) {
+		auto count = copy_file_range(src_fd, nullptr, dest_fd, nullptr, length - done, 0);
+		if (count < 0 && errno == EINTR) { continue; }
+		if (count <= 0) { break; }
+		done += count;
+	}
+	if (done < length) {
+		// copy_file_range is not supported between these filesystems, fall back to a fixed-size buffer
+		char buffer[64 * 1024];
+		while (done < length) {
+			auto count = read_part(src_fd, done, buffer, std::min(sizeof(buffer), length - done));
+			if (count == 0 || pwrite(dest_fd, buffer, count, done) != static_cast<ssize_t>(count)) { break; }
+			done += count;
+		}
+	}
+	close(src_fd);
+	close(dest_fd);
+	return done;
+#else
+	std::ofstream output(dest.string(), std::ios::binary | std::ios::trunc);
+	std::ifstream input(src.string(), std::ios::binary);
+	std::size_t done = 0;
+	char buffer[64 * 1024];
+	while (done < length && input.is_open() && output.is_open()) {
+		auto count = read_part(input, done, buffer, std::min(sizeof(buffer), length - done));
+		if (count == 0 || !output.write(buffer, count)) { break; }
+		done += count;
+	}
+	return done;
+#endif
+}
+
+void helpers::remove_symlinks(const fs::path &dir)
+{
+	try {
+		// symlinks are not followed, so removed links are never descended into
+		std::vector<fs::path> symlinks;
+		for (auto &entry : fs::recursive_directory_iterator(dir)) {
+			if (entry.is_symlink()) { symlinks.push_back(entry.path()); }
+		}
+		for (auto &link : symlinks) { fs::remove(link); }
+	} catch (fs::filesystem_error &e) {
+		throw helpers::filesystem_exception(
+			"helpers::remove_symlinks: Error in removing symlinks: " + std::string(e.what()));
+	}
+}
+
 fs::path helpers::normalize_path(const fs::path &path)
 {
 	// prepare root and path chunks
@@ -18,6 +18,52 @@ namespace helpers
 	 */
 	void copy_directory(const fs::path &src, const fs::path &dest, bool skip_symlinks = false);
 
+	/**
+	 * Copy a file. On filesystems supporting reflinks, the copy shares data blocks with the source until
+	 * one of them is modified, so copying is almost free. Otherwise, data are copied as usual.
+	 * @param src source file
+	 * @param dest destination path which should not exist
+	 * @throws fs::filesystem_error if the file cannot be copied
+	 */
+	void clone_file(const fs::path &src, const fs::path &dest);
+
+	/**
+	 * Check whether the directory is on memory backed filesystem (tmpfs).
+	 * @param dir existing directory
+	 * @return true for tmpfs, false otherwise (always on systems other than Linux)
+	 */
+	bool is_tmpfs(const fs::path &dir);
+
+	/**
+	 * Read at most given number of bytes of a file. Only the needed parts of the file are read into a buffer of
+	 * exactly the resulting size. If the file is longer and @a tail_length is not zero, the result consists of the
+	 * beginning of the file and its last @a tail_length bytes, so both the first and the last lines are kept.
+	 * @param file file to be read
+	 * @param max_length maximal length of the result in bytes
+	 * @param tail_length number of bytes (at most @a max_length) taken from the end of longer files
+	 * @return content of the file, empty if the file cannot be read
+	 */
+	std::string read_file_bounded(const fs::path &file, std::size_t max_length, std::size_t tail_length = 0);
+
+	/**
+	 * Copy at most given number of bytes from the beginning of a file, without reading the data into memory.
+	 * A file which fits is cloned by reflink if the filesystem supports it, a longer one is cloned and truncated.
+	 * Otherwise, data are copied inside the kernel (copy_file_range), only as a last resort through a small buffer.
+	 * @param src file to be copied
+	 * @param dest destination, created or truncated even if the source cannot be read
+	 * @param max_length maximal length of the copy in bytes
+	 * @return number of copied bytes
+	 */
+	std::size_t copy_file_bounded(const fs::path &src, const fs::path &dest, std::size_t max_length);
+
+	/**
+	 * Recursively remove all symlinks from given directory. Used on directories which were accessible
+	 * from sandbox and were not copied by @ref copy_directory with skipped symlinks.
+	 * @param dir directory to be processed
+	 * @throws filesystem_exception with appropriate description
+	 */
+	void remove_symlinks(const fs::path &dir);
+
 	/**
 	 * Normalize dots and double dots from given path.
 	 * @param path path which will be processed
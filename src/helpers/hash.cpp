@@ -0,0 +1,41 @@
+#include "hash.h"
+#include "filesystem.h"
+#include <boost/uuid/detail/sha1.hpp>
+#include <fstream>
+#include <cstdio>
+
+namespace
+{
+	std::string digest_to_string(boost::uuids::detail::sha1 &hash)
+	{
+		unsigned int digest[5];
+		hash.get_digest(digest);
+
+		char buffer[41];
+		for (std::size_t i = 0; i < 5; ++i) { std::snprintf(buffer + 8 * i, 9, "%08x", digest[i]); }
+		return std::string(buffer, 40);
+	}
+} // namespace
+
+std::string helpers::sha1_string(const std::string &data)
+{
+	boost::uuids::detail::sha1 hash;
+	hash.process_bytes(data.data(), data.size());
+	return digest_to_string(hash);
+}
+
+std::string helpers::sha1_file(const fs::path &file)
+{
+	std::ifstream input(file.string(), std::ios::in | std::ios::binary);
+	if (!input.is_open()) { throw filesystem_exception("Cannot open file " + file.string() + " for hashing"); }
+
+	boost::uuids::detail::sha1 hash;
+	char buffer[64 * 1024];
+	while (input) {
+		input.read(buffer, sizeof(buffer));
+		hash.process_bytes(buffer, input.gcount());
+	}
+
+	if (input.bad()) { throw filesystem_exception("Reading of file " + file.string() + " failed during hashing"); }
+	return digest_to_string(hash);
+}
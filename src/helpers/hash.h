@@ -0,0 +1,27 @@
+#ifndef RECODEX_WORKER_HELPERS_HASH_H
+#define RECODEX_WORKER_HELPERS_HASH_H
+
+#include <string>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace helpers
+{
+	/**
+	 * Compute SHA-1 digest of given string.
+	 * @param data input data
+	 * @return lowercase hexadecimal representation of the digest
+	 */
+	std::string sha1_string(const std::string &data);
+
+	/**
+	 * Compute SHA-1 digest of the content of given file. File is read in chunks, so it does not have to fit in memory.
+	 * @param file path to the file
+	 * @return lowercase hexadecimal representation of the digest
+	 * @throws filesystem_exception if file cannot be read
+	 */
+	std::string sha1_file(const fs::path &file);
+} // namespace helpers
+
+#endif // RECODEX_WORKER_HELPERS_HASH_H
@@ -0,0 +1,105 @@
+#include "host_noise.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cctype>
+
+namespace
+{
+	/**
+	 * Read steal and total time of all CPUs from the first line of /proc/stat
+	 * ("cpu user nice system idle iowait irq softirq steal guest guest_nice"), guest time is already in user time.
+	 * @return number of CPUs (lines "cpuN")
+	 */
+	std::size_t read_cpu_times(const fs::path &proc_dir, std::size_t &steal, std::size_t &total)
+	{
+		steal = 0;
+		total = 0;
+		std::size_t cpus = 0;
+		std::ifstream input(proc_dir / "stat");
+		std::string line;
+		while (std::getline(input, line)) {
+			if (line.compare(0, 3, "cpu") != 0) { continue; }
+			if (line.size() > 3 && std::isdigit(static_cast<unsigned char>(line[3]))) {
+				++cpus;
+				continue;
+			}
+
+			std::istringstream fields(line.substr(3));
+			std::size_t value;
+			for (std::size_t i = 0; i < 8 && fields >> value; ++i) {
+				total += value;
+				if (i == 7) { steal = value; }
+			}
+		}
+		return cpus;
+	}
+
+	/**
+	 * Average current frequency of all CPUs with cpufreq (MHz), zero if there are none.
+	 */
+	std::size_t read_frequency(const fs::path &sys_dir)
+	{
+		std::size_t sum = 0;
+		std::size_t count = 0;
+		std::error_code error;
+		for (auto &entry : fs::directory_iterator(sys_dir / "devices" / "system" / "cpu", error)) {
+			auto name = entry.path().filename().string();
+			if (name.size() <= 3 || name.compare(0, 3, "cpu") != 0 ||
+				!std::all_of(name.begin() + 3, name.end(), [](unsigned char c) { return std::isdigit(c) != 0; })) {
+				continue;
+			}
+
+			std::size_t khz = 0;
+			std::ifstream input(entry.path() / "cpufreq" / "scaling_cur_freq");
+			if (input >> khz) {
+				sum += khz;
+				++count;
+			}
+		}
+		return count == 0 ? 0 : sum / count / 1000;
+	}
+} // namespace
+
+helpers::host_monitor::host_monitor(const fs::path &proc_dir, const fs::path &sys_dir)
+	: proc_dir_(proc_dir), sys_dir_(sys_dir)
+{
+	read_cpu_times(proc_dir_, steal_start_, total_start_);
+	frequency_start_ = read_frequency(sys_dir_);
+}
+
+std::shared_ptr<host_context> helpers::host_monitor::finish(
+	const host_noise_limits &limits, const cgroup_metrics *cgroup) const
+{
+	auto context = std::make_shared<host_context>();
+
+	std::size_t steal_end, total_end;
+	auto cpus = read_cpu_times(proc_dir_, steal_end, total_end);
+	if (total_end > total_start_ && steal_end >= steal_start_) {
+		context->steal = static_cast<float>(steal_end - steal_start_) / (total_end - total_start_);
+	}
+
+	context->frequency_start = frequency_start_;
+	context->frequency_end = read_frequency(sys_dir_);
+
+	std::ifstream loadavg(proc_dir_ / "loadavg");
+	loadavg >> context->load;
+
+	if (cgroup != nullptr) {
+		context->throttled_periods = cgroup->throttled_periods;
+		context->throttled_time = cgroup->throttled_time;
+	}
+
+	// compare with the thresholds
+	if (context->steal > limits.max_steal) { context->taints.push_back("steal"); }
+	auto frequency_max = std::max(context->frequency_start, context->frequency_end);
+	auto frequency_min = std::min(context->frequency_start, context->frequency_end);
+	if (frequency_min != 0 && frequency_max - frequency_min > limits.max_frequency_change * frequency_max) {
+		context->taints.push_back("frequency");
+	}
+	if (cpus != 0 && context->load / cpus > limits.max_load) { context->taints.push_back("load"); }
+	if (context->throttled_time > limits.max_throttled) { context->taints.push_back("throttling"); }
+	context->tainted = !context->taints.empty();
+
+	return context;
+}
@@ -0,0 +1,67 @@
+#ifndef RECODEX_WORKER_HELPERS_HOST_NOISE_H
+#define RECODEX_WORKER_HELPERS_HOST_NOISE_H
+
+#include <memory>
+#include <filesystem>
+#include "config/task_results.h"
+
+namespace fs = std::filesystem;
+
+namespace helpers
+{
+	/**
+	 * Thresholds of host noise, runs whose host context exceeds any of them are marked as tainted.
+	 */
+	struct host_noise_limits {
+		/** Whether host context of sandboxed runs is recorded */
+		bool enabled = false;
+		/** Maximal fraction of CPU time of the host stolen by the hypervisor during the run */
+		float max_steal = 0.05;
+		/** Maximal relative change of average CPU frequency between the start and the end of the run */
+		float max_frequency_change = 0.1;
+		/** Maximal 1-minute load average per CPU at the end of the run */
+		float max_load = 1;
+		/** Maximal time the cgroup of the program was throttled (s) */
+		float max_throttled = 0;
+	};
+
+	/**
+	 * Records context of the host (CPU steal time, frequency, load) during a sandboxed run, so that runs slowed
+	 * down by the host rather than by the program can be recognized afterwards.
+	 *
+	 * Steal time is read from /proc/stat, load from /proc/loadavg and frequency is an average of scaling_cur_freq
+	 * of all CPUs with cpufreq in /sys/devices/system/cpu. Values which are not available are zero and not checked.
+	 */
+	class host_monitor
+	{
+	public:
+		/**
+		 * Take snapshot of the host at the start of the run.
+		 * @param proc_dir mount point of procfs
+		 * @param sys_dir mount point of sysfs
+		 */
+		explicit host_monitor(const fs::path &proc_dir = "/proc", const fs::path &sys_dir = "/sys");
+
+		/**
+		 * Take snapshot of the host at the end of the run and compare it with the thresholds.
+		 * @param limits thresholds of the noise
+		 * @param cgroup resource usage of the cgroup of the program with throttling counters, may be nullptr
+		 * @return context of the host during the run
+		 */
+		std::shared_ptr<host_context> finish(const host_noise_limits &limits, const cgroup_metrics *cgroup) const;
+
+	private:
+		/** Mount point of procfs */
+		fs::path proc_dir_;
+		/** Mount point of sysfs */
+		fs::path sys_dir_;
+		/** Steal time of all CPUs at the start (ticks) */
+		std::size_t steal_start_ = 0;
+		/** Total time of all CPUs at the start (ticks) */
+		std::size_t total_start_ = 0;
+		/** Average CPU frequency at the start (MHz) */
+		std::size_t frequency_start_ = 0;
+	};
+} // namespace helpers
+
+#endif // RECODEX_WORKER_HELPERS_HOST_NOISE_H
@@ -0,0 +1,183 @@
+#include "output_buffer.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+namespace
+{
+	/** Timeout of waiting for captured output after the program ended in milliseconds */
+	const int capture_poll_timeout = 100;
+} // namespace
+#endif
+
+helpers::output_buffer::output_buffer(
+	std::size_t max_length, std::size_t tail_length, const fs::path &carboncopy, std::size_t carboncopy_length)
+	: max_length_(max_length), tail_length_(std::min(tail_length, max_length)), carboncopy_(carboncopy),
+	  carboncopy_length_(carboncopy_length)
+{
+}
+
+void helpers::output_buffer::reset()
+{
+	size_ = 0;
+	head_.clear();
+	tail_pos_ = 0;
+
+	if (!carboncopy_.empty()) {
+		if (carboncopy_file_.is_open()) { carboncopy_file_.close(); }
+		carboncopy_file_.open(carboncopy_.string(), std::ios::binary | std::ios::trunc);
+		if (!carboncopy_file_.is_open()) {
+			throw std::runtime_error("Carbon copy " + carboncopy_.string() + " cannot be created");
+		}
+	}
+}
+
+void helpers::output_buffer::append(const char *data, std::size_t length)
+{
+	std::size_t position = size_;
+	size_ += length;
+
+	if (carboncopy_file_.is_open() && position < carboncopy_length_) {
+		carboncopy_file_.write(data, std::min(length, carboncopy_length_ - position));
+	}
+
+	if (head_.size() < max_length_) {
+		auto count = std::min(length, max_length_ - head_.size());
+		head_.append(data, count);
+		data += count;
+		length -= count;
+	}
+	if (length == 0 || tail_length_ == 0) { return; }
+
+	// the rest goes to the ring buffer, only its last bytes are kept
+	if (tail_.size() != tail_length_) { tail_.resize(tail_length_); }
+	if (length >= tail_length_) {
+		std::memcpy(&tail_[0], data + length - tail_length_, tail_length_);
+		tail_pos_ = 0;
+		return;
+	}
+	auto first = std::min(length, tail_length_ - tail_pos_);
+	std::memcpy(&tail_[tail_pos_], data, first);
+	std::memcpy(&tail_[0], data + first, length - first);
+	tail_pos_ = (tail_pos_ + length) % tail_length_;
+}
+
+void helpers::output_buffer::finish()
+{
+	if (carboncopy_file_.is_open()) { carboncopy_file_.close(); }
+}
+
+std::size_t helpers::output_buffer::size() const
+{
+	return size_;
+}
+
+std::string helpers::output_buffer::str() const
+{
+	if (size_ <= max_length_) { return head_; }
+
+	// the last bytes of the stream may be partly in the head, if there are not enough of them in the ring buffer
+	std::size_t in_ring = std::min(size_ - max_length_, tail_length_);
+	std::size_t from_head = tail_length_ - in_ring;
+
+	std::string result;
+	result.reserve(max_length_);
+	result.append(head_, 0, max_length_ - tail_length_);
+	result.append(head_, max_length_ - from_head, from_head);
+	if (in_ring == tail_length_) {
+		result.append(tail_, tail_pos_, std::string::npos);
+		result.append(tail_, 0, tail_pos_);
+	} else {
+		result.append(tail_, 0, in_ring);
+	}
+	return result;
+}
+
+#ifndef _WIN32
+
+helpers::output_capture::~output_capture()
+{
+	stop();
+	close_write_ends();
+	for (int fd : read_fds_) {
+		if (fd != -1) { close(fd); }
+	}
+}
+
+int helpers::output_capture::add(output_buffer *buffer)
+{
+	buffer->reset();
+	int fds[2];
+	if (pipe2(fds, O_CLOEXEC) != 0) { throw std::runtime_error(strerror(errno)); }
+	read_fds_.push_back(fds[0]);
+	write_fds_.push_back(fds[1]);
+	buffers_.push_back(buffer);
+	return fds[1];
+}
+
+void helpers::output_capture::close_write_ends()
+{
+	for (int fd : write_fds_) { close(fd); }
+	write_fds_.clear();
+}
+
+void helpers::output_capture::start(std::size_t limit)
+{
+	if (!read_fds_.empty()) { thread_ = std::thread(&output_capture::drain, this, limit); }
+}
+
+void helpers::output_capture::stop()
+{
+	finished_ = true;
+	if (thread_.joinable()) { thread_.join(); }
+	for (auto buffer : buffers_) { buffer->finish(); }
+	buffers_.clear();
+}
+
+bool helpers::output_capture::exceeded() const
+{
+	return exceeded_;
+}
+
+void helpers::output_capture::drain(std::size_t limit)
+{
+	std::vector<struct pollfd> fds;
+	for (int fd : read_fds_) { fds.push_back({fd, POLLIN, 0}); }
+	std::vector<char> chunk(64 * 1024);
+	std::size_t open = fds.size();
+
+	// descendants of the program may keep the pipes open, they are not waited for after the run
+	while (open > 0) {
+		int ready = poll(fds.data(), fds.size(), capture_poll_timeout);
+		if (ready == -1 && errno == EINTR) { continue; }
+		if (ready == -1 || (ready == 0 && finished_)) { break; }
+		for (std::size_t i = 0; i < fds.size(); ++i) {
+			if (fds[i].fd == -1 || fds[i].revents == 0) { continue; }
+			ssize_t length = read(fds[i].fd, chunk.data(), chunk.size());
+			bool done = length == 0 || (length < 0 && errno != EINTR);
+			if (length > 0) {
+				buffers_[i]->append(chunk.data(), length);
+				if (limit != 0 && buffers_[i]->size() > limit) {
+					// further writes of the program fail, as if it reached the file size limit
+					exceeded_ = true;
+					close(read_fds_[i]);
+					read_fds_[i] = -1;
+					done = true;
+				}
+			}
+			if (done) {
+				fds[i].fd = -1;
+				--open;
+			}
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef RECODEX_WORKER_HELPERS_OUTPUT_BUFFER_H
+#define RECODEX_WORKER_HELPERS_OUTPUT_BUFFER_H
+
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <atomic>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace helpers
+{
+	/**
+	 * Bounded in-memory capture of an output stream of a sandboxed program (see @ref read_file_bounded for files).
+	 *
+	 * At most the given number of bytes is kept: the beginning of the stream and, if requested, its last bytes in
+	 * a ring buffer, which is allocated only when the stream gets longer. Memory does not grow with the length of
+	 * the stream. Optionally, the beginning of the stream is written into a carbon copy file as well.
+	 */
+	class output_buffer
+	{
+	public:
+		/**
+		 * Constructor, nothing is allocated yet.
+		 * @param max_length maximal length of the captured output in bytes
+		 * @param tail_length number of bytes (at most @a max_length) kept from the end of longer streams
+		 * @param carboncopy file into which the stream is copied, empty if not copied
+		 * @param carboncopy_length maximal length of the carbon copy in bytes
+		 */
+		output_buffer(std::size_t max_length,
+			std::size_t tail_length = 0,
+			const fs::path &carboncopy = fs::path(),
+			std::size_t carboncopy_length = 0);
+
+		/**
+		 * Start capturing a new stream, previous content is discarded and the carbon copy is truncated.
+		 * @throws std::runtime_error if the carbon copy cannot be created
+		 */
+		void reset();
+
+		/**
+		 * Append data read from the stream.
+		 * @param data received data
+		 * @param length length of the data
+		 */
+		void append(const char *data, std::size_t length);
+
+		/**
+		 * End of the stream, the carbon copy is closed.
+		 */
+		void finish();
+
+		/**
+		 * Get total number of bytes of the stream, including the discarded ones.
+		 */
+		std::size_t size() const;
+
+		/**
+		 * Get captured output, the beginning of the stream followed by its last bytes if it was longer.
+		 */
+		std::string str() const;
+
+	private:
+		/** Maximal length of the captured output */
+		std::size_t max_length_;
+		/** Number of bytes kept from the end of longer streams */
+		std::size_t tail_length_;
+		/** Path of the carbon copy, empty if not copied */
+		fs::path carboncopy_;
+		/** Maximal length of the carbon copy */
+		std::size_t carboncopy_length_;
+		/** Opened carbon copy */
+		std::ofstream carboncopy_file_;
+		/** Total length of the stream */
+		std::size_t size_ = 0;
+		/** First (at most max_length_) bytes of the stream */
+		std::string head_;
+		/** Ring buffer of the last bytes after the head is full */
+		std::string tail_;
+		/** Position of the next write into the ring buffer, the oldest byte when the buffer is full */
+		std::size_t tail_pos_ = 0;
+	};
+
+#ifndef _WIN32
+	/**
+	 * Pipes of captured standard streams of a sandboxed program, drained into their buffers by a separate thread
+	 * during the run, so the program never blocks on a full pipe. A stream which exceeds the limit is not read
+	 * anymore, so the program gets SIGPIPE if it keeps writing. All descriptors are closed and the thread is stopped
+	 * on destruction.
+	 */
+	class output_capture
+	{
+	public:
+		output_capture() = default;
+		~output_capture();
+		output_capture(const output_capture &) = delete;
+		output_capture &operator=(const output_capture &) = delete;
+
+		/**
+		 * Start capturing of a stream into the buffer.
+		 * @param buffer buffer of the stream, reset before the run
+		 * @return write end of the pipe for the program
+		 * @throws std::runtime_error if the pipe cannot be created or the buffer cannot be reset
+		 */
+		int add(output_buffer *buffer);
+
+		/**
+		 * Close write ends, which are only needed by the sandboxed process.
+		 */
+		void close_write_ends();
+
+		/**
+		 * Start draining of the pipes.
+		 * @param limit size of a stream in bytes after which the output is exceeded, zero for no limit
+		 */
+		void start(std::size_t limit);
+
+		/**
+		 * Wait until all output is read (or the program is gone and nothing comes) and finish the buffers.
+		 */
+		void stop();
+
+		/**
+		 * Whether a stream exceeded the limit.
+		 */
+		bool exceeded() const;
+
+	private:
+		/** Body of the draining thread */
+		void drain(std::size_t limit);
+
+		/** Read ends of the pipes, -1 if already closed */
+		std::vector<int> read_fds_;
+		/** Write ends of the pipes, until they are passed to the program */
+		std::vector<int> write_fds_;
+		/** Buffers of the streams in the order of the pipes */
+		std::vector<output_buffer *> buffers_;
+		/** Draining thread */
+		std::thread thread_;
+		/** Set when the program ended, the thread then stops when nothing comes for a while */
+		std::atomic<bool> finished_{false};
+		/** Set when a stream exceeded the limit */
+		std::atomic<bool> exceeded_{false};
+	};
+#endif
+} // namespace helpers
+
+#endif // RECODEX_WORKER_HELPERS_OUTPUT_BUFFER_H
@@ -0,0 +1,75 @@
+#ifndef _WIN32
+
+#include "perf.h"
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstdint>
+#include <system_error>
+
+namespace
+{
+	/**
+	 * Open counter of given event, disabled until execve and inherited by children.
+	 * @return descriptor of the counter, -1 on error (errno is set)
+	 */
+	int open_counter(pid_t pid, std::uint32_t type, std::uint64_t config)
+	{
+		struct perf_event_attr attr = {};
+		attr.size = sizeof(attr);
+		attr.type = type;
+		attr.config = config;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attr.disabled = 1;
+		attr.enable_on_exec = 1;
+		attr.inherit = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		return static_cast<int>(syscall(SYS_perf_event_open, &attr, pid, -1, -1, PERF_FLAG_FD_CLOEXEC));
+	}
+
+	/**
+	 * Read value of the counter scaled by the time it was really counting, zero if it is not available.
+	 */
+	std::uint64_t read_counter(int fd)
+	{
+		if (fd == -1) { return 0; }
+
+		std::uint64_t values[3] = {}; // value, time enabled, time running
+		if (read(fd, values, sizeof(values)) != sizeof(values)) { return 0; }
+		if (values[2] != 0 && values[2] < values[1]) {
+			return static_cast<std::uint64_t>(static_cast<double>(values[0]) * values[1] / values[2]);
+		}
+		return values[0];
+	}
+} // namespace
+
+helpers::perf_counters::perf_counters(pid_t pid)
+{
+	task_clock_fd_ = open_counter(pid, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK);
+	if (task_clock_fd_ == -1) { throw std::system_error(errno, std::generic_category(), "perf_event_open"); }
+
+	// hardware counters are optional, there may be no PMU
+	instructions_fd_ = open_counter(pid, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+	cycles_fd_ = open_counter(pid, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+}
+
+helpers::perf_counters::~perf_counters()
+{
+	for (int fd : {instructions_fd_, cycles_fd_, task_clock_fd_}) {
+		if (fd != -1) { close(fd); }
+	}
+}
+
+perf_metrics helpers::perf_counters::read() const
+{
+	perf_metrics metrics;
+	metrics.hardware = instructions_fd_ != -1;
+	metrics.instructions = read_counter(instructions_fd_);
+	metrics.cycles = read_counter(cycles_fd_);
+	metrics.task_clock = read_counter(task_clock_fd_) / 1e9;
+	return metrics;
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef RECODEX_WORKER_HELPERS_PERF_H
+#define RECODEX_WORKER_HELPERS_PERF_H
+
+#ifndef _WIN32
+
+#include <sys/types.h>
+#include "config/task_results.h"
+
+namespace helpers
+{
+	/**
+	 * Performance counters (perf_event_open) of a process and its descendants.
+	 *
+	 * Instructions and cycles (hardware counters) and task clock (software counter) are counted in user space only,
+	 * which unprivileged users may do up to kernel.perf_event_paranoid 2. Counters are opened disabled and the kernel
+	 * enables them when the process or its descendant calls execve, so preparation of the environment of the program
+	 * is not counted. Descendants created after the counters are opened are counted as well. Hardware counters are
+	 * skipped when the CPU does not provide them (e.g., in virtual machines).
+	 */
+	class perf_counters
+	{
+	public:
+		/**
+		 * Open counters of given process.
+		 * @param pid process which has not created any children yet
+		 * @throws std::system_error if not even the task clock can be counted
+		 */
+		explicit perf_counters(pid_t pid);
+		/**
+		 * Close the counters.
+		 */
+		~perf_counters();
+		perf_counters(const perf_counters &) = delete;
+		perf_counters &operator=(const perf_counters &) = delete;
+
+		/**
+		 * Read current values, including descendants which are still running.
+		 * Values are scaled if the hardware counters were multiplexed with other users.
+		 * @return values of the counters
+		 */
+		perf_metrics read() const;
+
+	private:
+		/** Descriptor of instructions counter, -1 if not available */
+		int instructions_fd_ = -1;
+		/** Descriptor of cycles counter, -1 if not available */
+		int cycles_fd_ = -1;
+		/** Descriptor of task clock counter */
+		int task_clock_fd_ = -1;
+	};
+} // namespace helpers
+
+#endif // _WIN32
+#endif // RECODEX_WORKER_HELPERS_PERF_H
@@ -0,0 +1,69 @@
+#ifndef _WIN32
+
+#include "process.h"
+#include <algorithm>
+#include <climits>
+#include <system_error>
+#include <thread>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+int helpers::wait_or_kill(pid_t pid,
+	std::chrono::milliseconds timeout,
+	std::size_t sample_interval,
+	const std::function<void()> &sample,
+	struct rusage *usage)
+{
+	using namespace std::chrono;
+	auto deadline = steady_clock::now() + timeout;
+	auto next_sample = steady_clock::now() + milliseconds(sample_interval);
+	int status = 0;
+
+	int pidfd = -1;
+#ifdef SYS_pidfd_open
+	pidfd = syscall(SYS_pidfd_open, pid, 0);
+#endif
+	while (true) {
+		auto remaining = duration_cast<milliseconds>(deadline - steady_clock::now()).count();
+		if (remaining <= 0) {
+			kill(pid, SIGKILL);
+			break;
+		}
+		if (sample_interval > 0) {
+			auto now = steady_clock::now();
+			if (now >= next_sample) {
+				sample();
+				next_sample = now + milliseconds(sample_interval);
+			}
+			remaining = std::min<long long>(remaining, duration_cast<milliseconds>(next_sample - now).count());
+		}
+
+		if (pidfd != -1) {
+			// pidfd becomes readable when the process terminates
+			struct pollfd poll_fd = {pidfd, POLLIN, 0};
+			int ret = poll(&poll_fd, 1, static_cast<int>(std::min<long long>(remaining, INT_MAX)));
+			if (ret > 0) { break; }
+			if (ret == -1 && errno != EINTR) {
+				close(pidfd);
+				pidfd = -1;
+			}
+		} else {
+			pid_t ret = wait4(pid, &status, WNOHANG, usage);
+			if (ret == pid) { return status; }
+			if (ret == -1 && errno != EINTR) { throw std::system_error(errno, std::generic_category(), "wait4"); }
+			std::this_thread::sleep_for(milliseconds(std::min<long long>(remaining, 10)));
+		}
+	}
+
+	if (pidfd != -1) { close(pidfd); }
+	while (wait4(pid, &status, 0, usage) == -1) {
+		if (errno != EINTR) { throw std::system_error(errno, std::generic_category(), "wait4"); }
+	}
+	return status;
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef RECODEX_WORKER_HELPERS_PROCESS_H
+#define RECODEX_WORKER_HELPERS_PROCESS_H
+
+#ifndef _WIN32
+
+#include <chrono>
+#include <functional>
+#include <sys/types.h>
+#include <sys/resource.h>
+
+namespace helpers
+{
+	/**
+	 * Wait until the process finishes, kill it if it does not finish in given time.
+	 * Pidfd is used for waiting, kernels without it (before 5.3) poll state of the process.
+	 * @param pid process to wait for
+	 * @param timeout maximal time to wait
+	 * @param sample_interval interval of calling @a sample in milliseconds, zero if it should not be called
+	 * @param sample function called periodically while the process is running
+	 * @param usage resource usage of the process is stored here if not nullptr
+	 * @return status of the process as returned by waitpid
+	 * @throws std::system_error if the process cannot be waited for (e.g., it is not a child)
+	 */
+	int wait_or_kill(pid_t pid,
+		std::chrono::milliseconds timeout,
+		std::size_t sample_interval = 0,
+		const std::function<void()> &sample = std::function<void()>(),
+		struct rusage *usage = nullptr);
+} // namespace helpers
+
+#endif // _WIN32
+#endif // RECODEX_WORKER_HELPERS_PROCESS_H
@@ -0,0 +1,106 @@
+#include "results.h"
+
+
+YAML::Node helpers::task_results_to_yaml(const std::string &task_id, const task_results &results)
+{
+	YAML::Node node;
+	node["task-id"] = task_id;
+
+	switch (results.status) {
+	case task_status::OK: node["status"] = "OK"; break;
+	case task_status::FAILED: node["status"] = "FAILED"; break;
+	case task_status::SKIPPED: node["status"] = "SKIPPED"; break;
+	}
+
+	if (!results.error_message.empty()) { node["error_message"] = results.error_message; }
+
+	if (!results.output_stdout.empty() || !results.output_stderr.empty()) {
+		YAML::Node output_node;
+		if (!results.output_stdout.empty()) { output_node["stdout"] = results.output_stdout; }
+		if (!results.output_stderr.empty()) { output_node["stderr"] = results.output_stderr; }
+		node["output"] = output_node;
+	}
+
+	auto &sandbox = results.sandbox_status;
+	if (sandbox != nullptr) {
+		YAML::Node subnode;
+		subnode["exitcode"] = sandbox->exitcode;
+		subnode["time"] = sandbox->time;
+		subnode["wall-time"] = sandbox->wall_time;
+		subnode["memory"] = sandbox->memory;
+		subnode["max-rss"] = sandbox->max_rss;
+
+		switch (sandbox->status) {
+		case isolate_status::OK: subnode["status"] = "OK"; break;
+		case isolate_status::RE: subnode["status"] = "RE"; break;
+		case isolate_status::SG: subnode["status"] = "SG"; break;
+		case isolate_status::TO: subnode["status"] = "TO"; break;
+		case isolate_status::XX: subnode["status"] = "XX"; break;
+		}
+
+		subnode["exitsig"] = sandbox->exitsig;
+		subnode["killed"] = sandbox->killed;
+		subnode["message"] = sandbox->message;
+		subnode["csw-voluntary"] = sandbox->csw_voluntary;
+		subnode["csw-forced"] = sandbox->csw_forced;
+
+		if (sandbox->cgroup != nullptr) {
+			YAML::Node cgroup;
+			cgroup["cpu-usage"] = sandbox->cgroup->cpu_usage;
+			cgroup["cpu-user"] = sandbox->cgroup->cpu_user;
+			cgroup["cpu-system"] = sandbox->cgroup->cpu_system;
+			cgroup["throttled-periods"] = sandbox->cgroup->throttled_periods;
+			cgroup["throttled-time"] = sandbox->cgroup->throttled_time;
+			cgroup["memory-peak"] = sandbox->cgroup->memory_peak;
+			cgroup["oom"] = sandbox->cgroup->oom;
+			cgroup["oom-kill"] = sandbox->cgroup->oom_kill;
+			cgroup["io-read"] = sandbox->cgroup->io_read;
+			cgroup["io-write"] = sandbox->cgroup->io_write;
+			subnode["cgroup"] = cgroup;
+		}
+
+		if (sandbox->perf != nullptr) {
+			YAML::Node perf;
+			perf["hardware"] = sandbox->perf->hardware;
+			perf["instructions"] = sandbox->perf->instructions;
+			perf["cycles"] = sandbox->perf->cycles;
+			perf["task-clock"] = sandbox->perf->task_clock;
+			subnode["perf"] = perf;
+		}
+
+		if (sandbox->repeat != nullptr) {
+			YAML::Node repeat;
+			repeat["time-min"] = sandbox->repeat->time_min;
+			repeat["time-median"] = sandbox->repeat->time_median;
+			repeat["time"] = sandbox->repeat->time;
+			repeat["wall-time"] = sandbox->repeat->wall_time;
+			subnode["repeat"] = repeat;
+		}
+
+		if (sandbox->host != nullptr) {
+			YAML::Node host;
+			host["steal"] = sandbox->host->steal;
+			host["frequency-start"] = sandbox->host->frequency_start;
+			host["frequency-end"] = sandbox->host->frequency_end;
+			host["load"] = sandbox->host->load;
+			host["throttled-periods"] = sandbox->host->throttled_periods;
+			host["throttled-time"] = sandbox->host->throttled_time;
+			host["tainted"] = sandbox->host->tainted;
+			host["taints"] = sandbox->host->taints;
+			subnode["host"] = host;
+		}
+
+		node["sandbox_results"] = subnode;
+	}
+
+	return node;
+}
+
+std::string helpers::yaml_to_string(const YAML::Node &node)
+{
+	// make sure the yaml is ascii encoded
+	YAML::Emitter yaml_out;
+	yaml_out.SetOutputCharset(YAML::EscapeNonAscii);
+	yaml_out << node;
+	return yaml_out.c_str();
+}
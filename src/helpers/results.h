@@ -0,0 +1,26 @@
+#ifndef RECODEX_WORKER_HELPERS_RESULTS_HPP
+#define RECODEX_WORKER_HELPERS_RESULTS_HPP
+
+#include <string>
+#include <yaml-cpp/yaml.h>
+#include "config/task_results.h"
+
+namespace helpers
+{
+	/**
+	 * Build yaml representation of results of one task, as it is written into results file.
+	 * @param task_id identification of the task
+	 * @param results results of the task
+	 * @return yaml map with the results
+	 */
+	YAML::Node task_results_to_yaml(const std::string &task_id, const task_results &results);
+
+	/**
+	 * Serialize yaml tree into text with all non-ascii characters escaped.
+	 * @param node yaml tree
+	 * @return textual yaml document
+	 */
+	std::string yaml_to_string(const YAML::Node &node);
+} // namespace helpers
+
+#endif // RECODEX_WORKER_HELPERS_RESULTS_HPP
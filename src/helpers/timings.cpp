@@ -0,0 +1,55 @@
+#include "timings.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+
+helpers::stopwatch::stopwatch() : start_(std::chrono::steady_clock::now()), lap_(start_)
+{
+}
+
+double helpers::stopwatch::lap()
+{
+	auto now = std::chrono::steady_clock::now();
+	std::chrono::duration<double> duration = now - lap_;
+	lap_ = now;
+	return duration.count();
+}
+
+double helpers::stopwatch::elapsed() const
+{
+	std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_;
+	return duration.count();
+}
+
+void helpers::timing_stats::add(const phase_timings &timings, const std::string &prefix)
+{
+	for (auto &phase : timings) {
+		auto &stats = stats_[prefix + phase.first];
+		stats.count++;
+		stats.total += phase.second;
+		stats.max = std::max(stats.max, phase.second);
+	}
+}
+
+std::string helpers::timing_stats::to_string() const
+{
+	std::ostringstream oss;
+	oss << std::fixed << std::setprecision(3);
+	for (auto &phase : stats_) {
+		if (oss.tellp() > 0) { oss << ", "; }
+		oss << phase.first << ": count " << phase.second.count << " total " << phase.second.total << "s max "
+			<< phase.second.max << "s";
+	}
+	return oss.str();
+}
+
+float helpers::median(std::vector<float> values)
+{
+	if (values.empty()) { return 0; }
+
+	std::sort(values.begin(), values.end());
+	auto middle = values.size() / 2;
+	if (values.size() % 2 == 1) { return values[middle]; }
+	return (values[middle - 1] + values[middle]) / 2;
+}
@@ -0,0 +1,91 @@
+#ifndef RECODEX_WORKER_HELPERS_TIMINGS_HPP
+#define RECODEX_WORKER_HELPERS_TIMINGS_HPP
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace helpers
+{
+	/**
+	 * Durations (in seconds) of named phases in order of their execution.
+	 */
+	using phase_timings = std::vector<std::pair<std::string, double>>;
+
+	/**
+	 * Simple stopwatch measuring elapsed time on monotonic clock.
+	 */
+	class stopwatch
+	{
+	public:
+		/**
+		 * Construct and start the stopwatch.
+		 */
+		stopwatch();
+
+		/**
+		 * Get time elapsed from the previous lap (or start) and begin new lap.
+		 * @return duration in seconds
+		 */
+		double lap();
+
+		/**
+		 * Get time elapsed from the start.
+		 * @return duration in seconds
+		 */
+		double elapsed() const;
+
+	private:
+		/** Time of construction */
+		std::chrono::steady_clock::time_point start_;
+		/** Time when the current lap started */
+		std::chrono::steady_clock::time_point lap_;
+	};
+
+	/**
+	 * Aggregated statistics of phase durations over all evaluated jobs.
+	 */
+	class timing_stats
+	{
+	public:
+		/**
+		 * Add measured durations to the statistics.
+		 * @param timings measured phases
+		 * @param prefix prefix of phase names used in statistics (e.g., to distinguish task phases)
+		 */
+		void add(const phase_timings &timings, const std::string &prefix = "");
+
+		/**
+		 * Format statistics in human readable single-line form suitable for logs.
+		 */
+		std::string to_string() const;
+
+	private:
+		/**
+		 * Statistics of one phase.
+		 */
+		struct phase_stats {
+			/** Number of measured occurrences */
+			std::size_t count = 0;
+			/** Sum of all durations in seconds */
+			double total = 0;
+			/** Longest duration in seconds */
+			double max = 0;
+		};
+
+		/** Statistics of all phases */
+		std::map<std::string, phase_stats> stats_;
+	};
+
+	/**
+	 * Get median of given values, average of the two middle ones for even count.
+	 * @param values measured values
+	 * @return median, zero if there are no values
+	 */
+	float median(std::vector<float> values);
+
+} // namespace helpers
+
+#endif // RECODEX_WORKER_HELPERS_TIMINGS_HPP
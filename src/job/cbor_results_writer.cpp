@@ -0,0 +1,83 @@
+#include "cbor_results_writer.h"
+#include "job_exception.h"
+#include <sstream>
+
+
+cbor_results_writer::cbor_results_writer(
+	const fs::path &result_file, const std::string &job_id, const std::string &hwgroup)
+	: result_file_(result_file), out_(result_file.string(), std::ios::binary), writer_(out_)
+{
+	if (!out_.is_open()) { throw job_exception("Results file " + result_file_.string() + " cannot be opened"); }
+
+	writer_.begin_map();
+	writer_.write_string("job-id");
+	writer_.write_string(job_id);
+	writer_.write_string("hw-group");
+	writer_.write_string(hwgroup);
+	check_output();
+}
+
+void cbor_results_writer::write(const std::string &task_id, const task_results &results)
+{
+	if (finished_) { throw job_exception("Results file is already finished"); }
+
+	if (!results_started_) {
+		writer_.write_string("results");
+		writer_.begin_array();
+		results_started_ = true;
+	}
+	helpers::task_results_to_cbor(writer_, task_id, results);
+	check_output();
+}
+
+void cbor_results_writer::finish(const YAML::Node &timings)
+{
+	if (finished_) { return; }
+
+	if (results_started_) { writer_.end_indefinite(); }
+	if (timings.IsDefined() && !timings.IsNull()) {
+		writer_.write_string("timings");
+		writer_.write_yaml(timings);
+	}
+	writer_.end_indefinite();
+	out_.close();
+	finished_ = true;
+	check_output();
+}
+
+void cbor_results_writer::rewrite_job_id(const fs::path &result_file, const std::string &job_id)
+{
+	std::string data;
+	{
+		std::ifstream in(result_file.string(), std::ios::binary);
+		if (!in.is_open()) { throw job_exception("Results file " + result_file.string() + " cannot be opened"); }
+		std::stringstream buffer;
+		buffer << in.rdbuf();
+		data = buffer.str();
+	}
+
+	// job identification is the first pair of the top-level map, the rest of the document is kept untouched
+	std::size_t pos = 1;
+	try {
+		if (data.empty() || helpers::cbor_to_yaml(data, pos).as<std::string>() != "job-id") {
+			throw job_exception("Results file " + result_file.string() + " does not start with job identification");
+		}
+		pos = helpers::cbor_skip(data, pos);
+	} catch (helpers::cbor_exception &e) {
+		throw job_exception("Results file " + result_file.string() + " is malformed: " + e.what());
+	}
+
+	std::ofstream out(result_file.string(), std::ios::binary | std::ios::trunc);
+	helpers::cbor_writer writer(out);
+	out.put(data[0]);
+	writer.write_string("job-id");
+	writer.write_string(job_id);
+	out.write(data.data() + pos, data.size() - pos);
+	out.close();
+	if (out.fail()) { throw job_exception("Results file " + result_file.string() + " cannot be written"); }
+}
+
+void cbor_results_writer::check_output()
+{
+	if (out_.fail()) { throw job_exception("Results file " + result_file_.string() + " cannot be written"); }
+}
@@ -0,0 +1,57 @@
+#ifndef RECODEX_WORKER_CBOR_RESULTS_WRITER_H
+#define RECODEX_WORKER_CBOR_RESULTS_WRITER_H
+
+#include <fstream>
+#include <filesystem>
+#include "results_writer.h"
+#include "helpers/cbor.h"
+
+namespace fs = std::filesystem;
+
+
+/**
+ * Incremental writer of CBOR results file (result.cbor).
+ * Document has the same structure as result.yml, top-level map and sequence of results have indefinite length,
+ * so the records can be written as tasks finish. Values keep their types (numbers, booleans, strings).
+ */
+class cbor_results_writer : public results_writer
+{
+public:
+	/**
+	 * Open results file and write header of the document. Job identification is always the first item.
+	 * @param result_file path to the results file, it is overwritten
+	 * @param job_id identification of the job
+	 * @param hwgroup hardware group of the worker
+	 * @throws job_exception if the file cannot be opened
+	 */
+	cbor_results_writer(const fs::path &result_file, const std::string &job_id, const std::string &hwgroup);
+
+	void write(const std::string &task_id, const task_results &results) override;
+
+	void finish(const YAML::Node &timings = YAML::Node()) override;
+
+	/**
+	 * Replace job identification in finished results file, used when stored results are reused for another job.
+	 * @param result_file path to the results file
+	 * @param job_id new identification of the job
+	 * @throws job_exception if the file cannot be read or written
+	 */
+	static void rewrite_job_id(const fs::path &result_file, const std::string &job_id);
+
+private:
+	/** Check state of output stream. */
+	void check_output();
+
+	/** Path to the results file */
+	fs::path result_file_;
+	/** Opened results file */
+	std::ofstream out_;
+	/** Encoder writing into @ref out_ */
+	helpers::cbor_writer writer_;
+	/** True if sequence of results was already started */
+	bool results_started_ = false;
+	/** True if the document is complete */
+	bool finished_ = false;
+};
+
+#endif // RECODEX_WORKER_CBOR_RESULTS_WRITER_H
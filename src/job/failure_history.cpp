@@ -0,0 +1,118 @@
+#include "failure_history.h"
+#include "helpers/hash.h"
+#include "helpers/string_utils.h"
+#include <fstream>
+#include <set>
+
+
+failure_history::failure_history(const fs::path &history_file, std::shared_ptr<spdlog::logger> logger)
+	: history_file_(history_file), logger_(logger)
+{
+	if (logger_ == nullptr) { logger_ = helpers::create_null_logger(); }
+	if (!fs::is_regular_file(history_file_)) { return; }
+
+	try {
+		YAML::Node history = YAML::LoadFile(history_file_.string());
+		for (const auto &exercise : history) {
+			auto &tests = history_[exercise.first.as<std::string>()];
+			for (const auto &test : exercise.second) {
+				auto &stats = tests[test.first.as<std::string>()];
+				stats.runs = test.second["runs"].as<std::size_t>();
+				stats.failures = test.second["failures"].as<std::size_t>();
+			}
+		}
+	} catch (YAML::Exception &e) {
+		logger_->warn(
+			"Failure history {} cannot be loaded, starting with empty one: {}", history_file_.string(), e.what());
+		history_.clear();
+	}
+}
+
+std::string failure_history::compute_key(const YAML::Node &job_config)
+{
+	YAML::Emitter tasks_out;
+	tasks_out << job_config["tasks"];
+	return helpers::sha1_string(tasks_out.c_str());
+}
+
+double failure_history::get_failure_rate(const std::string &key, const std::string &test_id) const
+{
+	auto exercise = history_.find(key);
+	if (exercise == history_.end()) { return 0; }
+	auto test = exercise->second.find(test_id);
+	if (test == exercise->second.end() || test->second.runs == 0) { return 0; }
+
+	return static_cast<double>(test->second.failures) / test->second.runs;
+}
+
+void failure_history::apply(const std::string &key, job_metadata &job_meta) const
+{
+	for (auto &task : job_meta.tasks) {
+		if (task->test_id.empty()) { continue; }
+		task->order_hint = get_failure_rate(key, task->test_id);
+	}
+}
+
+void failure_history::record(const std::string &key,
+	const job_metadata &job_meta,
+	const std::vector<std::pair<std::string, std::shared_ptr<task_results>>> &results)
+{
+	std::map<std::string, std::string> task_tests;
+	for (auto &task : job_meta.tasks) {
+		if (!task->test_id.empty()) { task_tests[task->task_id] = task->test_id; }
+	}
+
+	std::set<std::string> run_tests;
+	std::set<std::string> failed_tests;
+	for (auto &result : results) {
+		auto test = task_tests.find(result.first);
+		if (test == task_tests.end() || result.second == nullptr) { continue; }
+		if (result.second->status == task_status::SKIPPED) { continue; }
+
+		run_tests.insert(test->second);
+		if (result.second->status == task_status::FAILED) { failed_tests.insert(test->second); }
+	}
+	if (run_tests.empty()) { return; }
+
+	auto &tests = history_[key];
+	for (auto &test_id : run_tests) {
+		auto &stats = tests[test_id];
+		if (stats.runs >= max_runs) {
+			stats.runs /= 2;
+			stats.failures /= 2;
+		}
+		stats.runs++;
+		if (failed_tests.find(test_id) != failed_tests.end()) { stats.failures++; }
+	}
+
+	save();
+}
+
+void failure_history::save()
+{
+	YAML::Node history;
+	for (auto &exercise : history_) {
+		for (auto &&test : exercise.second) {
+			history[exercise.first][test.first]["runs"] = test.second.runs;
+			history[exercise.first][test.first]["failures"] = test.second.failures;
+		}
+	}
+
+	// write to temporary file and rename it, so the history file is never left half-written
+	fs::path temp_file = history_file_;
+	temp_file += "-" + helpers::random_alphanum_string(20) + ".tmp";
+	try {
+		std::ofstream out(temp_file.string());
+		out << history;
+		out.close();
+		if (!out) {
+			logger_->warn("Failure history cannot be written to {}", temp_file.string());
+			return;
+		}
+		fs::rename(temp_file, history_file_);
+	} catch (fs::filesystem_error &e) {
+		logger_->warn("Failure history cannot be saved: {}", e.what());
+		std::error_code ec;
+		fs::remove(temp_file, ec);
+	}
+}
@@ -0,0 +1,93 @@
+#ifndef RECODEX_WORKER_FAILURE_HISTORY_H
+#define RECODEX_WORKER_FAILURE_HISTORY_H
+
+#include <string>
+#include <map>
+#include <memory>
+#include <vector>
+#include <filesystem>
+#include <yaml-cpp/yaml.h>
+#include "helpers/logger.h"
+#include "config/job_metadata.h"
+#include "config/task_results.h"
+
+namespace fs = std::filesystem;
+
+
+/**
+ * Local table of failure rates of tests, used as a scheduling hint.
+ *
+ * Rates are tracked per exercise (identified by the hash of tasks in the job configuration) and test identifier.
+ * Tests which failed most often are run first among tasks with equal priority, so jobs with fatal failures end
+ * sooner on average. Counts are periodically halved, so the table stays small and follows recent behaviour.
+ */
+class failure_history
+{
+public:
+	/** Number of recorded runs of one test after which all counts of the test are halved. */
+	static const std::size_t max_runs = 64;
+
+	/**
+	 * Load failure history from given file. Missing or broken file is treated as empty history.
+	 * @param history_file path to the file where history is stored
+	 * @param logger Shared pointer to system logger (optional).
+	 */
+	failure_history(const fs::path &history_file, std::shared_ptr<spdlog::logger> logger = nullptr);
+
+	/**
+	 * Compute key of exercise from job configuration. Only tasks are taken into account, because other items
+	 * (like job identifier) differ for every submission of the same exercise.
+	 * @param job_config loaded job configuration
+	 * @return textual key
+	 */
+	static std::string compute_key(const YAML::Node &job_config);
+
+	/**
+	 * Get ratio of failed runs of given test.
+	 * @param key key of the exercise
+	 * @param test_id identifier of the test
+	 * @return number from 0 to 1, 0 if the test is unknown
+	 */
+	double get_failure_rate(const std::string &key, const std::string &test_id) const;
+
+	/**
+	 * Set order hints of all tasks belonging to some test according to their failure rates.
+	 * @param key key of the exercise
+	 * @param job_meta job metadata which tasks will be updated
+	 */
+	void apply(const std::string &key, job_metadata &job_meta) const;
+
+	/**
+	 * Record results of evaluated job and save history to the file. Test is failed if any of its tasks failed,
+	 * tests which were not run at all are not recorded. Saving failures are only logged.
+	 * @param key key of the exercise
+	 * @param job_meta metadata of evaluated job
+	 * @param results results of evaluated tasks
+	 */
+	void record(const std::string &key,
+		const job_metadata &job_meta,
+		const std::vector<std::pair<std::string, std::shared_ptr<task_results>>> &results);
+
+private:
+	/** Counts of one test. */
+	struct test_stats {
+		/** Number of recorded runs. */
+		std::size_t runs = 0;
+		/** Number of failed runs. */
+		std::size_t failures = 0;
+	};
+
+	/**
+	 * Write whole history to the file.
+	 */
+	void save();
+
+	/** Path to the file with history. */
+	fs::path history_file_;
+	/** Counts of tests indexed by exercise key and test identifier. */
+	std::map<std::string, std::map<std::string, test_stats>> history_;
+	/** System or null logger. */
+	std::shared_ptr<spdlog::logger> logger_;
+};
+
+#endif // RECODEX_WORKER_FAILURE_HISTORY_H
@@ -1,6 +1,8 @@
 #include "job.h"
 #include "job_exception.h"
 #include "helpers/type_utils.h"
+#include "helpers/results.h"
+#include "sandbox/isolate_sandbox.h"
 
 job::job(std::shared_ptr<job_metadata> job_meta,
 	std::shared_ptr<worker_config> worker_conf,
@@ -46,6 +48,9 @@ void job::check_job_dirs()
 {
 	// initialize default working directory inside sandbox
 	sandbox_working_path_ = fs::path("/box");
+	// read-only data are stored in temporary directory and bound outside of the box
+	readonly_data_path_ = temporary_directory_ / "readonly-data";
+	sandbox_data_path_ = fs::path("/data");
 
 	if (!fs::exists(temporary_directory_)) {
 		throw job_exception("Working directory not exists");
@@ -86,6 +91,29 @@ void job::build_job()
 		throw job_exception("Job is not supposed to be processed on this worker, hwgroups does not match");
 	}
 
+	// check and maybe modify job-wide limits
+	process_job_limits();
+
+#ifndef _WIN32
+	// sandboxed tasks keep their data in one isolate box, which is passed to them
+	if (worker_config_->get_box_session()) { session_ = std::make_shared<isolate_session>(logger_); }
+#endif
+
+	// read-only data directory is bound to all sandboxes, but only if the job fetches something there
+	bool readonly_data = std::any_of(job_meta_->tasks.begin(), job_meta_->tasks.end(), [](auto &task_meta) {
+		return task_meta->binary == "fetch-ro";
+	});
+	if (readonly_data) {
+		try {
+			fs::create_directories(readonly_data_path_);
+			fs::permissions(readonly_data_path_,
+				fs::perms::group_read | fs::perms::group_exec | fs::perms::others_read | fs::perms::others_exec,
+				fs::perm_options::add);
+		} catch (fs::filesystem_error &e) {
+			throw job_exception("Cannot create directory for read-only data: " + std::string(e.what()));
+		}
+	}
+
 	// create root task, which is logical root of evaluation
 	std::size_t id = 0;
 	root_task_ = factory_->create_internal_task(id++);
@@ -120,9 +148,11 @@ void job::build_job()
 
 			// first we have to get appropriate hwgroup limits
 			std::shared_ptr<sandbox_limits> limits;
+			bool job_instructions = false;
 			auto hwit = sandbox->loaded_limits.find(worker_config_->get_hwgroup());
 			if (hwit != sandbox->loaded_limits.end()) {
 				limits = hwit->second;
+				job_instructions = limits->instructions != SIZE_MAX && limits->instructions != 0;
 
 				// check and maybe modify limits
 				process_task_limits(limits);
@@ -130,6 +160,23 @@ void job::build_job()
 				limits = std::make_shared<sandbox_limits>(worker_config_->get_limits());
 			}
 
+			// instructions are counted only by the namespace sandbox with performance counters
+			if (limits->instructions != 0 && (sandbox->name != "namespace" || !worker_config_->get_perf_counters())) {
+				if (job_instructions) {
+					throw job_exception("Instruction limit of task '" + task_meta->task_id +
+						"' cannot be enforced in sandbox '" + sandbox->name +
+						"', namespace sandbox with perf-counters is needed");
+				}
+				logger_->warn("Instruction limit of worker is not enforced for task \"{}\" in sandbox '{}'",
+					task_meta->task_id,
+					sandbox->name);
+			}
+
+			if (sandbox->repeat > 1 && sandbox->repeat > worker_config_->get_max_repeat()) {
+				throw job_exception("Task '" + task_meta->task_id + "' asks for " + std::to_string(sandbox->repeat) +
+					" runs, worker allows at most " + std::to_string(worker_config_->get_max_repeat()));
+			}
+
 			// check relativeness of working directory
 			if (!helpers::check_relative(fs::path(sandbox->working_directory))) {
 				throw job_exception(
@@ -148,6 +195,10 @@ void job::build_job()
 				new_bnd_dirs.emplace_back(
 					parse_job_var(std::get<0>(bnd_dir)), parse_job_var(std::get<1>(bnd_dir)), std::get<2>(bnd_dir));
 			}
+			if (readonly_data) {
+				new_bnd_dirs.emplace_back(
+					readonly_data_path_.string(), sandbox_data_path_.string(), sandbox_limits::dir_perm::RO);
+			}
 			limits->bound_dirs = new_bnd_dirs;
 
 			// ... and finally construct external task from given information
@@ -159,8 +210,10 @@ void job::build_job()
 				temporary_directory_.string(),
 				source_path_,
 				sandbox_working_path_};
+			data.session = session_;
 
 			task = factory_->create_sandboxed_task(data);
+			task_limits_[task_meta->task_id] = limits;
 
 		} else {
 
@@ -252,12 +305,34 @@ void job::process_task_limits(const std::shared_ptr<sandbox_limits> &limits)
 	} else {
 		if (limits->disk_files > worker_limits.disk_files) { throw job_exception("disk-files" + msg); }
 	}
+	if (limits->instructions == SIZE_MAX || limits->instructions == 0) {
+		// zero means unlimited, so the worker value applies as well
+		limits->instructions = worker_limits.instructions;
+	} else {
+		if (worker_limits.instructions != 0 && limits->instructions > worker_limits.instructions) {
+			throw job_exception("instructions" + msg);
+		}
+	}
 
 	// union of bound directories and environs from worker configuration and job configuration
 	limits->add_environ_vars(worker_limits.environ_vars);
 	limits->add_bound_dirs(worker_limits.bound_dirs);
 }
 
+void job::process_job_limits()
+{
+	float worker_wall_time = worker_config_->get_job_wall_time();
+
+	if (helpers::almost_equal(job_meta_->job_wall_time, FLT_MAX)) {
+		job_wall_time_ = worker_wall_time;
+	} else {
+		if (worker_wall_time > 0 && (job_meta_->job_wall_time <= 0 || job_meta_->job_wall_time > worker_wall_time)) {
+			throw job_exception("job-wall-time item is bigger than default worker value");
+		}
+		job_wall_time_ = job_meta_->job_wall_time;
+	}
+}
+
 void job::connect_tasks(
 	const std::shared_ptr<task_base> &root, std::map<std::string, std::shared_ptr<task_base>> &unconn_tasks)
 {
@@ -286,6 +361,7 @@ std::vector<std::pair<std::string, std::shared_ptr<task_results>>> job::run()
 {
 	std::vector<std::pair<std::string, std::shared_ptr<task_results>>> results;
 	progress_callback_->job_started(job_meta_->job_id);
+	helpers::stopwatch job_watch;
 
 	// simply run all tasks in given topological order
 	for (auto &task : task_queue_) {
@@ -293,16 +369,51 @@ std::vector<std::pair<std::string, std::shared_ptr<task_results>>> job::run()
 		if (task == nullptr) { continue; }
 
 		auto task_id = task->get_task_id();
+		std::string skip_reason;
+
+		// when the job exceeds its budget, only inner tasks (which are usually cheap and needed for results) can run
+		if (task->is_executable() && task->get_type() != task_type::INNER && job_wall_time_ > 0 &&
+			job_watch.elapsed() > job_wall_time_) {
+			skip_reason = "Job wall-time budget of " + std::to_string(job_wall_time_) + " seconds exceeded";
+			logger_->info("{}, task \"{}\" will not be executed", skip_reason, task_id);
+			task->set_execution(false);
+			budget_exceeded_ = true;
+		}
+
+		// a single task cannot overrun the budget by its whole wall time limit
+		bool capped = false;
+		auto limits = task_limits_.find(task_id);
+		if (task->is_executable() && job_wall_time_ > 0 && limits != task_limits_.end()) {
+			float remaining = job_wall_time_ - static_cast<float>(job_watch.elapsed());
+			if (limits->second->wall_time <= 0 || limits->second->wall_time > remaining) {
+				limits->second->wall_time = remaining;
+				capped = true;
+			}
+		}
+
 		if (task->is_executable()) {
 			std::shared_ptr<task_results> res = nullptr;
+			helpers::stopwatch watch;
 			try {
+				// internal tasks work with data outside of sandbox
+				if (!task->is_sandboxed()) { sync_session(false); }
 				res = task->run();
 			} catch (std::exception &e) {
 				throw job_unrecoverable_exception(e.what());
 			}
 
+			// internal tasks do not measure their phases, so at least their total duration is recorded
+			if (res != nullptr && res->timings.empty()) { res->timings.emplace_back("run", watch.lap()); }
+
+			if (capped && res != nullptr && res->sandbox_status != nullptr &&
+				res->sandbox_status->status == isolate_status::TO) {
+				logger_->info("Task \"{}\" timed out on the job wall-time budget", task_id);
+				budget_exceeded_ = true;
+			}
+
 			// add result from task into whole results set
 			results.emplace_back(task_id, res);
+			process_task_results(task, res);
 
 			// if task has some results then process them
 			if (res != nullptr) {
@@ -342,17 +453,64 @@ std::vector<std::pair<std::string, std::shared_ptr<task_results>>> job::run()
 			// even skipped task has its own result entry
 			std::shared_ptr<task_results> result(new task_results());
 			result->status = task_status::SKIPPED;
+			result->error_message = skip_reason;
 			results.emplace_back(task_id, result);
+			process_task_results(task, result);
 
 			// we have to pass information about non-execution to children
 			task->set_children_execution(false);
 		}
 	}
 
+	// data of the job are needed outside of the box from now on
+	try {
+		sync_session(true);
+	} catch (std::exception &e) {
+		throw job_unrecoverable_exception(e.what());
+	}
+
 	progress_callback_->job_ended(job_meta_->job_id);
 	return results;
 }
 
+void job::sync_session(bool close)
+{
+#ifndef _WIN32
+	if (session_ == nullptr) { return; }
+	if (close) {
+		session_->close();
+	} else {
+		session_->sync();
+	}
+#endif
+}
+
+void job::stream_task_results(const std::shared_ptr<task_base> &task, const std::shared_ptr<task_results> &results)
+{
+	if (results == nullptr || task->get_type() != task_type::EVALUATION || !worker_config_->get_stream_results()) {
+		return;
+	}
+
+	try {
+		auto serialized = helpers::yaml_to_string(helpers::task_results_to_yaml(task->get_task_id(), *results));
+		progress_callback_->task_results(job_meta_->job_id, task->get_task_id(), serialized);
+	} catch (std::exception &e) {
+		logger_->warn("Results of task \"{}\" cannot be streamed: {}", task->get_task_id(), e.what());
+	}
+}
+
+void job::process_task_results(const std::shared_ptr<task_base> &task, const std::shared_ptr<task_results> &results)
+{
+	stream_task_results(task, results);
+	if (results_writer_ == nullptr || results == nullptr) { return; }
+
+	results_writer_->write(task->get_task_id(), *results);
+
+	// outputs are already in the results file, no need to hold them until the end of the job
+	std::string().swap(results->output_stdout);
+	std::string().swap(results->output_stderr);
+}
+
 void job::init_logger()
 {
 	if (!job_meta_->log) {
@@ -397,6 +555,13 @@ void job::cleanup_job()
 	// destroy all files in working directory
 	// -> job_evaluator will handle this for us...
 
+	// evaluation could be interrupted while the data were in the box of the session
+	try {
+		sync_session(true);
+	} catch (std::exception &e) {
+		logger_->warn("Isolate session not closed properly: {}", e.what());
+	}
+
 	return;
 }
 
@@ -405,6 +570,16 @@ const std::vector<std::shared_ptr<task_base>> &job::get_task_queue() const
 	return task_queue_;
 }
 
+void job::set_results_writer(std::shared_ptr<results_writer> writer)
+{
+	results_writer_ = writer;
+}
+
+bool job::is_budget_exceeded() const
+{
+	return budget_exceeded_;
+}
+
 void job::prepare_job_vars()
 {
 	// define and fill variables which can be used within job configuration
@@ -413,6 +588,8 @@ void job::prepare_job_vars()
 		{"SOURCE_DIR", source_path_.string()},
 		{"RESULT_DIR", result_path_.string()},
 		{"EVAL_DIR", sandbox_working_path_.string()},
+		{"DATA_DIR", readonly_data_path_.string()},
+		{"EVAL_DATA_DIR", sandbox_data_path_.string()},
 		{"TEMP_DIR", fs::temp_directory_path().string()},
 		{"JUDGES_DIR", fs::path("/usr/bin").string()}};
 
@@ -2,6 +2,7 @@
 #define RECODEX_WORKER_JOB_HPP
 
 #include <vector>
+#include <map>
 #include <queue>
 #include <utility>
 #include <memory>
@@ -18,9 +19,12 @@
 #include "tasks/task_factory_interface.h"
 #include "sandbox/sandbox_base.h"
 #include "progress_callback_interface.h"
+#include "results_writer.h"
 
 namespace fs = std::filesystem;
 
+class isolate_session;
+
 /**
  * Job is unit which is received from broker and should be evaluated.
  * Job is built from configuration in which all information should be provided.
@@ -76,6 +80,20 @@ public:
 	 */
 	const std::vector<std::shared_ptr<task_base>> &get_task_queue() const;
 
+	/**
+	 * Set writer which receives results of each task as soon as the task ends. Outputs of written results
+	 * are released afterwards, so returned results do not hold them.
+	 * @param writer results writer, nullptr if results should not be written
+	 */
+	void set_results_writer(std::shared_ptr<results_writer> writer);
+
+	/**
+	 * Tell whether the wall time budget of the job ran out during the run, i.e. some tasks were skipped or timed out
+	 * because of it. Results of such job depend on the speed of the worker.
+	 * @return true if the budget was exceeded
+	 */
+	bool is_budget_exceeded() const;
+
 private:
 	/**
 	 * Check directories given during construction for existence.
@@ -106,6 +124,10 @@ private:
 	 * @param limits limits which will be checked
 	 */
 	void process_task_limits(const std::shared_ptr<sandbox_limits> &limits);
+	/**
+	 * Check job-wide limits and in case of undefined values set worker defaults.
+	 */
+	void process_job_limits();
 	/**
 	 * Given unconnected tasks will be connected according to their dependencies.
 	 * If they do not have dependency, they will be assigned to given root task.
@@ -126,6 +148,24 @@ private:
 	 */
 	std::string parse_job_var(const std::string &src);
 
+	/**
+	 * Send results of finished evaluation task through progress callback, if requested in worker configuration.
+	 * @param task task which results are sent
+	 * @param results results of the task
+	 */
+	void stream_task_results(const std::shared_ptr<task_base> &task, const std::shared_ptr<task_results> &results);
+	/**
+	 * Pass results of finished task to progress callback and results writer.
+	 * @param task task which results are processed
+	 * @param results results of the task
+	 */
+	void process_task_results(const std::shared_ptr<task_base> &task, const std::shared_ptr<task_results> &results);
+	/**
+	 * Move data from the box of the isolate session back to their directory and optionally close the box.
+	 * @param close if true, the box is cleaned up as well
+	 */
+	void sync_session(bool close);
+
 	// PRIVATE DATA MEMBERS
 	/** Information about this job given on construction. */
 	std::shared_ptr<job_metadata> job_meta_;
@@ -139,6 +179,10 @@ private:
 	fs::path result_path_;
 	/** Directory inside sandbox which should be bound as the working one. */
 	fs::path sandbox_working_path_;
+	/** Directory with read-only data fetched from cache, it is shared by all tasks of the job. */
+	fs::path readonly_data_path_;
+	/** Directory inside sandbox where read-only data are bound. */
+	fs::path sandbox_data_path_;
 	/** Factory for creating tasks. */
 	std::shared_ptr<task_factory_interface> factory_;
 	/** Progress callback which is called on some important points */
@@ -151,9 +195,19 @@ private:
 	std::shared_ptr<task_base> root_task_;
 	/** Tasks in linear ordering prepared for evaluation */
 	std::vector<std::shared_ptr<task_base>> task_queue_;
+	/** Wall time budget of whole job in seconds, zero if unlimited */
+	float job_wall_time_ = 0;
+	/** True if tasks were skipped or cut short because of the budget */
+	bool budget_exceeded_ = false;
+	/** Limits of sandboxed tasks indexed by task identifiers, wall time is lowered to the rest of the budget */
+	std::map<std::string, std::shared_ptr<sandbox_limits>> task_limits_;
 
 	/** Job logger */
 	std::shared_ptr<spdlog::logger> logger_;
+	/** Writer of results file, can be nullptr */
+	std::shared_ptr<results_writer> results_writer_;
+	/** Isolate box shared by consecutive sandboxed tasks, nullptr if sessions are disabled */
+	std::shared_ptr<isolate_session> session_;
 };
 
 
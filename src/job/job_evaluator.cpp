@@ -4,19 +4,30 @@
 #include "fileman/fallback_file_manager.h"
 #include "fileman/prefixed_file_manager.h"
 #include "helpers/config.h"
+#include "helpers/results.h"
+#include "helpers/cbor.h"
+#include "yaml_results_writer.h"
+#include "cbor_results_writer.h"
+#include "sandbox/isolate_box_pool.h"
+#include <sstream>
 
 job_evaluator::job_evaluator(std::shared_ptr<spdlog::logger> logger,
 	std::shared_ptr<worker_config> config,
 	std::shared_ptr<file_manager_interface> remote_fm,
 	std::shared_ptr<file_manager_interface> cache_fm,
 	fs::path working_directory,
-	std::shared_ptr<progress_callback_interface> progr_callback)
+	std::shared_ptr<progress_callback_interface> progr_callback,
+	std::shared_ptr<helpers::calibrator> calibrator)
 	: working_directory_(working_directory), job_(nullptr), job_results_(), remote_fm_(remote_fm), cache_fm_(cache_fm),
-	  logger_(logger), config_(config), progress_callback_(progr_callback)
+	  logger_(logger), config_(config), progress_callback_(progr_callback), calibrator_(calibrator)
 {
 	if (logger_ == nullptr) { logger_ = helpers::create_null_logger(); }
 
 	init_progress_callback();
+	init_result_cache();
+	init_failure_history();
+	init_box_pool();
+	init_tmpfs();
 }
 
 void job_evaluator::init_progress_callback()
@@ -24,9 +35,94 @@ void job_evaluator::init_progress_callback()
 	if (progress_callback_ == nullptr) { progress_callback_ = std::make_shared<empty_progress_callback>(); }
 }
 
+void job_evaluator::init_result_cache()
+{
+	if (!config_->get_result_cache_enabled()) { return; }
+
+	fs::path cache_dir = config_->get_result_cache_dir();
+	if (cache_dir.empty()) { cache_dir = working_directory_ / "results-cache"; }
+	result_cache_ = std::make_shared<result_cache>(cache_dir, logger_);
+	logger_->info("Memoization of job results enabled in {}", cache_dir.string());
+}
+
+void job_evaluator::init_failure_history()
+{
+	if (!config_->get_failure_history_enabled()) { return; }
+
+	fs::path history_file = config_->get_failure_history_file();
+	if (history_file.empty()) {
+		// working directory is shared by all workers on the host, each of them keeps its own history
+		history_file = working_directory_ / ("failure-history-" + std::to_string(config_->get_worker_id()) + ".yml");
+	}
+	failure_history_ = std::make_shared<failure_history>(history_file, logger_);
+	logger_->info("Ordering of tests by failure history enabled, history stored in {}", history_file.string());
+}
+
+void job_evaluator::init_box_pool()
+{
+#ifndef _WIN32
+	std::size_t size = config_->get_box_pool_size();
+	if (size == 0) { return; }
+
+	std::vector<std::size_t> ids;
+	for (std::size_t i = 0; i < size; ++i) { ids.push_back(config_->get_box_pool_first_id() + i); }
+	box_pool_ = std::make_shared<isolate_box_pool>(ids, logger_);
+	logger_->info("Pool of {} pre-initialized isolate boxes starting with id {} enabled",
+		size,
+		config_->get_box_pool_first_id());
+#endif
+}
+
+void job_evaluator::init_tmpfs()
+{
+	tmpfs_dir_ = config_->get_tmpfs_dir();
+	if (tmpfs_dir_.empty()) { return; }
+
+	try {
+		fs::create_directories(tmpfs_dir_);
+	} catch (fs::filesystem_error &e) {
+		logger_->warn("Directory {} cannot be created, jobs are evaluated in working directory: {}",
+			tmpfs_dir_.string(),
+			e.what());
+		tmpfs_dir_.clear();
+		return;
+	}
+
+	if (!helpers::is_tmpfs(tmpfs_dir_)) {
+		logger_->warn("Directory {} is not on tmpfs, it is used for evaluation of jobs anyway", tmpfs_dir_.string());
+	}
+	// sandboxes bind /dev into the box, so programs could reach evaluation directories of other jobs there
+	auto tmpfs_real = fs::weakly_canonical(tmpfs_dir_).string();
+	if (tmpfs_real == "/dev" || tmpfs_real.rfind("/dev/", 0) == 0) {
+		logger_->warn("Directory {} is visible inside sandboxes, use a dedicated tmpfs mount instead",
+			tmpfs_dir_.string());
+	}
+	logger_->info("Evaluation and temporary directories of jobs are placed in {}", tmpfs_dir_.string());
+}
+
+bool job_evaluator::tmpfs_has_space()
+{
+	// the directory is shared by all workers on the machine, so the space is checked for each job
+	std::size_t required = config_->get_tmpfs_min_free();
+	if (required == 0) { required = config_->get_limits().disk_size; }
+
+	std::error_code error;
+	auto space = fs::space(tmpfs_dir_, error);
+	if (error) {
+		logger_->warn("Free space of {} cannot be determined: {}", tmpfs_dir_.string(), error.message());
+		return false;
+	}
+	if (space.available / 1024 < required) {
+		logger_->info("Not enough free space in {}, job is evaluated in working directory", tmpfs_dir_.string());
+		return false;
+	}
+	return true;
+}
+
 void job_evaluator::download_submission()
 {
 	logger_->info("Trying to download submission archive...");
+	helpers::stopwatch watch;
 
 	// create directory for downloaded archive
 	fs::path archive_url = archive_url_;
@@ -40,6 +136,7 @@ void job_evaluator::download_submission()
 	archive_name_ = archive_url.filename();
 	remote_fm_->get_file(archive_url.string(), (archive_path_ / archive_name_).string());
 
+	job_timings_.emplace_back("download", watch.lap());
 	logger_->info("Submission archive downloaded succesfully.");
 	progress_callback_->job_archive_downloaded(job_id_);
 	return;
@@ -48,6 +145,7 @@ void job_evaluator::download_submission()
 void job_evaluator::prepare_submission()
 {
 	logger_->info("Preparing submission for usage...");
+	helpers::stopwatch watch;
 
 	// decompress downloaded archive directly to source path (eval dir)
 	try {
@@ -57,6 +155,7 @@ void job_evaluator::prepare_submission()
 	} catch (archive_exception &e) {
 		throw job_exception("Downloaded submission cannot be decompressed: " + std::string(e.what()));
 	}
+	job_timings_.emplace_back("decompress", watch.lap());
 
 	try {
 		fs::create_directories(results_path_);
@@ -80,26 +179,36 @@ void job_evaluator::build_job()
 	namespace fs = std::filesystem;
 	logger_->info("Building job...");
 
-	// find job-config.yml to load configuration
-	fs::path config_path(source_path_);
-	config_path /= "job-config.yml";
+	// find job-config.cbor or job-config.yml to load configuration, binary one is preferred
+	fs::path config_path = source_path_ / "job-config.cbor";
+	bool binary_config = fs::exists(config_path);
+	if (!binary_config) { config_path = source_path_ / "job-config.yml"; }
 	if (!fs::exists(config_path)) { throw job_exception("Job configuration not found"); }
 
 	// load configuration to object
-	logger_->info("Loading job configuration from yaml...");
+	logger_->info("Loading job configuration from {}...", config_path.filename().string());
+	helpers::stopwatch watch;
 	YAML::Node conf;
 	try {
-		conf = YAML::LoadFile(config_path.string());
-	} catch (YAML::Exception &e) {
+		if (binary_config) {
+			std::ifstream in(config_path.string(), std::ios::binary);
+			std::stringstream buffer;
+			buffer << in.rdbuf();
+			conf = helpers::cbor_to_yaml(buffer.str());
+		} else {
+			conf = YAML::LoadFile(config_path.string());
+		}
+	} catch (std::exception &e) {
 		throw job_exception("Job configuration not loaded correctly: " + std::string(e.what()));
 	}
-	logger_->info("Yaml job configuration loaded properly.");
+	job_timings_.emplace_back("yaml-parse", watch.lap());
+	logger_->info("Job configuration loaded properly.");
 
 	// copy job config to results archive
 	try {
-		fs::copy_file(config_path, (fs::path(results_path_) / fs::path("job-config.yml")).string());
+		fs::copy_file(config_path, results_path_ / config_path.filename());
 	} catch (fs::filesystem_error &e) {
-		logger_->warn("Copying of job-config.yml file to results archive failed: {}", e.what());
+		logger_->warn("Copying of job configuration file to results archive failed: {}", e.what());
 	}
 
 	// build job_metadata structure
@@ -119,29 +228,126 @@ void job_evaluator::build_job()
 	auto task_fileman = std::make_shared<fallback_file_manager>(
 		cache_fm_, std::make_shared<prefixed_file_manager>(remote_fm_, job_meta->file_server_url + "/"));
 
-	auto factory = std::make_shared<task_factory>(task_fileman);
+	auto factory = std::make_shared<task_factory>(task_fileman, box_pool_);
+
+	// tests which failed most often go first, so fail-fast jobs end sooner
+	if (failure_history_ != nullptr) {
+		history_key_ = failure_history::compute_key(conf);
+		failure_history_->apply(history_key_, *job_meta);
+	}
+	job_meta_ = job_meta;
 
 	// ... and construct job itself
 	job_ = std::make_shared<job>(
 		job_meta, config_, job_temp_dir_, source_path_, results_path_, factory, progress_callback_);
 
+	init_memoization(conf, *job_meta);
+	job_timings_.emplace_back("job-build", watch.lap());
+
 	logger_->info("Job building done.");
 	return;
 }
 
+void job_evaluator::init_memoization(const YAML::Node &conf, const job_metadata &job_meta)
+{
+	if (result_cache_ == nullptr) { return; }
+
+	if (!job_meta.memoize) {
+		logger_->info("Memoization of results is disabled by job configuration.");
+		return;
+	}
+	for (auto &task : job_meta.tasks) {
+		if (!task->memoize) {
+			logger_->info("Memoization of results is disabled by task {}.", task->task_id);
+			return;
+		}
+	}
+
+	try {
+		memo_key_ =
+			result_cache::compute_key(source_path_, conf, config_->get_hwgroup(), config_->get_results_config());
+	} catch (std::exception &e) {
+		logger_->warn("Memoization key of the job cannot be computed: {}", e.what());
+		memo_key_ = "";
+	}
+}
+
+bool job_evaluator::push_memoized_result()
+{
+	if (memo_key_.empty()) { return false; }
+
+	fs::path memoized_archive = archive_path_ / "memoized-result.zip";
+	if (!result_cache_->fetch(memo_key_, memoized_archive)) {
+		logger_->info("Memoized results not found, job will be evaluated.");
+		return false;
+	}
+	logger_->info("Memoized results found, skipping evaluation...");
+	helpers::stopwatch watch;
+
+	try {
+		// restore stored results, job configuration of current job is already in place
+		fs::path memoized_dir = job_temp_dir_ / "memoized-result";
+		fs::create_directories(memoized_dir);
+		archivator::decompress(memoized_archive.string(), memoized_dir.string());
+		if (!fs::exists(memoized_dir / "result" / get_result_filename())) {
+			logger_->info("Memoized results are stored in different format, job will be evaluated.");
+			return false;
+		}
+		for (auto &entry : fs::directory_iterator(memoized_dir / "result")) {
+			auto filename = entry.path().filename();
+			if (filename == "job-config.yml" || filename == "job-config.cbor") { continue; }
+			fs::rename(entry.path(), results_path_ / filename);
+		}
+
+		// results of the original job carry its identification
+		fs::path result_file = results_path_ / get_result_filename();
+		if (config_->get_result_format() == "cbor") {
+			cbor_results_writer::rewrite_job_id(result_file, job_id_);
+		} else {
+			YAML::Node res = YAML::LoadFile(result_file.string());
+			res["job-id"] = job_id_;
+			std::ofstream out(result_file.string());
+			out << helpers::yaml_to_string(res);
+		}
+	} catch (std::exception &e) {
+		// results directory may be partially overwritten, so evaluation cannot continue normally
+		throw job_exception("Memoized results cannot be restored: " + std::string(e.what()));
+	}
+	job_timings_.emplace_back("memoized-restore", watch.lap());
+
+	upload_result(false);
+	return true;
+}
+
 void job_evaluator::run_job()
 {
 	logger_->info("Ready for evaluation...");
+	helpers::stopwatch watch;
+	// results of tasks are written as they finish, push_result only completes the file
+	fs::path result_file = results_path_ / get_result_filename();
+	if (config_->get_result_format() == "cbor") {
+		results_writer_ = std::make_shared<cbor_results_writer>(result_file, job_id_, config_->get_hwgroup());
+	} else {
+		results_writer_ = std::make_shared<yaml_results_writer>(result_file, job_id_, config_->get_hwgroup());
+	}
+	job_->set_results_writer(results_writer_);
 	job_results_ = job_->run();
+	job_timings_.emplace_back("run", watch.lap());
 	logger_->info("Job evaluated.");
+
+	if (failure_history_ != nullptr) { failure_history_->record(history_key_, *job_meta_, job_results_); }
 }
 
 void job_evaluator::init_submission_paths()
 {
-	source_path_ = working_directory_ / "eval" / std::to_string(config_->get_worker_id()) / job_id_;
+	// evaluation and temporary directories are in memory if possible, downloads and results are always on disk
+	fs::path eval_directory = working_directory_;
+	if (!tmpfs_dir_.empty() && tmpfs_has_space()) { eval_directory = tmpfs_dir_; }
+
+	source_path_ = eval_directory / "eval" / std::to_string(config_->get_worker_id()) / job_id_;
 	archive_path_ = working_directory_ / "downloads" / std::to_string(config_->get_worker_id()) / job_id_;
 	// set temporary directory for tasks in job
-	job_temp_dir_ = working_directory_ / "temp" / std::to_string(config_->get_worker_id()) / job_id_;
+	job_temp_dir_ = eval_directory / "temp" / std::to_string(config_->get_worker_id()) / job_id_;
 	results_path_ = working_directory_ / "results" / std::to_string(config_->get_worker_id()) / job_id_;
 }
 
@@ -203,6 +409,12 @@ void job_evaluator::cleanup_variables()
 
 		job_id_ = "";
 		job_ = nullptr;
+		job_results_.clear();
+		memo_key_ = "";
+		history_key_ = "";
+		results_writer_ = nullptr;
+		job_meta_ = nullptr;
+		job_timings_.clear();
 	} catch (std::exception &e) {
 		logger_->error("Error in deinicialization of evaluator: {}", e.what());
 	}
@@ -231,72 +443,58 @@ void job_evaluator::push_result()
 		return;
 	}
 
-	// define path to result yaml file and archived result
-	fs::path result_yaml = results_path_ / "result.yml";
-	fs::path archive_path = results_path_ / "result.zip";
-
-	logger_->info("Building yaml results file...");
-	// build yaml tree
-	YAML::Node res;
-	res["job-id"] = job_id_;
-	res["hw-group"] = config_->get_hwgroup();
-	for (auto &i : job_results_) {
-		YAML::Node node;
-		node["task-id"] = i.first;
-
-		switch (i.second->status) {
-		case task_status::OK: node["status"] = "OK"; break;
-		case task_status::FAILED: node["status"] = "FAILED"; break;
-		case task_status::SKIPPED: node["status"] = "SKIPPED"; break;
+	logger_->info("Finishing results file...");
+	helpers::stopwatch watch;
+	YAML::Node timings;
+	if (config_->get_result_timings()) {
+		// phases of results writing and uploading cannot be measured in advance, they are only in worker statistics
+		for (auto &phase : job_timings_) { timings["job"][phase.first] = phase.second; }
+		for (auto &i : job_results_) {
+			if (i.second == nullptr) { continue; }
+			for (auto &phase : i.second->timings) { timings["tasks"][i.first][phase.first] = phase.second; }
 		}
+	}
+	if (calibrator_ != nullptr) {
+		// speed of the host, so the times can be compared across hosts of the hwgroup
+		auto scores = calibrator_->get();
+		if (scores.measured) {
+			timings["calibration"]["integer"] = scores.integer;
+			timings["calibration"]["floating"] = scores.floating;
+			timings["calibration"]["memory"] = scores.memory;
+		}
+	}
 
-		if (!i.second->error_message.empty()) { node["error_message"] = i.second->error_message; }
+	// results of all tasks are already written by the job
+	results_writer_->finish(timings);
+	results_writer_ = nullptr;
+	job_timings_.emplace_back("result-write", watch.lap());
+	logger_->info("Result file written succesfully.");
 
-		if (!i.second->output_stdout.empty() || !i.second->output_stderr.empty()) {
-			YAML::Node output_node;
-			if (!i.second->output_stdout.empty()) { output_node["stdout"] = i.second->output_stdout; }
-			if (!i.second->output_stderr.empty()) { output_node["stderr"] = i.second->output_stderr; }
-			node["output"] = output_node;
-		}
+	// results cut short by the budget of the job depend on the speed of the worker
+	bool memoize = !memo_key_.empty() && !job_->is_budget_exceeded();
+	for (auto &i : job_results_) {
+		if (i.second == nullptr) { continue; }
 
-		auto &sandbox = i.second->sandbox_status;
-		if (sandbox != nullptr) {
-			YAML::Node subnode;
-			subnode["exitcode"] = sandbox->exitcode;
-			subnode["time"] = sandbox->time;
-			subnode["wall-time"] = sandbox->wall_time;
-			subnode["memory"] = sandbox->memory;
-			subnode["max-rss"] = sandbox->max_rss;
-
-			switch (sandbox->status) {
-			case isolate_status::OK: subnode["status"] = "OK"; break;
-			case isolate_status::RE: subnode["status"] = "RE"; break;
-			case isolate_status::SG: subnode["status"] = "SG"; break;
-			case isolate_status::TO: subnode["status"] = "TO"; break;
-			case isolate_status::XX: subnode["status"] = "XX"; break;
-			}
-
-			subnode["exitsig"] = sandbox->exitsig;
-			subnode["killed"] = sandbox->killed;
-			subnode["message"] = sandbox->message;
-			subnode["csw-voluntary"] = sandbox->csw_voluntary;
-			subnode["csw-forced"] = sandbox->csw_forced;
-
-			node["sandbox_results"] = subnode;
-		}
+		// failures of internal tasks usually depend on the environment (e.g., unavailable file server)
+		if (i.second->status == task_status::FAILED && i.second->sandbox_status == nullptr) { memoize = false; }
 
-		res["results"].push_back(node);
+		// runs slowed down by the host should be evaluated again
+		auto &sandbox = i.second->sandbox_status;
+		if (sandbox != nullptr && sandbox->host != nullptr && sandbox->host->tainted) { memoize = false; }
 	}
 
-	// make sure the yaml is ascii encoded
-	YAML::Emitter yaml_out;
-	yaml_out.SetOutputCharset(YAML::EscapeNonAscii);
-	yaml_out << res;
-	// open output stream and write constructed yaml
-	std::ofstream out(result_yaml.string());
-	out << yaml_out.c_str();
-	out.close();
-	logger_->info("Yaml result file written succesfully.");
+	upload_result(memoize);
+}
+
+std::string job_evaluator::get_result_filename() const
+{
+	return config_->get_result_format() == "cbor" ? "result.cbor" : "result.yml";
+}
+
+void job_evaluator::upload_result(bool memoize)
+{
+	fs::path archive_path = results_path_ / "result.zip";
+	helpers::stopwatch watch;
 
 	// compress given result.yml file
 	logger_->info("Compression of results file...");
@@ -308,8 +506,11 @@ void job_evaluator::push_result()
 	}
 	logger_->info("Compression done.");
 
+	if (memoize) { result_cache_->store(memo_key_, archive_path); }
+
 	// send archived result to file server
 	remote_fm_->put_file(archive_path.string(), result_url_);
+	job_timings_.emplace_back("upload", watch.lap());
 
 	logger_->info("Job results uploaded succesfully.");
 	progress_callback_->job_results_uploaded(job_id_);
@@ -334,8 +535,10 @@ eval_response job_evaluator::evaluate(eval_request request)
 		download_submission();
 		prepare_submission();
 		build_job();
-		run_job();
-		push_result();
+		if (!push_memoized_result()) {
+			run_job();
+			push_result();
+		}
 
 		progress_callback_->job_finished(job_id_);
 
@@ -354,7 +557,27 @@ eval_response job_evaluator::evaluate(eval_request request)
 	}
 
 	logger_->info("Job ({}) ended.", job_id_);
+	process_timings();
 	cleanup_evaluator();
 
 	return response.get_eval_response();
 }
+
+void job_evaluator::process_timings()
+{
+	try {
+		helpers::timing_stats job_stats;
+		job_stats.add(job_timings_);
+		for (auto &i : job_results_) {
+			if (i.second == nullptr) { continue; }
+			job_stats.add(i.second->timings, "task.");
+			timing_stats_.add(i.second->timings, "task.");
+		}
+		timing_stats_.add(job_timings_);
+
+		logger_->info("Timings of job ({}): {}", job_id_, job_stats.to_string());
+		logger_->info("Timings of all evaluated jobs: {}", timing_stats_.to_string());
+	} catch (std::exception &e) {
+		logger_->warn("Timings of job cannot be processed: {}", e.what());
+	}
+}
@@ -15,6 +15,10 @@
 #include "archives/archivator.h"
 #include "helpers/filesystem.h"
 #include "job_evaluator_interface.h"
+#include "result_cache.h"
+#include "failure_history.h"
+#include "helpers/timings.h"
+#include "helpers/calibration.h"
 
 namespace fs = std::filesystem;
 
@@ -38,13 +42,15 @@ public:
 	 * @param cache_fm a file manager that works with a local cache
 	 * @param working_directory a directory in which the evaluation is done
 	 * @param progr_callback a callback for notifying the broker of progress
+	 * @param calibrator calibration of the host whose scores are added to results (optional)
 	 */
 	job_evaluator(std::shared_ptr<spdlog::logger> logger,
 		std::shared_ptr<worker_config> config,
 		std::shared_ptr<file_manager_interface> remote_fm,
 		std::shared_ptr<file_manager_interface> cache_fm,
 		fs::path working_directory,
-		std::shared_ptr<progress_callback_interface> progr_callback);
+		std::shared_ptr<progress_callback_interface> progr_callback,
+		std::shared_ptr<helpers::calibrator> calibrator = nullptr);
 
 	/**
 	 * Process an "eval" request
@@ -73,6 +79,21 @@ private:
 	 */
 	void build_job();
 
+	/**
+	 * Compute memoization key of the built job, if the memoization is enabled and job allows it.
+	 * No throw function, on failure the job is just not memoized.
+	 * @param conf loaded job configuration
+	 * @param job_meta job metadata built from the configuration
+	 */
+	void init_memoization(const YAML::Node &conf, const job_metadata &job_meta);
+
+	/**
+	 * Try to find memoized results of identical job and upload them instead of running the job.
+	 * Results are updated to carry identification and configuration of current job.
+	 * @return true if memoized results were uploaded, false if the job has to be evaluated
+	 */
+	bool push_memoized_result();
+
 	/**
 	 * Evaluates job itself. Basically means call function run on job instance.
 	 */
@@ -108,6 +129,12 @@ private:
 	 */
 	void push_result();
 
+	/**
+	 * Compress results directory and send the archive to the remote file server.
+	 * @param memoize if true, the archive is also stored in the result cache
+	 */
+	void upload_result(bool memoize);
+
 	/**
 	 * Initialize all paths used in job_evaluator. Has to be done before any other action.
 	 * No throw function.
@@ -120,6 +147,45 @@ private:
 	 */
 	void init_progress_callback();
 
+	/**
+	 * Initialize result cache if memoization of jobs is enabled in worker configuration.
+	 */
+	void init_result_cache();
+
+	/**
+	 * Initialize failure history if ordering of tests by their failures is enabled in worker configuration.
+	 */
+	void init_failure_history();
+
+	/**
+	 * Initialize pool of pre-initialized isolate boxes if it is enabled in worker configuration.
+	 */
+	void init_box_pool();
+
+	/**
+	 * Initialize memory backed directory for evaluation of jobs if it is set in worker configuration.
+	 */
+	void init_tmpfs();
+
+	/**
+	 * Check whether there is enough free space in memory backed directory for current job.
+	 * No throw function.
+	 * @return true if the job can be evaluated in memory
+	 */
+	bool tmpfs_has_space();
+
+	/**
+	 * Add timings of current job to aggregated statistics and log them.
+	 * No throw function.
+	 */
+	void process_timings();
+
+	/**
+	 * Get name of the results file according to the format set in worker configuration.
+	 * @return file name
+	 */
+	std::string get_result_filename() const;
+
 
 	// PRIVATE DATA MEMBERS
 	/** Working directory of this whole program */
@@ -136,6 +202,8 @@ private:
 	fs::path results_path_;
 	/** Path for saving temporary files by tasks */
 	fs::path job_temp_dir_;
+	/** Memory backed directory for evaluation and temporary directories, empty if not used */
+	fs::path tmpfs_dir_;
 	/** Url of remote file server which receives result of jobs */
 	std::string result_url_;
 
@@ -156,6 +224,26 @@ private:
 	std::shared_ptr<worker_config> config_;
 	/** Progress callback which is used to signal progress to whoever wants */
 	std::shared_ptr<progress_callback_interface> progress_callback_;
+	/** Store of memoized job results, nullptr if memoization is disabled */
+	std::shared_ptr<result_cache> result_cache_;
+	/** Memoization key of current job, empty if the job is not memoized */
+	std::string memo_key_;
+	/** Failure rates of tests used for ordering of tasks, nullptr if disabled */
+	std::shared_ptr<failure_history> failure_history_;
+	/** Pool of pre-initialized isolate boxes, nullptr if disabled */
+	std::shared_ptr<isolate_box_pool> box_pool_;
+	/** Calibration of the host, nullptr if disabled */
+	std::shared_ptr<helpers::calibrator> calibrator_;
+	/** Key of the exercise of current job in failure history */
+	std::string history_key_;
+	/** Metadata of current job */
+	std::shared_ptr<job_metadata> job_meta_;
+	/** Writer of results file of current job */
+	std::shared_ptr<results_writer> results_writer_;
+	/** Durations of phases of current job */
+	helpers::phase_timings job_timings_;
+	/** Durations of phases aggregated over all evaluated jobs */
+	helpers::timing_stats timing_stats_;
 };
 
 #endif // RECODEX_WORKER_JOB_EVALUATOR_HPP
@@ -66,12 +66,16 @@ void progress_callback::job_aborted(const std::string &job_id)
 	send_job_status("job_aborted", job_id, "ABORTED");
 }
 
-void progress_callback::send_task_status(
-	const std::string &func_name, const std::string &job_id, const std::string &task_id, const std::string &task_status)
+void progress_callback::send_task_status(const std::string &func_name,
+	const std::string &job_id,
+	const std::string &task_id,
+	const std::string &task_status,
+	const std::string &task_data)
 {
 	try {
 		connect();
 		std::vector<std::string> msg = {command_, job_id, "TASK", task_id, task_status};
+		if (!task_data.empty()) { msg.push_back(task_data); }
 		helpers::send_through_socket(socket_, msg);
 	} catch (...) {
 		logger_->warn("progress_callback: call of {} failed", func_name);
@@ -93,3 +97,8 @@ void progress_callback::task_skipped(const std::string &job_id, const std::strin
 {
 	send_task_status("task_skipped", job_id, task_id, "SKIPPED");
 }
+
+void progress_callback::task_results(const std::string &job_id, const std::string &task_id, const std::string &results)
+{
+	send_task_status("task_results", job_id, task_id, "RESULTS", results);
+}
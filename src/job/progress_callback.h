@@ -46,11 +46,13 @@ private:
 	 * @param job_id identification of job
 	 * @param task_id identification of task
 	 * @param task_status status of task
+	 * @param task_data optional data attached to the status, not sent if empty
 	 */
 	void send_task_status(const std::string &func_name,
 		const std::string &job_id,
 		const std::string &task_id,
-		const std::string &task_status);
+		const std::string &task_status,
+		const std::string &task_data = "");
 
 public:
 	/**
@@ -70,6 +72,7 @@ public:
 	void task_completed(const std::string &job_id, const std::string &task_id) override;
 	void task_failed(const std::string &job_id, const std::string &task_id) override;
 	void task_skipped(const std::string &job_id, const std::string &task_id) override;
+	void task_results(const std::string &job_id, const std::string &task_id, const std::string &results) override;
 };
 
 #endif // RECODEX_WORKER_PROGRESS_CALLBACK_H
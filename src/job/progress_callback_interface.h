@@ -82,6 +82,14 @@ public:
 	 * @note Implementation should not throw an exception.
 	 */
 	virtual void task_skipped(const std::string &job_id, const std::string &task_id) = 0;
+	/**
+	 * Results of the task are available before the whole job ends.
+	 * @param job_id unique identification of job
+	 * @param task_id unique identification of the task
+	 * @param results serialized results of the task (yaml in the same format as in results file)
+	 * @note Implementation should not throw an exception.
+	 */
+	virtual void task_results(const std::string &job_id, const std::string &task_id, const std::string &results) = 0;
 };
 
 /**
@@ -131,6 +139,10 @@ public:
 	void task_skipped(const std::string &job_id, const std::string &task_id) override
 	{
 	}
+
+	void task_results(const std::string &job_id, const std::string &task_id, const std::string &results) override
+	{
+	}
 };
 
 #endif // RECODEX_WORKER_PROGRESS_CALLBACK_BASE_H
@@ -0,0 +1,86 @@
+#include "result_cache.h"
+#include "job_exception.h"
+#include "helpers/hash.h"
+#include "helpers/filesystem.h"
+#include "helpers/string_utils.h"
+#include <algorithm>
+#include <vector>
+
+
+result_cache::result_cache(const fs::path &cache_dir, std::shared_ptr<spdlog::logger> logger)
+	: cache_dir_(cache_dir), logger_(logger)
+{
+	if (logger_ == nullptr) { logger_ = helpers::create_null_logger(); }
+
+	try {
+		if (!fs::is_directory(cache_dir_)) { fs::create_directories(cache_dir_); }
+	} catch (fs::filesystem_error &e) {
+		throw job_exception("Cannot create result cache directory " + cache_dir_.string() + ". Error: " + e.what());
+	}
+}
+
+std::string result_cache::compute_key(const fs::path &source_dir,
+	const YAML::Node &job_config,
+	const std::string &hwgroup,
+	const std::string &worker_config,
+	const std::string &version)
+{
+	// list submitted files in a stable order, job configuration is hashed separately
+	std::vector<fs::path> files;
+	try {
+		for (auto &entry : fs::recursive_directory_iterator(source_dir)) {
+			auto relative = entry.path().lexically_relative(source_dir);
+			bool is_config = relative == "job-config.yml" || relative == "job-config.cbor";
+			if (entry.is_regular_file() && !is_config) { files.push_back(relative); }
+		}
+	} catch (fs::filesystem_error &e) {
+		throw helpers::filesystem_exception("Cannot list submission files: " + std::string(e.what()));
+	}
+	std::sort(files.begin(), files.end());
+
+	std::string input;
+	for (auto &file : files) { input += file.generic_string() + "\n" + helpers::sha1_file(source_dir / file) + "\n"; }
+
+	// job identifier differs with every rejudge, so it cannot be part of the key
+	YAML::Node config = YAML::Clone(job_config);
+	if (config["submission"] && config["submission"].IsMap()) { config["submission"].remove("job-id"); }
+	YAML::Emitter config_out;
+	config_out << config;
+
+	input += helpers::sha1_string(config_out.c_str()) + "\n" + hwgroup + "\n" + version + "\n";
+	input += helpers::sha1_string(worker_config);
+	return helpers::sha1_string(input);
+}
+
+bool result_cache::fetch(const std::string &key, const fs::path &destination)
+{
+	fs::path source_file = cache_dir_ / (key + ".zip");
+	if (!fs::is_regular_file(source_file)) { return false; }
+
+	try {
+		fs::copy_file(source_file, destination, fs::copy_options::overwrite_existing);
+		// change last modification time of the file, so the cleaner keeps frequently used results
+		fs::last_write_time(source_file, fs::file_time_type::clock::now());
+	} catch (fs::filesystem_error &e) {
+		logger_->warn("Memoized results {} cannot be used: {}", key, e.what());
+		return false;
+	}
+
+	return true;
+}
+
+void result_cache::store(const std::string &key, const fs::path &source)
+{
+	fs::path destination_file = cache_dir_ / (key + ".zip");
+	fs::path destination_temp_file = cache_dir_ / (key + "-" + helpers::random_alphanum_string(20) + ".tmp");
+
+	try {
+		// first copy only temporary file and then move (atomically) the file to its original destination
+		fs::copy_file(source, destination_temp_file, fs::copy_options::overwrite_existing);
+		fs::rename(destination_temp_file, destination_file);
+	} catch (fs::filesystem_error &e) {
+		logger_->warn("Results cannot be memoized under key {}: {}", key, e.what());
+		std::error_code ec;
+		fs::remove(destination_temp_file, ec);
+	}
+}
@@ -0,0 +1,77 @@
+#ifndef RECODEX_WORKER_RESULT_CACHE_H
+#define RECODEX_WORKER_RESULT_CACHE_H
+
+#include <string>
+#include <memory>
+#include <filesystem>
+#include <yaml-cpp/yaml.h>
+#include "helpers/logger.h"
+
+namespace fs = std::filesystem;
+
+#ifndef RECODEX_WORKER_VERSION
+/** Version of the worker binary, normally supplied by the build system. */
+#define RECODEX_WORKER_VERSION "unknown"
+#endif
+
+
+/**
+ * Local store of archived job results used for memoization of whole jobs.
+ *
+ * When a job is re-evaluated (typically during rejudging) with the same submission files and job configuration
+ * on the same hardware group, the same worker version and worker configuration, its results can be taken from here
+ * instead of running the job again. Entries are stored as zip archives named by the memoization key. Like in the file cache, removing
+ * old entries is left on recodex-cleaner project.
+ */
+class result_cache
+{
+public:
+	/**
+	 * Set up result cache with its storage directory.
+	 * @param cache_dir Directory where results will be stored. If this directory don't exist, it'll be created.
+	 * @param logger Shared pointer to system logger (optional).
+	 * @throws job_exception if the directory cannot be created
+	 */
+	result_cache(const fs::path &cache_dir, std::shared_ptr<spdlog::logger> logger = nullptr);
+
+	/**
+	 * Compute memoization key from all inputs which can influence results of the job.
+	 * Submission is hashed by the content of its decompressed files, so repacked archives still match. Job identifier
+	 * is not part of the key, because every rejudge gets a new one.
+	 * @param source_dir directory with decompressed submission, job configuration files in its root are skipped
+	 * @param job_config loaded job configuration
+	 * @param hwgroup hardware group of the worker
+	 * @param worker_config items of the worker configuration which change results
+	 * @param version version of the worker binary
+	 * @return textual key usable as a file name
+	 * @throws filesystem_exception if some of the files cannot be read
+	 */
+	static std::string compute_key(const fs::path &source_dir,
+		const YAML::Node &job_config,
+		const std::string &hwgroup,
+		const std::string &worker_config,
+		const std::string &version = RECODEX_WORKER_VERSION);
+
+	/**
+	 * Copy memoized results with given key to destination.
+	 * @param key memoization key
+	 * @param destination path where archived results will be copied
+	 * @return true on cache hit, false if the results are not present or cannot be copied
+	 */
+	bool fetch(const std::string &key, const fs::path &destination);
+
+	/**
+	 * Store archived results under given key. Failures are only logged, memoization is always optional.
+	 * @param key memoization key
+	 * @param source path to archived results
+	 */
+	void store(const std::string &key, const fs::path &source);
+
+private:
+	/** Path to the directory with memoized results. */
+	fs::path cache_dir_;
+	/** System or null logger. */
+	std::shared_ptr<spdlog::logger> logger_;
+};
+
+#endif // RECODEX_WORKER_RESULT_CACHE_H
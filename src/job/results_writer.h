@@ -0,0 +1,40 @@
+#ifndef RECODEX_WORKER_RESULTS_WRITER_H
+#define RECODEX_WORKER_RESULTS_WRITER_H
+
+#include <string>
+#include <yaml-cpp/yaml.h>
+#include "config/task_results.h"
+
+
+/**
+ * Interface of incremental writers of the results file.
+ *
+ * Results of tasks are written one by one as the tasks finish, so the whole results document never has to be held
+ * in memory. All formats share the same structure: job identification, sequence of task results and optional
+ * timings section.
+ */
+class results_writer
+{
+public:
+	/**
+	 * Virtual destructor.
+	 */
+	virtual ~results_writer() = default;
+
+	/**
+	 * Append results of one task to the file.
+	 * @param task_id identification of the task
+	 * @param results results of the task
+	 * @throws job_exception if writing fails
+	 */
+	virtual void write(const std::string &task_id, const task_results &results) = 0;
+
+	/**
+	 * Finish the document and close the file. No other records can be written afterwards.
+	 * @param timings timings section, omitted if not defined
+	 * @throws job_exception if writing fails
+	 */
+	virtual void finish(const YAML::Node &timings = YAML::Node()) = 0;
+};
+
+#endif // RECODEX_WORKER_RESULTS_WRITER_H
@@ -0,0 +1,49 @@
+#include "yaml_results_writer.h"
+#include "job_exception.h"
+#include "helpers/results.h"
+
+
+yaml_results_writer::yaml_results_writer(
+	const fs::path &result_file, const std::string &job_id, const std::string &hwgroup)
+	: result_file_(result_file), out_(result_file.string()), emitter_(out_)
+{
+	if (!out_.is_open()) { throw job_exception("Results file " + result_file_.string() + " cannot be opened"); }
+
+	// make sure the yaml is ascii encoded
+	emitter_.SetOutputCharset(YAML::EscapeNonAscii);
+	emitter_ << YAML::BeginMap;
+	emitter_ << YAML::Key << "job-id" << YAML::Value << job_id;
+	emitter_ << YAML::Key << "hw-group" << YAML::Value << hwgroup;
+	check_output();
+}
+
+void yaml_results_writer::write(const std::string &task_id, const task_results &results)
+{
+	if (finished_) { throw job_exception("Results file is already finished"); }
+
+	if (!results_started_) {
+		emitter_ << YAML::Key << "results" << YAML::Value << YAML::BeginSeq;
+		results_started_ = true;
+	}
+	emitter_ << helpers::task_results_to_yaml(task_id, results);
+	check_output();
+}
+
+void yaml_results_writer::finish(const YAML::Node &timings)
+{
+	if (finished_) { return; }
+
+	if (results_started_) { emitter_ << YAML::EndSeq; }
+	if (timings.IsDefined() && !timings.IsNull()) { emitter_ << YAML::Key << "timings" << YAML::Value << timings; }
+	emitter_ << YAML::EndMap;
+	out_ << std::endl;
+	out_.close();
+	finished_ = true;
+	check_output();
+}
+
+void yaml_results_writer::check_output()
+{
+	if (!emitter_.good()) { throw job_exception("Results cannot be emitted: " + emitter_.GetLastError()); }
+	if (out_.fail()) { throw job_exception("Results file " + result_file_.string() + " cannot be written"); }
+}
@@ -0,0 +1,47 @@
+#ifndef RECODEX_WORKER_YAML_RESULTS_WRITER_H
+#define RECODEX_WORKER_YAML_RESULTS_WRITER_H
+
+#include <fstream>
+#include <filesystem>
+#include "results_writer.h"
+
+namespace fs = std::filesystem;
+
+
+/**
+ * Incremental writer of yaml results file (result.yml).
+ * Output is the same as if the document was built as one yaml tree and emitted at once.
+ */
+class yaml_results_writer : public results_writer
+{
+public:
+	/**
+	 * Open results file and write header of the document.
+	 * @param result_file path to the results file, it is overwritten
+	 * @param job_id identification of the job
+	 * @param hwgroup hardware group of the worker
+	 * @throws job_exception if the file cannot be opened
+	 */
+	yaml_results_writer(const fs::path &result_file, const std::string &job_id, const std::string &hwgroup);
+
+	void write(const std::string &task_id, const task_results &results) override;
+
+	void finish(const YAML::Node &timings = YAML::Node()) override;
+
+private:
+	/** Check state of output stream and emitter. */
+	void check_output();
+
+	/** Path to the results file */
+	fs::path result_file_;
+	/** Opened results file */
+	std::ofstream out_;
+	/** Streaming emitter writing into @ref out_ */
+	YAML::Emitter emitter_;
+	/** True if sequence of results was already started */
+	bool results_started_ = false;
+	/** True if the document is complete */
+	bool finished_ = false;
+};
+
+#endif // RECODEX_WORKER_YAML_RESULTS_WRITER_H
@@ -0,0 +1,109 @@
+#ifndef _WIN32
+
+#include "isolate_box_pool.h"
+#include "isolate_sandbox.h"
+
+
+isolate_box_pool::isolate_box_pool(const std::vector<std::size_t> &box_ids,
+	std::shared_ptr<spdlog::logger> logger,
+	init_function init,
+	cleanup_function cleanup)
+	: logger_(logger), init_(init), cleanup_(cleanup), usable_(box_ids.size()), dirty_(box_ids.begin(), box_ids.end())
+{
+	if (logger_ == nullptr) { logger_ = helpers::create_null_logger(); }
+	if (!init_) {
+		init_ = [this](std::size_t id) { return isolate_sandbox::init_box(id, sandbox_limits(), logger_); };
+	}
+	if (!cleanup_) {
+		cleanup_ = [this](std::size_t id) { isolate_sandbox::cleanup_box(id, logger_); };
+	}
+
+	thread_ = std::thread(&isolate_box_pool::recycle_loop, this);
+}
+
+isolate_box_pool::~isolate_box_pool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	dirty_cv_.notify_all();
+	thread_.join();
+
+	// boxes in use are cleaned up when returned, here only the ready ones remain
+	for (auto &box : ready_) {
+		try {
+			cleanup_(box.id);
+		} catch (std::exception &e) {
+			logger_->warn("Pooled isolate box {} cannot be cleaned up: {}", box.id, e.what());
+		}
+	}
+}
+
+bool isolate_box_pool::acquire(box &result)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	ready_cv_.wait(lock, [this]() { return !ready_.empty() || usable_ == 0; });
+	if (ready_.empty()) { return false; }
+
+	result = ready_.front();
+	ready_.pop_front();
+	return true;
+}
+
+void isolate_box_pool::release(std::size_t box_id)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		dirty_.push_back(box_id);
+	}
+	dirty_cv_.notify_one();
+}
+
+void isolate_box_pool::recycle_loop()
+{
+	while (true) {
+		std::size_t id;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			dirty_cv_.wait(lock, [this]() { return !dirty_.empty() || stop_; });
+			if (dirty_.empty()) { return; }
+			id = dirty_.front();
+			dirty_.pop_front();
+		}
+
+		// the box may be left initialized from previous usage (or previous run of the worker)
+		try {
+			cleanup_(id);
+		} catch (std::exception &e) {
+			logger_->debug("Pooled isolate box {} cannot be cleaned up: {}", id, e.what());
+		}
+
+		box ready_box;
+		bool initialized = false;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			// do not initialize new boxes, they would be left behind
+			if (stop_) { continue; }
+		}
+		try {
+			ready_box.id = id;
+			ready_box.sandboxed_dir = init_(id);
+			initialized = true;
+		} catch (std::exception &e) {
+			logger_->warn("Pooled isolate box {} cannot be initialized and will not be used: {}", id, e.what());
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (initialized) {
+				ready_.push_back(ready_box);
+			} else {
+				--usable_;
+			}
+		}
+		ready_cv_.notify_all();
+	}
+}
+
+#endif // _WIN32
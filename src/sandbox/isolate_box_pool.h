@@ -0,0 +1,98 @@
+#ifndef RECODEX_WORKER_ISOLATE_BOX_POOL_H
+#define RECODEX_WORKER_ISOLATE_BOX_POOL_H
+
+#ifndef _WIN32
+
+#include <memory>
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "helpers/logger.h"
+
+/**
+ * Pool of isolate boxes which are initialized ahead of time.
+ *
+ * Initialization and cleanup of isolate box is a large fixed cost of every sandboxed task. Pool keeps given boxes
+ * initialized, hands them to sandboxes and recycles returned boxes (cleanup and init) in a background thread, so
+ * the next task gets a ready box immediately. Boxes are initialized without disk quotas.
+ */
+class isolate_box_pool
+{
+public:
+	/** Initialized box ready for use. */
+	struct box {
+		/** Identifier of the box */
+		std::size_t id = 0;
+		/** Path to the directory of the box */
+		std::string sandboxed_dir;
+	};
+
+	/** Function which initializes box with given identifier and returns its directory. */
+	using init_function = std::function<std::string(std::size_t)>;
+	/** Function which cleans up box with given identifier. */
+	using cleanup_function = std::function<void(std::size_t)>;
+
+	/**
+	 * Start initialization of all boxes in background.
+	 * @param box_ids identifiers of boxes in the pool, they must not be used by anyone else on the machine
+	 * @param logger system logger (optional)
+	 * @param init function used for initialization of boxes, isolate is used if empty
+	 * @param cleanup function used for cleanup of boxes, isolate is used if empty
+	 */
+	isolate_box_pool(const std::vector<std::size_t> &box_ids,
+		std::shared_ptr<spdlog::logger> logger = nullptr,
+		init_function init = nullptr,
+		cleanup_function cleanup = nullptr);
+
+	/**
+	 * Stop background thread and clean up all boxes.
+	 */
+	~isolate_box_pool();
+
+	/**
+	 * Take ready box from the pool, wait if all usable boxes are being recycled.
+	 * @param result taken box
+	 * @return false if there is no usable box (all of them failed to initialize)
+	 */
+	bool acquire(box &result);
+
+	/**
+	 * Return box to the pool, it will be cleaned up and initialized again in background.
+	 * @param box_id identifier of returned box
+	 */
+	void release(std::size_t box_id);
+
+private:
+	/** Body of the background thread. */
+	void recycle_loop();
+
+	/** System or null logger */
+	std::shared_ptr<spdlog::logger> logger_;
+	/** Box initialization */
+	init_function init_;
+	/** Box cleanup */
+	cleanup_function cleanup_;
+	/** Number of boxes which can still be used */
+	std::size_t usable_;
+	/** Boxes ready for use */
+	std::deque<box> ready_;
+	/** Boxes waiting for cleanup and initialization */
+	std::deque<std::size_t> dirty_;
+	/** Set when the pool is being destroyed */
+	bool stop_ = false;
+	/** Guards all members above */
+	std::mutex mutex_;
+	/** Signals new ready boxes or unusable ones */
+	std::condition_variable ready_cv_;
+	/** Signals new dirty boxes or stop request */
+	std::condition_variable dirty_cv_;
+	/** Background recycling thread */
+	std::thread thread_;
+};
+
+#endif // _WIN32
+#endif // RECODEX_WORKER_ISOLATE_BOX_POOL_H
@@ -5,6 +5,8 @@
 #include <sys/types.h>
 #include <sys/mount.h>
 #include <sys/wait.h>
+#include <spawn.h>
+#include <signal.h>
 #include <string.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -14,12 +16,20 @@
 #include <fstream>
 #include <map>
 #include <filesystem>
+#include <chrono>
+#include <algorithm>
+#include <exception>
 #include "helpers/filesystem.h"
+#include "helpers/cgroup.h"
+#include "helpers/process.h"
 
 namespace fs = std::filesystem;
 
 namespace
 {
+	/** Name of isolate binary, it has to be in PATH */
+	const char *isolate_binary = "isolate";
+
 	void move_or_throw(std::shared_ptr<spdlog::logger> logger, const std::string &from, const std::string &to)
 	{
 		try {
@@ -33,6 +43,88 @@ namespace
 		} catch (fs::filesystem_error &) {
 		}
 	}
+
+	/**
+	 * Start isolate without duplicating address space of the worker (no fork).
+	 * Standard input of isolate is redirected to /dev/null.
+	 * @param args arguments, the first one is name of isolate binary which is searched in PATH
+	 * @param stdout_fd descriptor used as standard output, /dev/null if -1
+	 * @param stderr_fd descriptor used as standard error output, /dev/null if -1
+	 * @return pid of isolate process
+	 */
+	pid_t spawn_isolate(std::shared_ptr<spdlog::logger> logger,
+		const std::vector<std::string> &args,
+		int stdout_fd = -1,
+		int stderr_fd = -1)
+	{
+		std::vector<char *> c_args;
+		// const_cast is ugly, but this is working with C code - posix_spawn does not modify its arguments
+		for (auto &arg : args) { c_args.push_back(const_cast<char *>(arg.c_str())); }
+		c_args.push_back(nullptr);
+
+		posix_spawn_file_actions_t actions;
+		posix_spawn_file_actions_init(&actions);
+		posix_spawn_file_actions_addopen(&actions, 0, "/dev/null", O_RDONLY, 0);
+		if (stdout_fd == -1) {
+			posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
+		} else {
+			posix_spawn_file_actions_adddup2(&actions, stdout_fd, 1);
+		}
+		if (stderr_fd == -1) {
+			posix_spawn_file_actions_addopen(&actions, 2, "/dev/null", O_WRONLY, 0);
+		} else {
+			posix_spawn_file_actions_adddup2(&actions, stderr_fd, 2);
+		}
+
+		pid_t pid;
+		int ret = posix_spawnp(&pid, c_args[0], &actions, nullptr, c_args.data(), environ);
+		posix_spawn_file_actions_destroy(&actions);
+		if (ret != 0) { log_and_throw(logger, "Cannot start isolate: ", strerror(ret)); }
+		return pid;
+	}
+
+	/**
+	 * Move directory by renaming it, an empty destination directory is replaced. Symlinks are removed first,
+	 * because copying skips them as well.
+	 * @return false if the directories are on different filesystems and the data have to be copied
+	 */
+	bool rename_or_throw(std::shared_ptr<spdlog::logger> logger, const std::string &from, const std::string &to)
+	{
+		try {
+			helpers::remove_symlinks(from);
+			fs::rename(from, to);
+		} catch (fs::filesystem_error &e) {
+			if (e.code() == std::errc::cross_device_link) { return false; }
+			log_and_throw(logger, "Failed renaming ", from, " to ", to, ", error: ", e.what());
+		} catch (helpers::filesystem_exception &e) {
+			log_and_throw(logger, "Failed renaming ", from, " to ", to, ", error: ", e.what());
+		}
+		return true;
+	}
+
+	/**
+	 * Move data directory back from the box, @a renamed tells whether it was renamed into the box. The renamed box
+	 * directory is created again with permissions @a box_perms, because isolate expects it to exist.
+	 */
+	void move_out_or_throw(std::shared_ptr<spdlog::logger> logger,
+		const std::string &box_dir,
+		const std::string &data_dir,
+		bool renamed,
+		fs::perms box_perms)
+	{
+		if (!renamed || !rename_or_throw(logger, box_dir, data_dir)) {
+			move_or_throw(logger, box_dir, data_dir);
+			return;
+		}
+
+		// isolate expects the box directory to exist (pooled boxes are used again)
+		try {
+			fs::create_directory(box_dir);
+			fs::permissions(box_dir, box_perms);
+		} catch (fs::filesystem_error &e) {
+			log_and_throw(logger, "Cannot recreate box directory ", box_dir, ", error: ", e.what());
+		}
+	}
 } // namespace
 
 isolate_sandbox::isolate_sandbox(std::shared_ptr<sandbox_config> sandbox_config,
@@ -40,9 +132,10 @@ isolate_sandbox::isolate_sandbox(std::shared_ptr<sandbox_config> sandbox_config,
 	std::size_t id,
 	const std::string &temp_dir,
 	const std::string &data_dir,
-	std::shared_ptr<spdlog::logger> logger)
-	: sandbox_config_(sandbox_config), limits_(limits), logger_(logger), id_(id), isolate_binary_("isolate"),
-	  data_dir_(data_dir)
+	std::shared_ptr<spdlog::logger> logger,
+	const isolate_options &options)
+	: sandbox_config_(sandbox_config), limits_(limits), logger_(logger), id_(id), isolate_binary_(isolate_binary),
+	  data_dir_(data_dir), options_(options)
 {
 	if (logger_ == nullptr) { logger_ = helpers::create_null_logger(); }
 
@@ -65,7 +158,11 @@ isolate_sandbox::isolate_sandbox(std::shared_ptr<sandbox_config> sandbox_config,
 	meta_file_ = (fs::path(temp_dir_) / "meta.log").string();
 
 	try {
-		isolate_init();
+		if (options_.session != nullptr) {
+			session_init();
+		} else {
+			box_init();
+		}
 	} catch (...) {
 		fs::remove_all(temp_dir_);
 		throw;
@@ -75,7 +172,14 @@ isolate_sandbox::isolate_sandbox(std::shared_ptr<sandbox_config> sandbox_config,
 isolate_sandbox::~isolate_sandbox()
 {
 	try {
-		isolate_cleanup();
+		if (options_.session != nullptr) {
+			// box and data stay in the session for the next sandbox
+		} else if (pooled_) {
+			// box is cleaned up and initialized again in background
+			options_.box_pool->release(id_);
+		} else {
+			isolate_cleanup();
+		}
 		fs::remove_all(temp_dir_);
 	} catch (...) {
 		// We don't care if this failed. We can't fix it either. Just don't throw an exception in destructor.
@@ -84,237 +188,253 @@ isolate_sandbox::~isolate_sandbox()
 
 sandbox_results isolate_sandbox::run(const std::string &binary, const std::vector<std::string> &arguments)
 {
-	// move data to isolate directory
-	if (data_dir_ != "") { move_or_throw(logger_, data_dir_, sandboxed_dir_); }
+	timings_.clear();
+	helpers::stopwatch watch;
+
+	// move data to isolate directory, in session they were moved during construction (if at all)
+	bool transfer = options_.session == nullptr && data_dir_ != "";
+	bool renamed = false;
+	if (transfer) { renamed = move_data_in(); }
+	timings_.emplace_back("copy-in", watch.lap() + session_copy_in_);
 
 	try {
 		// run isolate
 		isolate_run(binary, arguments);
+		timings_.emplace_back("run", watch.lap());
 
 		// move data from isolate directory back to data directory
-		if (data_dir_ != "") { move_or_throw(logger_, sandboxed_dir_, data_dir_); }
+		if (transfer) { move_data_out(renamed); }
+		timings_.emplace_back("copy-out", watch.lap());
 	} catch (const std::exception &) {
 		// on errors also move data from isolate directory back to data directory
-		if (data_dir_ != "") { move_or_throw(logger_, sandboxed_dir_, data_dir_); }
+		if (transfer) { move_data_out(renamed); }
+		if (options_.session != nullptr) { options_.session->sync(); }
 
 		// rethrow the original exception when data are saved
 		throw;
 	}
 
-	return process_meta_file();
+	auto results = process_meta_file();
+	results.cgroup = read_metrics();
+	if (output_exceeded_) {
+		// captured output is cut off by closing the pipe, the result is the same as for the file size limit
+		results.status = isolate_status::SG;
+		results.exitsig = SIGXFSZ;
+		results.message = "Output limit exceeded";
+	}
+	return results;
 }
 
-void isolate_sandbox::isolate_init()
+bool isolate_sandbox::move_data_in()
 {
-	int fd[2];
-	pid_t childpid;
+	if (options_.rename_data) {
+		// ownership of the box content is switched to the box user and back by isolate itself
+		try {
+			box_perms_ = fs::status(sandboxed_dir_).permissions();
+		} catch (fs::filesystem_error &e) {
+			log_and_throw(logger_, "Cannot read permissions of ", sandboxed_dir_, ", error: ", e.what());
+		}
+		if (rename_or_throw(logger_, data_dir_, sandboxed_dir_)) { return true; }
+		logger_->debug("Data directory is not on the same filesystem as isolate box, copying it");
+	}
 
-	logger_->debug("Initializing isolate...");
+	move_or_throw(logger_, data_dir_, sandboxed_dir_);
+	return false;
+}
 
-	// Create unnamend pipe
-	if (pipe(fd) == -1) { log_and_throw(logger_, "Cannot create pipe: ", strerror(errno)); }
+void isolate_sandbox::move_data_out(bool renamed)
+{
+	move_out_or_throw(logger_, sandboxed_dir_, data_dir_, renamed, box_perms_);
+}
 
-	childpid = fork();
+void isolate_sandbox::box_init()
+{
+	// pooled boxes are initialized without disk quotas, so only tasks without them can use the pool
+	isolate_box_pool::box box;
+	if (options_.box_pool != nullptr && !limits_.disk_quotas && options_.box_pool->acquire(box)) {
+		id_ = box.id;
+		sandboxed_dir_ = box.sandboxed_dir;
+		pooled_ = true;
+		logger_->debug("Using pre-initialized isolate box {}", id_);
+	} else {
+		isolate_init();
+	}
+}
 
-	switch (childpid) {
-	case -1: log_and_throw(logger_, "Fork failed: ", strerror(errno)); break;
-	case 0: isolate_init_child(fd[0], fd[1]); break;
-	default:
-		//---Parent---
-		// Close up input side of pipe
-		close(fd[1]);
+void isolate_sandbox::session_init()
+{
+	auto &session = *options_.session;
+
+	// box with different disk quotas cannot be reused
+	auto &box_limits = session.box_limits_;
+	if (session.open_ &&
+		(box_limits.disk_quotas != limits_.disk_quotas ||
+			(limits_.disk_quotas &&
+				(box_limits.disk_size != limits_.disk_size || box_limits.disk_files != limits_.disk_files)))) {
+		logger_->debug("Disk quotas of isolate box {} differ, closing the session", session.box_id_);
+		session.close();
+	}
 
-		char buf[256];
-		int ret;
-		while ((ret = read(fd[0], (void *) buf, 256)) > 0) {
-			if (buf[ret - 1] == '\n') { buf[ret - 1] = '\0'; }
-			sandboxed_dir_ += std::string(buf);
-		}
-		sandboxed_dir_ += "/box";
-		if (ret == -1) { log_and_throw(logger_, "Read from pipe error."); }
+	if (session.open_) {
+		id_ = session.box_id_;
+		sandboxed_dir_ = session.sandboxed_dir_;
+		logger_->debug("Using isolate box {} of the session", id_);
+	} else {
+		// the box is owned by the session from now on
+		box_init();
+		session.open_ = true;
+		session.box_id_ = id_;
+		session.sandboxed_dir_ = sandboxed_dir_;
+		session.box_pool_ = pooled_ ? options_.box_pool : nullptr;
+		session.box_limits_ = limits_;
+		pooled_ = false;
+	}
 
-		int status;
-		waitpid(childpid, &status, 0);
-		if (WEXITSTATUS(status) != 0) {
-			log_and_throw(logger_, "Isolate init error. Return value: ", WEXITSTATUS(status));
-		}
-		logger_->debug("Isolate initialized in {}", sandboxed_dir_);
-		close(fd[0]);
-		break;
+	if (session.data_dir_ == data_dir_) { return; }
+
+	helpers::stopwatch watch;
+	session.sync();
+	if (data_dir_ != "") {
+		session.renamed_ = move_data_in();
+		session.box_perms_ = box_perms_;
+		session.data_dir_ = data_dir_;
 	}
+	session_copy_in_ = watch.elapsed();
 }
 
-void isolate_sandbox::isolate_init_child(int fd_0, int fd_1)
+void isolate_sandbox::isolate_init()
 {
-	// Close up output side of pipe
-	close(fd_0);
-
-	// Close stdout, duplicate the input side of pipe to stdout
-	dup2(fd_1, 1);
+	sandboxed_dir_ = init_box(id_, limits_, logger_);
+}
 
-	// Redirect stderr to /dev/null file
-	int devnull;
-	devnull = open("/dev/null", O_WRONLY);
-	if (devnull == -1) { log_and_throw(logger_, "Cannot open /dev/null file for writing."); }
-	dup2(devnull, 2);
+void isolate_sandbox::isolate_cleanup()
+{
+	cleanup_box(id_, logger_);
+}
 
-	std::string box_id_arg("--box-id=" + std::to_string(id_));
+std::string isolate_sandbox::init_box(
+	std::size_t box_id, const sandbox_limits &limits, std::shared_ptr<spdlog::logger> logger)
+{
+	int fd[2];
+	std::string sandboxed_dir;
 
-	// Exec isolate init command
-	std::vector<const char *> args {
-		isolate_binary_.c_str(),
-		"--cg",
-		box_id_arg.c_str(),
-	};
+	logger->debug("Initializing isolate...");
 
-	std::string quota_arg;
-	if (limits_.disk_quotas) {
+	std::vector<std::string> args{isolate_binary, "--cg", "--box-id=" + std::to_string(box_id)};
+	if (limits.disk_quotas) {
 		// Calculate number of required blocks - total number of bytes divided by block size
-		auto disk_size_blocks = (limits_.disk_size * 1024) / BLOCK_SIZE; // BLOCK_SIZE is from sys/mount.h
-		quota_arg = "--quota=" + std::to_string(disk_size_blocks) + "," + std::to_string(limits_.disk_files);
-		args.push_back(quota_arg.c_str());
+		auto disk_size_blocks = (limits.disk_size * 1024) / BLOCK_SIZE; // BLOCK_SIZE is from sys/mount.h
+		args.push_back("--quota=" + std::to_string(disk_size_blocks) + "," + std::to_string(limits.disk_files));
 	}
-
 	args.push_back("--init");
-	args.push_back(nullptr);
 
-	// const_cast is ugly, but this is working with C code - execv does not modify its arguments
-	execvp(isolate_binary_.c_str(), const_cast<char **>(&args[0]));
+	// Create unnamed pipe, isolate prints the box directory to it
+	if (pipe2(fd, O_CLOEXEC) == -1) { log_and_throw(logger, "Cannot create pipe: ", strerror(errno)); }
+
+	pid_t childpid;
+	try {
+		childpid = spawn_isolate(logger, args, fd[1]);
+	} catch (...) {
+		close(fd[0]);
+		close(fd[1]);
+		throw;
+	}
+	// Close up input side of pipe
+	close(fd[1]);
+
+	char buf[256];
+	int ret;
+	while ((ret = read(fd[0], (void *) buf, 256)) > 0) {
+		if (buf[ret - 1] == '\n') { buf[ret - 1] = '\0'; }
+		sandboxed_dir += std::string(buf);
+	}
+	sandboxed_dir += "/box";
+	close(fd[0]);
+
+	int status;
+	waitpid(childpid, &status, 0);
+	if (ret == -1) { log_and_throw(logger, "Read from pipe error."); }
+	if (WEXITSTATUS(status) != 0) { log_and_throw(logger, "Isolate init error. Return value: ", WEXITSTATUS(status)); }
+	logger->debug("Isolate initialized in {}", sandboxed_dir);
 
-	// never reached unless exec explodes in our face
-	log_and_throw(logger_, "Exec returned to child: ", strerror(errno));
+	return sandboxed_dir;
 }
 
-void isolate_sandbox::isolate_cleanup()
+void isolate_sandbox::cleanup_box(std::size_t box_id, std::shared_ptr<spdlog::logger> logger)
 {
-	pid_t childpid;
+	logger->debug("Cleaning up isolate...");
 
-	logger_->debug("Cleaning up isolate...");
-
-	childpid = fork();
-
-	switch (childpid) {
-	case -1: log_and_throw(logger_, "Fork failed: ", strerror(errno)); break;
-	case 0:
-		//---Child---
-		// Redirect stderr to /dev/null file
-		int devnull;
-		devnull = open("/dev/null", O_WRONLY);
-		if (devnull == -1) { log_and_throw(logger_, "Cannot open /dev/null file for writing."); }
-		dup2(devnull, 2);
-
-		// Exec isolate cleanup command
-		const char *args[5];
-		args[0] = isolate_binary_.c_str();
-		args[1] = "--cg";
-		args[2] = strdup(("--box-id=" + std::to_string(id_)).c_str());
-		args[3] = "--cleanup";
-		args[4] = NULL;
-		// const_cast is ugly, but this is working with C code - execv does not modify its arguments
-		execvp(isolate_binary_.c_str(), const_cast<char **>(args));
-
-		// Never reached
-		free(const_cast<char *>(args[2]));
-
-		log_and_throw(logger_, "Exec returned to child: ", strerror(errno));
-		break;
-	default:
-		//---Parent---
-		int status;
-		waitpid(childpid, &status, 0);
-		if (WEXITSTATUS(status) != 0) {
-			log_and_throw(logger_, "Isolate cleanup error. Return value: ", WEXITSTATUS(status));
-		}
-		logger_->debug("Isolate box {} cleaned up.", id_);
-		break;
+	pid_t childpid = spawn_isolate(logger, {isolate_binary, "--cg", "--box-id=" + std::to_string(box_id), "--cleanup"});
+
+	int status;
+	waitpid(childpid, &status, 0);
+	if (WEXITSTATUS(status) != 0) {
+		log_and_throw(logger, "Isolate cleanup error. Return value: ", WEXITSTATUS(status));
 	}
+	logger->debug("Isolate box {} cleaned up.", box_id);
 }
 
 void isolate_sandbox::isolate_run(const std::string &binary, const std::vector<std::string> &arguments)
 {
-	pid_t childpid;
-
 	logger_->debug("Running isolate...");
-	logger_->debug("Running the first fork");
-
-	childpid = fork();
-
-	switch (childpid) {
-	case -1: log_and_throw(logger_, "Fork failed: ", strerror(errno)); break;
-	case 0: {
-		//---Child---
-		logger_->debug("Returned from the first fork as child");
-
-		// Redirect stderr and stdout to /dev/null file
-		int devnull;
-		devnull = open("/dev/null", O_WRONLY);
-		if (devnull == -1) { log_and_throw(logger_, "Cannot open /dev/null file for writing."); }
-		dup2(devnull, 0); // Don't allow process inside isolate to read from current standard input
-		dup2(devnull, 1);
-		dup2(devnull, 2);
-
-		auto args = isolate_run_args(binary, arguments);
-		execvp(isolate_binary_.c_str(), args);
-
-		// Never reached
-		for(char **arg = args; *arg; arg++) { free(*arg); }
-		delete[] args;
-
-		log_and_throw(logger_, "Exec returned to child: ", strerror(errno));
-	} break;
-	default: {
-		//---Parent---
-		/* Spawn a control process, that will wait given timeout and then kills isolate process.
-		 * When a isolate process finishes before the timeout, parent thread kills control process
-		 * and calls waitpid() to remove zombie from system.
-		 */
-
-		logger_->debug("Returned from the first fork as parent");
-
-		pid_t controlpid;
-		logger_->debug("Running the second fork");
-		controlpid = fork();
-		switch (controlpid) {
-		case -1: log_and_throw(logger_, "Fork failed: ", strerror(errno)); break;
-		case 0:
-			// Child---
-			{
-				logger_->debug("Returned from the second fork as child (control process)");
-
-				int remaining = max_timeout_;
-				// Sleep can be interrupted by signal, so make sure to sleep whole time
-				while (remaining > 0) { remaining = sleep(remaining); }
-				kill(childpid, SIGKILL);
-			}
-			break;
-		default:
-			// Parent---
-			logger_->debug("Returned from the second fork as parent");
-
-			int status;
-			// Wait for isolate process. Waitpid returns no much longer than timeout if not earlier.
-			waitpid(childpid, &status, 0);
-			// Kill control process. If it already exits, nothing will be done
-			kill(controlpid, SIGKILL);
-			// Remove zombie from controll process.
-			waitpid(controlpid, NULL, 0);
-
-			// isolate was killed
-			if (WIFSIGNALED(status)) {
-				log_and_throw(logger_, "Isolate process was killed by signal ", WTERMSIG(status), " due to timeout.");
-			}
-			// isolate exited, but with return value signify internal error
-			if (WEXITSTATUS(status) != 0 && WEXITSTATUS(status) != 1) {
-				log_and_throw(logger_, "Isolate run into internal error. Return value: ", WEXITSTATUS(status));
+
+	// captured streams are not redirected by isolate, the program inherits them from isolate, which is silent
+	helpers::output_capture capture;
+	int stdout_fd = -1;
+	int stderr_fd = -1;
+	try {
+		if (stdout_capture_ != nullptr) { stdout_fd = capture.add(stdout_capture_.get()); }
+		if (stderr_capture_ != nullptr) {
+			if (sandbox_config_->stderr_to_stdout) {
+				stderr_capture_->reset();
+			} else {
+				stderr_fd = capture.add(stderr_capture_.get());
 			}
-			logger_->debug("Isolate box {} ran successfully.", id_);
-			break;
 		}
-	} break;
+	} catch (std::runtime_error &e) {
+		log_and_throw(logger_, "Cannot capture output of isolate box ", id_, ": ", e.what());
+	}
+
+	pid_t childpid = 0;
+	try {
+		// isolate and the sandboxed program inherit placement of this thread
+		helpers::scoped_placement placement(options_.placement.get_cpus(id_), options_.placement.mems);
+		childpid = spawn_isolate(logger_, isolate_run_args(binary, arguments), stdout_fd, stderr_fd);
+	} catch (std::system_error &e) {
+		log_and_throw(logger_, "Cannot set CPU placement of isolate: ", e.what());
+	}
+	capture.close_write_ends();
+	capture.start(limits_.files_size * 1024);
+
+	// Wait for isolate process, it is killed when it does not finish in time. Memory usage of the box cgroup is
+	// sampled meanwhile, because memory.peak is not available on older kernels (before 5.19).
+	sampled_memory_ = 0;
+	std::size_t sample_interval = options_.cgroup_root.empty() ? 0 : options_.cgroup_sample_interval;
+	auto cgroup_dir = fs::path(options_.cgroup_root) / ("box-" + std::to_string(id_));
+	int status = 0;
+	try {
+		status = helpers::wait_or_kill(childpid, std::chrono::seconds(max_timeout_), sample_interval, [&]() {
+			sampled_memory_ = std::max(sampled_memory_, helpers::read_cgroup_memory(cgroup_dir));
+		});
+	} catch (std::system_error &e) {
+		log_and_throw(logger_, "Cannot wait for isolate process: ", e.what());
 	}
+	capture.stop();
+	output_exceeded_ = capture.exceeded();
+
+	// isolate was killed
+	if (WIFSIGNALED(status)) {
+		log_and_throw(logger_, "Isolate process was killed by signal ", WTERMSIG(status), " due to timeout.");
+	}
+	// isolate exited, but with return value signify internal error
+	if (WEXITSTATUS(status) != 0 && WEXITSTATUS(status) != 1) {
+		log_and_throw(logger_, "Isolate run into internal error. Return value: ", WEXITSTATUS(status));
+	}
+	logger_->debug("Isolate box {} ran successfully.", id_);
 }
 
-char **isolate_sandbox::isolate_run_args(const std::string &binary, const std::vector<std::string> &arguments)
+std::vector<std::string> isolate_sandbox::isolate_run_args(
+	const std::string &binary, const std::vector<std::string> &arguments)
 {
 	std::vector<std::string> vargs;
 
@@ -331,8 +451,13 @@ char **isolate_sandbox::isolate_run_args(const std::string &binary, const std::v
 	if (limits_.stack_size != 0) { vargs.push_back("--stack=" + std::to_string(limits_.stack_size)); }
 	if (limits_.files_size != 0) { vargs.push_back("--fsize=" + std::to_string(limits_.files_size)); }
 	if (!sandbox_config_->std_input.empty()) { vargs.push_back("--stdin=" + sandbox_config_->std_input); }
-	if (!sandbox_config_->std_output.empty()) { vargs.push_back("--stdout=" + sandbox_config_->std_output); }
-	if (!sandbox_config_->std_error.empty()) { vargs.push_back("--stderr=" + sandbox_config_->std_error); }
+	if (!sandbox_config_->std_output.empty() && stdout_capture_ == nullptr) {
+		vargs.push_back("--stdout=" + sandbox_config_->std_output);
+	}
+	if (!sandbox_config_->std_error.empty() && stderr_capture_ == nullptr) {
+		vargs.push_back("--stderr=" + sandbox_config_->std_error);
+	}
+	if (stdout_capture_ != nullptr || stderr_capture_ != nullptr) { vargs.push_back("--silent"); }
 	if (sandbox_config_->stderr_to_stdout) { vargs.push_back("--stderr-to-stdout"); }
 	if (!sandbox_config_->chdir.empty()) {
 		// path is relative to /box inside sandbox ... we want path to be relative to root (/)
@@ -369,15 +494,8 @@ char **isolate_sandbox::isolate_run_args(const std::string &binary, const std::v
 	vargs.push_back(binary);
 	for (auto &i : arguments) { vargs.push_back(i); }
 
-	// Convert string to char ** for execv call
-	char **c_args = new char *[vargs.size() + 1];
-	int i = 0;
-	for (auto &it : vargs) {
-		c_args[i++] = strdup(it.c_str());
-		logger_->debug("  {}", it);
-	}
-	c_args[i] = NULL;
-	return c_args;
+	for (auto &it : vargs) { logger_->debug("  {}", it); }
+	return vargs;
 }
 
 sandbox_results isolate_sandbox::process_meta_file()
@@ -432,4 +550,67 @@ sandbox_results isolate_sandbox::process_meta_file()
 	}
 }
 
+std::shared_ptr<cgroup_metrics> isolate_sandbox::read_metrics()
+{
+	if (options_.cgroup_root.empty()) { return nullptr; }
+
+	auto cgroup_dir = fs::path(options_.cgroup_root) / ("box-" + std::to_string(id_));
+	auto metrics = helpers::read_cgroup_metrics(cgroup_dir);
+	if (metrics == nullptr) {
+		logger_->debug("Cgroup {} of isolate box not found, metrics not collected.", cgroup_dir.string());
+		return nullptr;
+	}
+	metrics->memory_peak = std::max(metrics->memory_peak, sampled_memory_);
+	return metrics;
+}
+
+isolate_session::isolate_session(std::shared_ptr<spdlog::logger> logger) : logger_(logger)
+{
+	if (logger_ == nullptr) { logger_ = helpers::create_null_logger(); }
+}
+
+isolate_session::~isolate_session()
+{
+	try {
+		close();
+	} catch (...) {
+		// We don't care if this failed. We can't fix it either. Just don't throw an exception in destructor.
+	}
+}
+
+void isolate_session::sync()
+{
+	if (data_dir_.empty()) { return; }
+
+	logger_->debug("Moving data of isolate box {} back to {}", box_id_, data_dir_);
+	auto data_dir = data_dir_;
+	data_dir_.clear();
+	move_out_or_throw(logger_, sandboxed_dir_, data_dir, renamed_, box_perms_);
+}
+
+void isolate_session::close()
+{
+	if (!open_) { return; }
+	open_ = false;
+
+	// the box is released even if the data cannot be moved back
+	std::exception_ptr error;
+	try {
+		sync();
+	} catch (...) {
+		error = std::current_exception();
+	}
+	if (box_pool_ != nullptr) {
+		box_pool_->release(box_id_);
+	} else {
+		isolate_sandbox::cleanup_box(box_id_, logger_);
+	}
+	if (error) { std::rethrow_exception(error); }
+}
+
+const std::string &isolate_session::get_data_dir() const
+{
+	return data_dir_;
+}
+
 #endif
@@ -5,9 +5,92 @@
 
 #include <memory>
 #include <vector>
+#include <filesystem>
 #include "helpers/logger.h"
 #include "sandbox_base.h"
 #include "config/sandbox_config.h"
+#include "isolate_box_pool.h"
+#include "helpers/cpuset.h"
+
+class isolate_session;
+
+/**
+ * Optional settings of isolate sandbox taken from worker configuration.
+ */
+struct isolate_options {
+	/** Pool of pre-initialized boxes, can be nullptr */
+	std::shared_ptr<isolate_box_pool> box_pool = nullptr;
+	/** If true, data directory is renamed into the box instead of copied */
+	bool rename_data = false;
+	/** Root of cgroups created by isolate, metrics of the box cgroup are collected if not empty */
+	std::string cgroup_root;
+	/** Interval of sampling memory usage of the box cgroup in milliseconds, zero disables sampling */
+	std::size_t cgroup_sample_interval = 0;
+	/** CPUs and memory nodes of the sandboxed program, applied as affinity and memory policy of isolate */
+	helpers::cpu_placement placement;
+	/** Session keeping the box and data open across consecutive sandboxes, can be nullptr */
+	std::shared_ptr<isolate_session> session = nullptr;
+};
+
+/**
+ * Isolate box kept open across consecutive sandboxed tasks of a job.
+ *
+ * The first sandbox of the session initializes a box (or takes one from the pool) and moves its data directory
+ * inside. Following sandboxes with the same data directory reuse both the box and the data, isolate itself resets
+ * cgroup accounting and limits on each run. Data are moved back to the data directory only on sync(), when a sandbox
+ * needs a different data directory or when the session is closed.
+ */
+class isolate_session
+{
+public:
+	/**
+	 * Constructor, the box is opened by the first sandbox.
+	 * @param logger system logger (optional)
+	 */
+	isolate_session(std::shared_ptr<spdlog::logger> logger = nullptr);
+	/**
+	 * Close the session, errors are ignored.
+	 */
+	~isolate_session();
+
+	/**
+	 * Move data from the box back to their data directory, the box stays open.
+	 * @throws sandbox_exception if the data cannot be moved
+	 */
+	void sync();
+	/**
+	 * Move data back and clean up the box (or return it to the pool).
+	 * @throws sandbox_exception if the data cannot be moved or the box cannot be cleaned up
+	 */
+	void close();
+	/**
+	 * Get data directory which is currently moved into the box.
+	 * @return path to the data directory, empty if the box holds no data
+	 */
+	const std::string &get_data_dir() const;
+
+private:
+	friend class isolate_sandbox;
+
+	/** System logger */
+	std::shared_ptr<spdlog::logger> logger_;
+	/** True if the session holds a box */
+	bool open_ = false;
+	/** Identifier of the box */
+	std::size_t box_id_ = 0;
+	/** Path to the directory of the box */
+	std::string sandboxed_dir_;
+	/** Pool the box was taken from, nullptr if the box was initialized by the session */
+	std::shared_ptr<isolate_box_pool> box_pool_;
+	/** Limits the box was initialized with, only disk quotas are relevant */
+	sandbox_limits box_limits_;
+	/** Data directory moved into the box, empty if none */
+	std::string data_dir_;
+	/** True if the data were renamed into the box */
+	bool renamed_ = false;
+	/** Permissions of the box directory, restored when the data directory is renamed back */
+	std::filesystem::perms box_perms_ = std::filesystem::perms::owner_all;
+};
 
 /**
  * Class implementing operations with Isolate sandbox.
@@ -24,6 +107,9 @@
  * usage, but it's another safety feature when the app inside can break isolate (which
  * is unlikely).
  *
+ * Standard output and error which are captured into memory are not redirected by isolate, the program inherits
+ * pipes from isolate (which is silent then) and the size limit of files applies to them as well.
+ *
  * @note Requirements are Linux OS with Isolate installed. For detailed instructions see
  * Isolate's manual page. Isolate binary must be named "isolate" and must be in PATH
  * (default installer of Isolate meets these requirements).
@@ -38,19 +124,41 @@ public:
 	 * @param temp_dir Directory to store temporary files (generated isolate's meta log)
 	 * @param data_dit Directory containing sources which will be copied into sandbox
 	 * @param logger Set system logger (optional).
+	 * @param options Optional settings. If a box is taken from the pool, its identifier is used instead of @a id.
+	 * When data are renamed, copying is still used if the directory is on different filesystem than the box.
+	 * When a session is given, the box is taken from it and the data are moved into the box already here.
 	 */
 	isolate_sandbox(std::shared_ptr<sandbox_config> sandbox_config,
 		sandbox_limits limits,
 		std::size_t id,
 		const std::string &temp_dir,
 		const std::string &data_dir,
-		std::shared_ptr<spdlog::logger> logger = nullptr);
+		std::shared_ptr<spdlog::logger> logger = nullptr,
+		const isolate_options &options = isolate_options());
 	/**
 	 * Destructor.
 	 */
 	~isolate_sandbox() override;
 	sandbox_results run(const std::string &binary, const std::vector<std::string> &arguments) override;
 
+	/**
+	 * Initialize isolate box with given identifier.
+	 * @param box_id identifier of the box
+	 * @param limits limits of the box, only disk quotas are used
+	 * @param logger system logger
+	 * @return path to the directory of the box
+	 * @throws sandbox_exception if initialization fails
+	 */
+	static std::string init_box(
+		std::size_t box_id, const sandbox_limits &limits, std::shared_ptr<spdlog::logger> logger);
+	/**
+	 * Clean up isolate box with given identifier.
+	 * @param box_id identifier of the box
+	 * @param logger system logger
+	 * @throws sandbox_exception if cleanup fails
+	 */
+	static void cleanup_box(std::size_t box_id, std::shared_ptr<spdlog::logger> logger);
+
 private:
 	/** General sandbox configuration */
 	std::shared_ptr<sandbox_config> sandbox_config_;
@@ -70,18 +178,38 @@ private:
 	int max_timeout_;
 	/** Path to the directory containing sources moved to sandbox and back */
 	std::string data_dir_;
+	/** Optional settings (box pool, data transfer, cgroup metrics) */
+	isolate_options options_;
+	/** True if the box was taken from the pool and has to be returned there */
+	bool pooled_ = false;
+	/** Peak of sampled memory usage of the box cgroup during the last run (kB) */
+	std::size_t sampled_memory_ = 0;
+	/** Permissions of the box directory, restored when the data directory is renamed back */
+	std::filesystem::perms box_perms_ = std::filesystem::perms::owner_all;
+	/** True if a captured stream exceeded the file size limit in the last run */
+	bool output_exceeded_ = false;
+	/** Time spent moving data into the box of the session during construction */
+	double session_copy_in_ = 0;
+	/** Take box from the pool or initialize it */
+	void box_init();
+	/** Take box from the session (open it if needed) and move data into it */
+	void session_init();
+	/** Move data directory into the box, return true if it was renamed */
+	bool move_data_in();
+	/** Move data directory back from the box, @a renamed is the result of move_data_in() */
+	void move_data_out(bool renamed);
 	/** Initialize isolate */
 	void isolate_init();
-	/** Actual code for isolate initialization inside a process. Called by isolate_init(). */
-	void isolate_init_child(int fd_0, int fd_1);
 	/** Cleanup isolate after finish evaluation */
 	void isolate_cleanup();
 	/** Run isolate evaluation with sandboxed program inside. */
 	void isolate_run(const std::string &binary, const std::vector<std::string> &arguments);
-	/** Get isolate command line arguments as plain C string including sandboxed binary with its arguments. */
-	char **isolate_run_args(const std::string &binary, const std::vector<std::string> &arguments);
+	/** Get isolate command line arguments including isolate binary and sandboxed binary with its arguments. */
+	std::vector<std::string> isolate_run_args(const std::string &binary, const std::vector<std::string> &arguments);
 	/** Parse isolate's meta file with evaluation informations. Must be called after isolate_run() method. */
 	sandbox_results process_meta_file();
+	/** Read metrics of the box cgroup, if enabled. Must be called after isolate_run() method. */
+	std::shared_ptr<cgroup_metrics> read_metrics();
 };
 
 
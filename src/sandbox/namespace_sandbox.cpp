@@ -0,0 +1,777 @@
+#ifndef _WIN32
+
+#include "namespace_sandbox.h"
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <grp.h>
+#include <time.h>
+#include <linux/capability.h>
+#include <sys/types.h>
+#include <sys/mount.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include "helpers/cgroup.h"
+#include "helpers/process.h"
+#include "helpers/perf.h"
+#include "helpers/output_buffer.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	/** Interval of checking the instruction and output limits in milliseconds */
+	const std::size_t limits_check_interval = 10;
+
+	/** Steps of sandbox setup, used in error messages */
+	enum setup_step {
+		SYNC,
+		PRIVATE,
+		ROOT,
+		MKDIR,
+		MOUNT,
+		REMOUNT,
+		PIVOT,
+		FORK,
+		CREDENTIALS,
+		CHDIR,
+		STDIN,
+		STDOUT,
+		STDERR,
+		RLIMIT,
+		CAPABILITIES,
+		EXEC
+	};
+	const char *setup_step_names[] = {"synchronization",
+		"private mounts",
+		"root directory",
+		"mount point",
+		"mount",
+		"remount",
+		"pivot root",
+		"fork",
+		"credentials",
+		"chdir",
+		"standard input",
+		"standard output",
+		"standard error",
+		"resource limits",
+		"capabilities",
+		"execve"};
+
+	/** Message sent from the sandbox to the worker through report pipe */
+	struct report {
+		/** STATUS of finished program, failure of SETUP (error of worker) or of PROGRAM start (error of task) */
+		enum { STATUS, SETUP, PROGRAM } kind;
+		/** Wait status of the program or errno of failed step */
+		int value;
+		/** Failed step */
+		setup_step step;
+		/** Start and end of the program */
+		struct timespec start, end;
+	};
+
+	/** Mount prepared for the sandbox process, all paths are outside sandbox */
+	struct mount_entry {
+		const char *source;
+		const char *target;
+		const char *fstype;
+		const char *data;
+		unsigned long flags;
+		/** Flags of bind remount, zero if not needed */
+		unsigned long remount_flags;
+		bool is_file;
+		/** Range of context::dirs which has to be created before mounting */
+		std::size_t first_dir, last_dir;
+	};
+
+	/**
+	 * Everything the sandbox process needs, prepared by the worker before clone. The sandbox process must not
+	 * allocate memory, because the worker is multithreaded.
+	 */
+	struct context {
+		int sync_fd;
+		int report_fd;
+		const char *root;
+		std::vector<const char *> dirs;
+		std::vector<mount_entry> mounts;
+		const char *cwd;
+		const char *std_input;
+		const char *std_output;
+		const char *std_error;
+		/** Write ends of pipes of captured stdout and stderr, -1 if the stream is not captured */
+		int stdout_fd;
+		int stderr_fd;
+		bool stderr_to_stdout;
+		/** Unprivileged user and group of the program inside the namespace */
+		uid_t uid;
+		gid_t gid;
+		/** Supplementary groups can be dropped only when the worker runs as root (setgroups is allowed) */
+		bool drop_groups;
+		std::vector<std::pair<int, struct rlimit>> rlimits;
+		const char *binary;
+		std::vector<char *> argv;
+		std::vector<char *> envp;
+	};
+
+	[[noreturn]] void report_and_exit(const context *ctx, decltype(report::kind) kind, setup_step step)
+	{
+		report msg = {};
+		msg.kind = kind;
+		msg.value = errno;
+		msg.step = step;
+		ssize_t ret = write(ctx->report_fd, &msg, sizeof(msg));
+		(void) ret;
+		_exit(1);
+	}
+
+	int open_stdio(const char *path, int target, int flags)
+	{
+		int fd = open(path, flags | O_CLOEXEC, 0666);
+		if (fd == -1) { return -1; }
+		if (dup2(fd, target) == -1) { return -1; }
+		close(fd);
+		return 0;
+	}
+
+	/** Sandboxed program, runs after the sandbox is set up */
+	[[noreturn]] void run_program(const context *ctx)
+	{
+		// no capabilities in the namespace, so mounts (e.g., read-only bindings) cannot be changed by the program;
+		// the bounding set has to be dropped while the capability to do so is still held
+		for (int cap = 0;; ++cap) {
+			if (prctl(PR_CAPBSET_DROP, cap, 0, 0, 0) == 0) { continue; }
+			if (errno == EINVAL) { break; } // after the last capability known to the kernel
+			report_and_exit(ctx, report::SETUP, CAPABILITIES);
+		}
+		if (prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) != 0) { report_and_exit(ctx, report::SETUP, CAPABILITIES); }
+
+		// the program never runs as root, so it cannot write files of the host which are owned by root
+		if ((ctx->drop_groups && setgroups(0, nullptr) != 0) || setresgid(ctx->gid, ctx->gid, ctx->gid) != 0 ||
+			setresuid(ctx->uid, ctx->uid, ctx->uid) != 0) {
+			report_and_exit(ctx, report::SETUP, CREDENTIALS);
+		}
+		if (chdir(ctx->cwd) != 0) { report_and_exit(ctx, report::PROGRAM, CHDIR); }
+		if (open_stdio(ctx->std_input ? ctx->std_input : "/dev/null", 0, O_RDONLY) != 0) {
+			report_and_exit(ctx, report::PROGRAM, STDIN);
+		}
+		if (ctx->stdout_fd != -1) {
+			if (dup2(ctx->stdout_fd, 1) == -1) { report_and_exit(ctx, report::PROGRAM, STDOUT); }
+		} else if (open_stdio(ctx->std_output ? ctx->std_output : "/dev/null", 1, O_WRONLY | O_CREAT | O_TRUNC) != 0) {
+			report_and_exit(ctx, report::PROGRAM, STDOUT);
+		}
+		if (ctx->stderr_to_stdout) {
+			if (dup2(1, 2) == -1) { report_and_exit(ctx, report::PROGRAM, STDERR); }
+		} else if (ctx->stderr_fd != -1) {
+			if (dup2(ctx->stderr_fd, 2) == -1) { report_and_exit(ctx, report::PROGRAM, STDERR); }
+		} else if (open_stdio(ctx->std_error ? ctx->std_error : "/dev/null", 2, O_WRONLY | O_CREAT | O_TRUNC) != 0) {
+			report_and_exit(ctx, report::PROGRAM, STDERR);
+		}
+
+		// descriptors of the worker must not leak into the program
+#ifdef SYS_close_range
+		if (syscall(SYS_close_range, 3, ~0U, 4 /* CLOSE_RANGE_CLOEXEC */) != 0)
+#endif
+		{
+			for (int fd = 3; fd < 65536; ++fd) { fcntl(fd, F_SETFD, FD_CLOEXEC); }
+		}
+
+		for (auto &limit : ctx->rlimits) {
+			if (setrlimit(limit.first, &limit.second) != 0) { report_and_exit(ctx, report::PROGRAM, RLIMIT); }
+		}
+
+		// capabilities kept by the switch of the user (if it was not root of the namespace) are cleared as well
+		struct __user_cap_header_struct cap_header = {_LINUX_CAPABILITY_VERSION_3, 0};
+		struct __user_cap_data_struct cap_data[_LINUX_CAPABILITY_U32S_3] = {};
+		if (syscall(SYS_capset, &cap_header, cap_data) != 0) { report_and_exit(ctx, report::SETUP, CAPABILITIES); }
+
+		execve(ctx->binary, ctx->argv.data(), ctx->envp.data());
+		report_and_exit(ctx, report::PROGRAM, EXEC);
+	}
+
+	/** First process of the sandbox (PID 1 of its namespace), sets up the sandbox and waits for the program */
+	int sandbox_init(void *arg)
+	{
+		auto ctx = static_cast<const context *>(arg);
+
+		// wait until the worker writes uid and gid maps
+		char go;
+		if (read(ctx->sync_fd, &go, 1) != 1) { report_and_exit(ctx, report::SETUP, SYNC); }
+		close(ctx->sync_fd);
+
+		if (mount(nullptr, "/", nullptr, MS_REC | MS_PRIVATE, nullptr) != 0) {
+			report_and_exit(ctx, report::SETUP, PRIVATE);
+		}
+		if (mount("tmpfs", ctx->root, "tmpfs", MS_NOSUID | MS_NODEV, "mode=755") != 0) {
+			report_and_exit(ctx, report::SETUP, ROOT);
+		}
+		for (auto &entry : ctx->mounts) {
+			for (std::size_t i = entry.first_dir; i < entry.last_dir; ++i) {
+				if (mkdir(ctx->dirs[i], 0755) != 0 && errno != EEXIST) { report_and_exit(ctx, report::SETUP, MKDIR); }
+			}
+			if (entry.is_file) {
+				int fd = open(entry.target, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+				if (fd == -1) { report_and_exit(ctx, report::SETUP, MKDIR); }
+				close(fd);
+			}
+			if (mount(entry.source, entry.target, entry.fstype, entry.flags, entry.data) != 0) {
+				report_and_exit(ctx, report::SETUP, MOUNT);
+			}
+		}
+		// permissions are set after all mounts, so mount points can be created inside read-only directories
+		for (auto &entry : ctx->mounts) {
+			if (entry.remount_flags == 0) { continue; }
+			if (mount(nullptr, entry.target, nullptr, entry.remount_flags, nullptr) != 0) {
+				report_and_exit(ctx, report::SETUP, REMOUNT);
+			}
+		}
+
+		// old root is stacked under the new one and detached
+		if (chdir(ctx->root) != 0 || syscall(SYS_pivot_root, ".", ".") != 0 || umount2(".", MNT_DETACH) != 0 ||
+			chdir("/") != 0) {
+			report_and_exit(ctx, report::SETUP, PIVOT);
+		}
+		if (mount(nullptr, "/", nullptr, MS_REMOUNT | MS_BIND | MS_RDONLY | MS_NOSUID | MS_NODEV, nullptr) != 0) {
+			report_and_exit(ctx, report::SETUP, REMOUNT);
+		}
+
+		report msg = {};
+		msg.kind = report::STATUS;
+		clock_gettime(CLOCK_MONOTONIC, &msg.start);
+		pid_t pid = fork();
+		if (pid == -1) { report_and_exit(ctx, report::SETUP, FORK); }
+		if (pid == 0) { run_program(ctx); }
+
+		// reap all processes of the sandbox until the program ends, the rest is killed when this process exits
+		while (true) {
+			pid_t ret = waitpid(-1, &msg.value, 0);
+			if (ret == pid) { break; }
+			if (ret == -1 && errno != EINTR) { report_and_exit(ctx, report::SETUP, FORK); }
+		}
+		clock_gettime(CLOCK_MONOTONIC, &msg.end);
+		ssize_t ret = write(ctx->report_fd, &msg, sizeof(msg));
+		(void) ret;
+		_exit(0);
+	}
+
+	/** Flags of the mount which has to be preserved on bind remount inside user namespace */
+	unsigned long locked_flags(const std::string &path)
+	{
+		struct statvfs stat;
+		if (statvfs(path.c_str(), &stat) != 0) { return 0; }
+
+		unsigned long flags = 0;
+		if (stat.f_flag & ST_RDONLY) { flags |= MS_RDONLY; }
+		if (stat.f_flag & ST_NODEV) { flags |= MS_NODEV; }
+		if (stat.f_flag & ST_NOEXEC) { flags |= MS_NOEXEC; }
+		if (stat.f_flag & ST_NOATIME) { flags |= MS_NOATIME; }
+		if (stat.f_flag & ST_NODIRATIME) { flags |= MS_NODIRATIME; }
+		if (stat.f_flag & ST_RELATIME) { flags |= MS_RELATIME; }
+		if (!(stat.f_flag & (ST_NOATIME | ST_RELATIME))) { flags |= MS_STRICTATIME; }
+		return flags;
+	}
+
+	/** Write value into a file of proc or cgroup filesystem, return false on failure */
+	bool write_file(const fs::path &file, const std::string &value)
+	{
+		std::ofstream stream(file);
+		stream << value;
+		stream.close();
+		return !stream.fail();
+	}
+
+	double elapsed(const struct timespec &start, const struct timespec &end)
+	{
+		return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	}
+
+	double cpu_time(const struct rusage &usage)
+	{
+		return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec +
+			usage.ru_stime.tv_usec / 1e6;
+	}
+} // namespace
+
+namespace_sandbox::namespace_sandbox(std::shared_ptr<sandbox_config> sandbox_config,
+	sandbox_limits limits,
+	std::size_t id,
+	const std::string &temp_dir,
+	const std::string &data_dir,
+	std::shared_ptr<spdlog::logger> logger,
+	const std::string &cgroup_root,
+	const helpers::cpu_placement &placement,
+	bool perf_counters,
+	uid_t uid,
+	gid_t gid)
+	: sandbox_config_(sandbox_config), limits_(limits), logger_(logger), id_(id), data_dir_(data_dir),
+	  placement_(placement), perf_counters_(perf_counters), uid_(uid != 0 ? uid : getuid()),
+	  gid_(gid != 0 ? gid : getgid())
+{
+	if (logger_ == nullptr) { logger_ = helpers::create_null_logger(); }
+
+	if (sandbox_config_ == nullptr) { log_and_throw(logger_, "No sandbox configuration provided."); }
+
+	// unprivileged worker can map only its own user into the namespace
+	if (uid_ == 0 || gid_ == 0) {
+		log_and_throw(
+			logger_, "Namespace sandbox of worker running as root needs unprivileged uid and gid configured.");
+	}
+	if (getuid() != 0 && (uid_ != getuid() || gid_ != getgid())) {
+		log_and_throw(logger_, "Namespace sandbox can run programs under another user only if the worker is root.");
+	}
+
+	if (data_dir_ == "") { logger_->info("Empty data directory for binding into sandbox."); }
+	if (limits_.disk_quotas) { logger_->warn("Disk quotas are not supported by namespace sandbox."); }
+
+	// the program is killed after its wall time, without wall time limit the same backup limit as for isolate is used
+	if (limits_.wall_time > 0) {
+		max_timeout_ = limits_.wall_time + limits_.extra_time;
+	} else {
+		max_timeout_ = (limits_.cpu_time + 300) * 1.2;
+	}
+
+	sandboxed_dir_ = data_dir_;
+	if (!cgroup_root.empty()) { cgroup_dir_ = fs::path(cgroup_root) / ("ns-box-" + std::to_string(id_)); }
+
+	temp_dir_ = fs::path(temp_dir) / std::to_string(id_);
+	try {
+		fs::create_directories(temp_dir_ / "root");
+	} catch (fs::filesystem_error &e) {
+		log_and_throw(logger_, "Failed to create root directory of sandbox. Error: ", e.what());
+	}
+}
+
+namespace_sandbox::~namespace_sandbox()
+{
+	try {
+		cgroup_cleanup();
+		fs::remove_all(temp_dir_);
+	} catch (...) {
+		// We don't care if this failed. We can't fix it either. Just don't throw an exception in destructor.
+	}
+}
+
+std::vector<namespace_sandbox::mount_point> namespace_sandbox::get_mount_points(
+	const sandbox_limits &limits, const std::string &data_dir)
+{
+	using perm = sandbox_limits::dir_perm;
+	std::vector<mount_point> result;
+
+	// default environment is the same as in isolate
+	if (data_dir.empty()) {
+		result.push_back({"tmpfs", "/box", perm::TMP});
+	} else {
+		result.push_back({data_dir, "/box", perm::RW});
+	}
+	result.push_back({"/bin", "/bin", perm::RO});
+	result.push_back({"/dev", "/dev", perm::DEV});
+	result.push_back({"/lib", "/lib", perm::RO});
+	result.push_back({"/lib64", "/lib64", perm::MAYBE});
+	result.push_back({"/usr", "/usr", perm::RO});
+	result.push_back({"proc", "/proc", perm::FS});
+	result.push_back({"tmpfs", "/tmp", perm::TMP});
+	if (limits.share_net) {
+		result.push_back({"/etc", "/etc", perm::RO}); // shared network requires /etc to work properly
+	}
+	for (auto &dir : limits.bound_dirs) {
+		result.push_back({std::get<0>(dir), (fs::path("/") / std::get<1>(dir)).string(), std::get<2>(dir)});
+	}
+	result.push_back({"/etc/alternatives", "/etc/alternatives", perm::MAYBE});
+
+	// optional bindings of missing directories are skipped
+	result.erase(std::remove_if(result.begin(),
+					 result.end(),
+					 [](const mount_point &mp) {
+						 return (mp.flags & perm::MAYBE) && !(mp.flags & (perm::FS | perm::TMP)) &&
+							 !fs::exists(mp.source);
+					 }),
+		result.end());
+	return result;
+}
+
+void namespace_sandbox::data_dir_init()
+{
+	// directories created by the root worker would not be writable by the program, files are left as they are
+	if (getuid() == 0 && !data_dir_.empty()) {
+		try {
+			auto give = [&](const fs::path &dir) {
+				if (lchown(dir.c_str(), uid_, gid_) != 0) {
+					throw fs::filesystem_error("lchown", dir, std::error_code(errno, std::generic_category()));
+				}
+			};
+			give(data_dir_);
+			for (auto &entry : fs::recursive_directory_iterator(data_dir_)) {
+				if (entry.is_directory() && !entry.is_symlink()) { give(entry.path()); }
+			}
+		} catch (fs::filesystem_error &e) {
+			log_and_throw(logger_, "Cannot pass data directory to the user of sandbox ", id_, ": ", e.what());
+		}
+	}
+}
+
+void namespace_sandbox::cgroup_init()
+{
+	if (cgroup_dir_.empty()) { return; }
+
+	try {
+		fs::create_directories(cgroup_dir_);
+	} catch (fs::filesystem_error &e) {
+		log_and_throw(logger_, "Cannot create cgroup of sandbox. Error: ", e.what());
+	}
+
+	if (limits_.memory_usage != 0) {
+		auto memory = (limits_.memory_usage + limits_.extra_memory) * 1024;
+		if (!write_file(cgroup_dir_ / "memory.max", std::to_string(memory))) {
+			log_and_throw(logger_, "Cannot set memory limit in cgroup ", cgroup_dir_.string());
+		}
+		write_file(cgroup_dir_ / "memory.swap.max", "0"); // swap controller may be missing
+	}
+	auto &cpus = placement_.get_cpus(id_);
+	if (!cpus.empty() && !write_file(cgroup_dir_ / "cpuset.cpus", helpers::format_cpu_list(cpus))) {
+		log_and_throw(logger_, "Cannot set CPUs in cgroup ", cgroup_dir_.string());
+	}
+	if (!placement_.mems.empty() &&
+		!write_file(cgroup_dir_ / "cpuset.mems", helpers::format_cpu_list(placement_.mems))) {
+		log_and_throw(logger_, "Cannot set memory nodes in cgroup ", cgroup_dir_.string());
+	}
+	if (limits_.processes != 0) {
+		// one more process for the init process of the sandbox
+		if (!write_file(cgroup_dir_ / "pids.max", std::to_string(limits_.processes + 1))) {
+			log_and_throw(logger_, "Cannot set process limit in cgroup ", cgroup_dir_.string());
+		}
+	}
+}
+
+void namespace_sandbox::cgroup_cleanup()
+{
+	if (cgroup_dir_.empty()) { return; }
+
+	std::error_code error;
+	fs::remove(cgroup_dir_, error);
+}
+
+sandbox_results namespace_sandbox::run(const std::string &binary, const std::vector<std::string> &arguments)
+{
+	timings_.clear();
+	helpers::stopwatch watch;
+	data_dir_init();
+	cgroup_init();
+
+	// prepare everything the sandbox process needs, it cannot allocate memory
+	auto root = temp_dir_ / "root";
+	auto mount_points = get_mount_points(limits_, data_dir_);
+	std::deque<std::string> strings; // references are not invalidated when appending
+	auto keep = [&](const std::string &str) { return strings.emplace_back(str).c_str(); };
+
+	context ctx = {};
+	ctx.root = keep(root.string());
+	for (auto &mp : mount_points) {
+		using perm = sandbox_limits::dir_perm;
+		mount_entry entry = {};
+		auto target = root / fs::path(mp.target).relative_path();
+		entry.target = keep(target.string());
+		entry.is_file = !(mp.flags & (perm::FS | perm::TMP)) && !fs::is_directory(mp.source);
+
+		// all missing parent directories are created, they are on tmpfs or in already bound directories
+		entry.first_dir = ctx.dirs.size();
+		auto dir = root;
+		auto relative = fs::path(mp.target).relative_path();
+		if (entry.is_file) { relative = relative.parent_path(); }
+		for (auto &part : relative) {
+			dir /= part;
+			ctx.dirs.push_back(keep(dir.string()));
+		}
+		entry.last_dir = ctx.dirs.size();
+
+		if (mp.flags & perm::FS) {
+			entry.source = entry.fstype = keep(mp.source);
+			entry.flags = MS_NOSUID | MS_NODEV | MS_NOEXEC;
+		} else if (mp.flags & perm::TMP) {
+			entry.source = entry.fstype = "tmpfs";
+			entry.data = "mode=777";
+			entry.flags = MS_NOSUID | MS_NODEV;
+		} else {
+			entry.source = keep(mp.source);
+			entry.flags = MS_BIND | ((mp.flags & perm::NOREC) ? 0 : MS_REC);
+			entry.remount_flags = MS_REMOUNT | MS_BIND | MS_NOSUID | locked_flags(mp.source);
+			if (!(mp.flags & perm::RW)) { entry.remount_flags |= MS_RDONLY; }
+			if (mp.flags & perm::NOEXEC) { entry.remount_flags |= MS_NOEXEC; }
+			if (!(mp.flags & perm::DEV)) { entry.remount_flags |= MS_NODEV; }
+		}
+		ctx.mounts.push_back(entry);
+	}
+
+	// chdir is relative to root of the sandbox, standard streams are relative to chdir
+	ctx.cwd = keep(sandbox_config_->chdir.empty() ? "/box" : (fs::path("/") / sandbox_config_->chdir).string());
+	ctx.std_input = sandbox_config_->std_input.empty() ? nullptr : keep(sandbox_config_->std_input);
+	ctx.std_output = sandbox_config_->std_output.empty() ? nullptr : keep(sandbox_config_->std_output);
+	ctx.std_error = sandbox_config_->std_error.empty() ? nullptr : keep(sandbox_config_->std_error);
+	ctx.stderr_to_stdout = sandbox_config_->stderr_to_stdout;
+	ctx.stdout_fd = ctx.stderr_fd = -1;
+	ctx.uid = uid_;
+	ctx.gid = gid_;
+	ctx.drop_groups = getuid() == 0;
+
+	auto add_limit = [&](int resource, rlim_t soft, rlim_t hard) {
+		ctx.rlimits.push_back({resource, {soft, hard}});
+	};
+	add_limit(RLIMIT_STACK,
+		limits_.stack_size != 0 ? limits_.stack_size * 1024 : RLIM_INFINITY,
+		limits_.stack_size != 0 ? limits_.stack_size * 1024 : RLIM_INFINITY);
+	if (limits_.files_size != 0) { add_limit(RLIMIT_FSIZE, limits_.files_size * 1024, limits_.files_size * 1024); }
+	if (limits_.cpu_time > 0) {
+		// killed by SIGXCPU and then SIGKILL when CPU time runs out, the time is checked precisely afterwards
+		auto seconds = static_cast<rlim_t>(std::ceil(limits_.cpu_time + limits_.extra_time));
+		add_limit(RLIMIT_CPU, seconds, seconds + 1);
+	}
+	if (cgroup_dir_.empty() && limits_.memory_usage != 0) {
+		auto memory = (limits_.memory_usage + limits_.extra_memory) * 1024;
+		add_limit(RLIMIT_AS, memory, memory);
+	}
+	add_limit(RLIMIT_CORE, 0, 0);
+
+	ctx.binary = keep(binary);
+	ctx.argv.push_back(const_cast<char *>(ctx.binary));
+	for (auto &arg : arguments) { ctx.argv.push_back(const_cast<char *>(keep(arg))); }
+	ctx.argv.push_back(nullptr);
+	ctx.envp.push_back(const_cast<char *>("LIBC_FATAL_STDERR_=1"));
+	for (auto &var : limits_.environ_vars) {
+		ctx.envp.push_back(const_cast<char *>(keep(var.first + "=" + var.second)));
+	}
+	ctx.envp.push_back(nullptr);
+
+	// captured streams replace the files, stderr redirected to stdout is captured with it
+	helpers::output_capture capture;
+	try {
+		if (stdout_capture_ != nullptr) { ctx.stdout_fd = capture.add(stdout_capture_.get()); }
+		if (stderr_capture_ != nullptr) {
+			if (ctx.stderr_to_stdout) {
+				stderr_capture_->reset();
+			} else {
+				ctx.stderr_fd = capture.add(stderr_capture_.get());
+			}
+		}
+	} catch (std::runtime_error &e) {
+		cgroup_cleanup();
+		log_and_throw(logger_, "Cannot capture output of sandbox ", id_, ": ", e.what());
+	}
+
+	int sync_pipe[2], report_pipe[2];
+	if (pipe2(sync_pipe, O_CLOEXEC) != 0) { log_and_throw(logger_, "Cannot create pipe: ", strerror(errno)); }
+	if (pipe2(report_pipe, O_CLOEXEC) != 0) {
+		close(sync_pipe[0]);
+		close(sync_pipe[1]);
+		log_and_throw(logger_, "Cannot create pipe: ", strerror(errno));
+	}
+	ctx.sync_fd = sync_pipe[0];
+	ctx.report_fd = report_pipe[1];
+
+	int flags = CLONE_NEWUSER | CLONE_NEWNS | CLONE_NEWPID | CLONE_NEWIPC | CLONE_NEWUTS | SIGCHLD;
+	if (!limits_.share_net) { flags |= CLONE_NEWNET; }
+	std::vector<char> stack(256 * 1024);
+	pid_t pid = -1;
+	int clone_error = 0;
+	try {
+		// the sandbox inherits placement of this thread
+		helpers::scoped_placement placement(placement_.get_cpus(id_), placement_.mems);
+		pid = clone(sandbox_init, stack.data() + stack.size(), flags, &ctx);
+		clone_error = errno;
+	} catch (std::system_error &e) {
+		clone_error = e.code().value();
+	}
+	close(sync_pipe[0]);
+	close(report_pipe[1]);
+	capture.close_write_ends();
+	if (pid == -1) {
+		close(sync_pipe[1]);
+		close(report_pipe[0]);
+		cgroup_cleanup();
+		log_and_throw(logger_, "Cannot create sandbox namespaces: ", strerror(clone_error));
+	}
+
+	// unprivileged user of the program is mapped to itself, root worker maps itself too to be able to set up the
+	// sandbox (the program cannot get back to it), the sandbox is started when this is done
+	bool root_worker = getuid() == 0;
+	auto id_map = [&](std::size_t id) {
+		return (root_worker ? "0 0 1\n" : "") + std::to_string(id) + " " + std::to_string(id) + " 1";
+	};
+	auto proc_dir = fs::path("/proc") / std::to_string(pid);
+	bool ok = write_file(proc_dir / "uid_map", id_map(uid_)) &&
+		(root_worker || write_file(proc_dir / "setgroups", "deny")) && write_file(proc_dir / "gid_map", id_map(gid_));
+	if (ok && !cgroup_dir_.empty()) { ok = write_file(cgroup_dir_ / "cgroup.procs", std::to_string(pid)); }
+
+	// counters are attached before the program is created, they start counting when it is executed
+	std::unique_ptr<helpers::perf_counters> counters;
+	if (ok && perf_counters_) {
+		try {
+			counters = std::make_unique<helpers::perf_counters>(pid);
+		} catch (std::system_error &e) {
+			logger_->warn("Performance counters of sandbox {} not available: {}", id_, e.what());
+		}
+		if (limits_.instructions != 0 && (counters == nullptr || !counters->read().hardware)) {
+			logger_->warn("Instruction limit of sandbox {} not enforced, instructions cannot be counted", id_);
+		}
+	}
+	if (ok) { capture.start(limits_.files_size * 1024); }
+	if (ok) { ok = write(sync_pipe[1], "x", 1) == 1; }
+	close(sync_pipe[1]);
+	if (!ok) {
+		kill(pid, SIGKILL);
+		waitpid(pid, nullptr, 0);
+		close(report_pipe[0]);
+		cgroup_cleanup();
+		log_and_throw(logger_, "Cannot set up user namespace or cgroup of sandbox ", id_);
+	}
+	timings_.emplace_back("init", watch.lap());
+
+	// the whole sandbox is killed as soon as the program exceeds the instruction limit, writes too much output or
+	// uses up its CPU time in all processes together (the resource limit applies only to each process separately)
+	bool instructions_exceeded = false;
+	bool output_exceeded = false;
+	bool cpu_exceeded = false;
+	bool check_instructions = counters != nullptr && limits_.instructions != 0;
+	bool check_output = (stdout_capture_ != nullptr || stderr_capture_ != nullptr) && limits_.files_size != 0;
+	bool check_cpu = !cgroup_dir_.empty() && limits_.cpu_time > 0;
+	std::size_t check_interval = 0;
+	std::function<void()> check_limits;
+	if (check_instructions || check_output || check_cpu) {
+		check_interval = limits_check_interval;
+		check_limits = [&]() {
+			if (check_instructions && !instructions_exceeded && counters->read().instructions > limits_.instructions) {
+				instructions_exceeded = true;
+				kill(pid, SIGKILL);
+			}
+			if (check_output && !output_exceeded && capture.exceeded()) {
+				output_exceeded = true;
+				kill(pid, SIGKILL);
+			}
+			if (check_cpu && !cpu_exceeded &&
+				helpers::read_cgroup_cpu_time(cgroup_dir_) > limits_.cpu_time + limits_.extra_time) {
+				cpu_exceeded = true;
+				kill(pid, SIGKILL);
+			}
+		};
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	struct rusage usage = {};
+	int status = 0;
+	try {
+		status = helpers::wait_or_kill(pid, std::chrono::milliseconds(static_cast<long long>(max_timeout_ * 1000)),
+			check_interval, check_limits, &usage);
+	} catch (std::system_error &e) {
+		close(report_pipe[0]);
+		cgroup_cleanup();
+		log_and_throw(logger_, "Cannot wait for sandbox ", id_, ": ", e.what());
+	}
+	double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	capture.stop();
+	output_exceeded = output_exceeded || capture.exceeded();
+	timings_.emplace_back("run", watch.lap());
+
+	report msg = {};
+	bool reported = false;
+	while (read(report_pipe[0], &msg, sizeof(msg)) == sizeof(msg)) {
+		reported = true;
+		if (msg.kind != report::STATUS) { break; }
+	}
+	close(report_pipe[0]);
+
+	sandbox_results results;
+	if (!cgroup_dir_.empty()) { results.cgroup = helpers::read_cgroup_metrics(cgroup_dir_); }
+	cgroup_cleanup();
+	if (counters != nullptr) {
+		results.perf = std::make_shared<perf_metrics>(counters->read());
+		if (limits_.instructions != 0 && results.perf->instructions > limits_.instructions) {
+			instructions_exceeded = true;
+		}
+	}
+
+	if (reported && msg.kind == report::SETUP) {
+		log_and_throw(
+			logger_, "Sandbox setup failed in step ", setup_step_names[msg.step], ": ", strerror(msg.value));
+	}
+
+	// cgroup accounts also for processes which were not waited for by their parents
+	results.time = results.cgroup != nullptr ? results.cgroup->cpu_usage : cpu_time(usage);
+	results.wall_time = wall_time;
+	results.max_rss = usage.ru_maxrss;
+	results.memory = usage.ru_maxrss;
+	if (results.cgroup != nullptr && results.cgroup->memory_peak != 0) { results.memory = results.cgroup->memory_peak; }
+	results.csw_voluntary = usage.ru_nvcsw;
+	results.csw_forced = usage.ru_nivcsw;
+
+	if (!reported) {
+		// the sandbox was killed when it did not finish in time, otherwise it should always report
+		results.killed = true;
+		if (instructions_exceeded) {
+			results.status = isolate_status::TO;
+			results.message = "Instruction limit exceeded";
+		} else if (output_exceeded) {
+			results.status = isolate_status::SG;
+			results.exitsig = SIGXFSZ;
+			results.message = "Output limit exceeded";
+		} else if (cpu_exceeded) {
+			results.status = isolate_status::TO;
+			results.message = "Time limit exceeded";
+		} else if (wall_time >= max_timeout_) {
+			results.status = isolate_status::TO;
+			results.message = limits_.wall_time > 0 ? "Time limit exceeded (wall clock)" : "Time limit exceeded";
+		} else {
+			results.status = isolate_status::XX;
+			results.message = "Sandbox terminated unexpectedly, status " + std::to_string(status);
+		}
+		return results;
+	}
+	if (msg.kind == report::PROGRAM) {
+		results.status = isolate_status::XX;
+		results.message = std::string(setup_step_names[msg.step]) + " failed: " + strerror(msg.value);
+		return results;
+	}
+
+	results.wall_time = elapsed(msg.start, msg.end);
+	int program_status = msg.value;
+	if (WIFSIGNALED(program_status)) { results.exitsig = WTERMSIG(program_status); }
+	if (WIFEXITED(program_status)) { results.exitcode = WEXITSTATUS(program_status); }
+
+	if (instructions_exceeded) {
+		results.status = isolate_status::TO;
+		results.message = "Instruction limit exceeded";
+		results.killed = WIFSIGNALED(program_status);
+	} else if (output_exceeded) {
+		// same result as the file size limit when the output goes to files
+		results.status = isolate_status::SG;
+		results.exitsig = SIGXFSZ;
+		results.message = "Output limit exceeded";
+		results.killed = WIFSIGNALED(program_status);
+	} else if (limits_.cpu_time > 0 && results.time > limits_.cpu_time) {
+		results.status = isolate_status::TO;
+		results.message = "Time limit exceeded";
+		results.killed = WIFSIGNALED(program_status);
+	} else if (limits_.wall_time > 0 && results.wall_time > limits_.wall_time) {
+		results.status = isolate_status::TO;
+		results.message = "Time limit exceeded (wall clock)";
+		results.killed = WIFSIGNALED(program_status);
+	} else if (WIFSIGNALED(program_status)) {
+		results.status = isolate_status::SG;
+		results.message = "Caught fatal signal " + std::to_string(results.exitsig);
+	} else if (results.exitcode != 0) {
+		results.status = isolate_status::RE;
+		results.message = "Exited with error status " + std::to_string(results.exitcode);
+	}
+	return results;
+}
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef RECODEX_WORKER_FILE_NAMESPACE_SANDBOX_H
+#define RECODEX_WORKER_FILE_NAMESPACE_SANDBOX_H
+
+#ifndef _WIN32
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <filesystem>
+#include <sys/types.h>
+#include "helpers/logger.h"
+#include "sandbox_base.h"
+#include "config/sandbox_config.h"
+#include "helpers/cpuset.h"
+
+/**
+ * Sandbox created directly by the worker from Linux namespaces, without running external binary.
+ *
+ * Sandboxed program runs in new user, mount, PID, IPC, UTS and (unless network is shared) network namespace.
+ * Its root directory is an empty tmpfs with read-only bindings of system directories (/bin, /lib, /lib64, /usr),
+ * /dev, fresh /proc and /tmp and directories from the limits. Data directory is bound directly as /box, so nothing
+ * has to be copied in or out. Program runs as an unprivileged user (the worker user, or the configured one if the
+ * worker is root) mapped to itself, without any capabilities and with no_new_privs set, so it cannot change mounts.
+ *
+ * Performance counters (instructions, cycles, task clock) of the program can be measured as well, then the limit of
+ * instructions is enforced.
+ *
+ * Standard output and error may be captured through pipes directly into memory instead of files in the sandbox,
+ * the size limit of files applies to them as well.
+ *
+ * Memory, process and CPU time limits are enforced by cgroup v2 if a delegated cgroup directory writable by the
+ * worker is given; the worker then measures CPU time of all processes of the program in the cgroup and kills the
+ * sandbox when they exceed the limit together. Otherwise, resource limits of the process are used and CPU time is
+ * taken from resource usage of the waited processes; the CPU time limit then applies to each process separately, so a
+ * program splitting its work among processes can use more CPU time in total. Wall time is measured and enforced by
+ * the worker. The interface of results follows isolate, so the sandboxes are interchangeable.
+ *
+ * @note Requirements are Linux with unprivileged user namespaces allowed (or worker running as root, then
+ * unprivileged uid and gid of programs have to be given).
+ * Disk quotas are not supported.
+ */
+class namespace_sandbox : public sandbox_base
+{
+public:
+	/**
+	 * Constructor.
+	 * @param limits Limits for current command.
+	 * @param id Number of current worker. This must be unique for each worker on one machine!
+	 * @param temp_dir Directory to store temporary files (root directory of the sandbox)
+	 * @param data_dir Directory which will be bound into sandbox as /box
+	 * @param logger Set system logger (optional).
+	 * @param cgroup_root Delegated cgroup v2 directory, cgroup of the sandbox is created inside (optional).
+	 * @param placement CPUs and memory nodes of the sandboxed program (optional).
+	 * @param perf_counters Measure performance counters of the program (optional).
+	 * @param uid User of the program, required if the worker is root, otherwise the worker user (optional).
+	 * @param gid Group of the program, required if the worker is root, otherwise the worker group (optional).
+	 * @throws sandbox_exception if the program would run as root or under a user the worker cannot map
+	 */
+	namespace_sandbox(std::shared_ptr<sandbox_config> sandbox_config,
+		sandbox_limits limits,
+		std::size_t id,
+		const std::string &temp_dir,
+		const std::string &data_dir,
+		std::shared_ptr<spdlog::logger> logger = nullptr,
+		const std::string &cgroup_root = "",
+		const helpers::cpu_placement &placement = helpers::cpu_placement(),
+		bool perf_counters = false,
+		uid_t uid = 0,
+		gid_t gid = 0);
+	/**
+	 * Destructor.
+	 */
+	~namespace_sandbox() override;
+	sandbox_results run(const std::string &binary, const std::vector<std::string> &arguments) override;
+
+	/**
+	 * Bound directory or mounted filesystem inside sandbox.
+	 */
+	struct mount_point {
+		/** Directory outside sandbox or type of filesystem */
+		std::string source;
+		/** Absolute path inside sandbox */
+		std::string target;
+		/** Permissions, see sandbox_limits::dir_perm */
+		unsigned short flags;
+	};
+
+	/**
+	 * Get all directories mounted into sandbox, the default ones first.
+	 * @param limits limits of the sandbox with additional bound directories
+	 * @param data_dir directory bound as /box
+	 * @return mount points in order of mounting
+	 */
+	static std::vector<mount_point> get_mount_points(const sandbox_limits &limits, const std::string &data_dir);
+
+private:
+	/** General sandbox configuration */
+	std::shared_ptr<sandbox_config> sandbox_config_;
+	/** Limits for sandboxed program */
+	sandbox_limits limits_;
+	/** Logger */
+	std::shared_ptr<spdlog::logger> logger_;
+	/** Identifier of this sandbox. Must be unique on each server. */
+	std::size_t id_;
+	/** Subdirectory of temporary directory of this sandbox */
+	std::filesystem::path temp_dir_;
+	/** Directory bound into sandbox as /box */
+	std::string data_dir_;
+	/** Cgroup of the sandbox, empty if cgroups are not used */
+	std::filesystem::path cgroup_dir_;
+	/** CPUs and memory nodes of the sandboxed program */
+	helpers::cpu_placement placement_;
+	/** Whether performance counters of the program are measured */
+	bool perf_counters_;
+	/** Unprivileged user of the program */
+	uid_t uid_;
+	/** Unprivileged group of the program */
+	gid_t gid_;
+	/** Maximum time of the sandboxed program including its extra time, in seconds */
+	double max_timeout_;
+	/** Give directories of the data to the user of the program if the worker is root */
+	void data_dir_init();
+	/** Create cgroup of the sandbox and set its limits */
+	void cgroup_init();
+	/** Remove cgroup of the sandbox */
+	void cgroup_cleanup();
+};
+
+
+#endif // _WIN32
+#endif // RECODEX_WORKER_FILE_NAMESPACE_SANDBOX_H
@@ -11,6 +11,7 @@
 #include "config/sandbox_limits.h"
 #include "config/task_results.h"
 #include "helpers/format.h"
+#include "helpers/output_buffer.h"
 
 
 /**
@@ -40,12 +41,39 @@ public:
 	 */
 	virtual sandbox_results run(const std::string &binary, const std::vector<std::string> &arguments) = 0;
 
+	/**
+	 * Get durations of phases of the last run (copying data, running the program, ...).
+	 */
+	virtual const helpers::phase_timings &get_timings() const
+	{
+		return timings_;
+	}
+
+	/**
+	 * Capture standard output and error of the program into buffers instead of files given in the sandbox config.
+	 * Buffers are reset at the beginning of each run.
+	 * @param stdout_capture buffer of stdout, @a nullptr if not captured
+	 * @param stderr_capture buffer of stderr, @a nullptr if not captured (stays empty if stderr goes to stdout)
+	 */
+	virtual void set_output_capture(
+		std::shared_ptr<helpers::output_buffer> stdout_capture, std::shared_ptr<helpers::output_buffer> stderr_capture)
+	{
+		stdout_capture_ = stdout_capture;
+		stderr_capture_ = stderr_capture;
+	}
+
 protected:
 	/**
 	 * Path to sandboxed directory.
 	 * @warning Must be set in constructor of child class.
 	 */
 	std::string sandboxed_dir_;
+	/** Durations of phases of the last run. */
+	helpers::phase_timings timings_;
+	/** Buffer of captured stdout, @a nullptr if not captured */
+	std::shared_ptr<helpers::output_buffer> stdout_capture_;
+	/** Buffer of captured stderr, @a nullptr if not captured */
+	std::shared_ptr<helpers::output_buffer> stderr_capture_;
 };
 
 
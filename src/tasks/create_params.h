@@ -8,6 +8,9 @@
 #include "config/sandbox_limits.h"
 #include "config/task_metadata.h"
 
+class isolate_box_pool;
+class isolate_session;
+
 /** data for proper construction of @ref external_task class */
 struct create_params {
 	/** unique worker identification on this machine */
@@ -26,6 +29,10 @@ struct create_params {
 	fs::path source_path;
 	/** working directory which points inside sandbox */
 	fs::path sandbox_working_path;
+	/** pool of pre-initialized isolate boxes, filled in by the task factory, can be nullptr */
+	std::shared_ptr<isolate_box_pool> box_pool = nullptr;
+	/** isolate box shared by consecutive sandboxed tasks of the job, can be nullptr */
+	std::shared_ptr<isolate_session> session = nullptr;
 };
 
 
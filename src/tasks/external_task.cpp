@@ -1,8 +1,8 @@
 #include "external_task.h"
 #include "sandbox/isolate_sandbox.h"
+#include "sandbox/namespace_sandbox.h"
 #include "helpers/string_utils.h"
 #include "helpers/filesystem.h"
-#include <fstream>
 #include <algorithm>
 #include <memory>
 #include <string>
@@ -13,7 +13,8 @@ namespace fs = std::filesystem;
 external_task::external_task(const create_params &data)
 	: task_base(data.id, data.task_meta), worker_config_(data.worker_conf), sandbox_(nullptr),
 	  sandbox_config_(data.task_meta->sandbox), limits_(data.limits), logger_(data.logger), temp_dir_(data.temp_dir),
-	  evaluation_dir_(data.source_path), sandbox_working_dir_(data.sandbox_working_path)
+	  evaluation_dir_(data.source_path), sandbox_working_dir_(data.sandbox_working_path),
+	  box_pool_(data.box_pool), session_(data.session)
 {
 	if (worker_config_ == nullptr) { throw task_exception("No worker configuration provided."); }
 
@@ -28,6 +29,7 @@ external_task::external_task(const create_params &data)
 
 		evaluation_dir_ = fs::path(data.source_path) / sandbox_config_->working_directory;
 	}
+	data_dir_ = evaluation_dir_;
 
 	sandbox_check();
 }
@@ -38,6 +40,7 @@ void external_task::sandbox_check()
 
 #ifndef _WIN32
 	if (task_meta_->sandbox->name == "isolate") { found = true; }
+	if (task_meta_->sandbox->name == "namespace") { found = true; }
 #endif
 
 	if (found == false) { throw task_exception("Unknown sandbox type: " + task_meta_->sandbox->name); }
@@ -46,15 +49,68 @@ void external_task::sandbox_check()
 void external_task::sandbox_init()
 {
 #ifndef _WIN32
-	if (task_meta_->sandbox->name == "isolate") {
-		sandbox_limits limits(*limits_);
-		if (this->get_type() == task_type::INITIATION) {
-			limits.share_net = true; // initiation (compilation) tasks may use internet to download stuff
+	sandbox_limits limits(*limits_);
+	if (this->get_type() == task_type::INITIATION) {
+		limits.share_net = true; // initiation (compilation) tasks may use internet to download stuff
+
+		// TODO: a better way would be to make this optional (a job will define, whether it requires net or not)
+	}
 
-			// TODO: a better way would be to make this optional (a job will define, whether it requires net or not)
+	if (task_meta_->sandbox->name == "isolate") {
+		isolate_options options;
+		options.box_pool = box_pool_;
+		options.placement = worker_config_->get_cpu_placement();
+		options.rename_data = worker_config_->get_box_data_transfer() == "rename";
+		options.session = session_;
+		if (worker_config_->get_cgroup_metrics_enabled()) {
+			options.cgroup_root = worker_config_->get_cgroup_root();
+			options.cgroup_sample_interval = worker_config_->get_cgroup_sample_interval();
 		}
-		sandbox_ = std::make_shared<isolate_sandbox>(
-			sandbox_config_, limits, worker_config_->get_worker_id(), temp_dir_, evaluation_dir_.string(), logger_);
+		sandbox_ = std::make_shared<isolate_sandbox>(sandbox_config_,
+			limits,
+			worker_config_->get_worker_id(),
+			temp_dir_,
+			evaluation_dir_.string(),
+			logger_,
+			options);
+
+		// data are moved into the box of the session already and stay there after the run
+		if (session_ != nullptr) { data_dir_ = sandbox_->get_dir(); }
+	} else if (task_meta_->sandbox->name == "namespace") {
+		// namespace sandbox binds the evaluation directory, so the data have to be out of the box of the session
+		if (session_ != nullptr) { session_->sync(); }
+		sandbox_ = std::make_shared<namespace_sandbox>(sandbox_config_,
+			limits,
+			worker_config_->get_worker_id(),
+			temp_dir_,
+			evaluation_dir_.string(),
+			logger_,
+			worker_config_->get_namespace_cgroup_root(),
+			worker_config_->get_cpu_placement(),
+			worker_config_->get_perf_counters(),
+			worker_config_->get_namespace_uid(),
+			worker_config_->get_namespace_gid());
+	}
+
+	// streams which are not redirected by the task itself are read from pipes directly into memory; evaluation
+	// directory is moved into the isolate box during the run, so carbon copies into it are made from files afterwards
+	bool copy_during_run = task_meta_->sandbox->name == "namespace";
+	if (sandbox_ != nullptr && worker_config_->get_output_capture() == "pipe") {
+		auto make_capture = [&](const std::string &file, const std::string &carboncopy) {
+			std::shared_ptr<helpers::output_buffer> capture;
+			if (!file.empty() || (!carboncopy.empty() && !copy_during_run)) { return capture; }
+			if (sandbox_config_->output || !carboncopy.empty()) {
+				capture = std::make_shared<helpers::output_buffer>(
+					sandbox_config_->output ? worker_config_->get_max_output_length() : 0,
+					worker_config_->get_output_tail_length(),
+					carboncopy,
+					worker_config_->get_max_carboncopy_length());
+			}
+			return capture;
+		};
+		stdout_capture_ = make_capture(sandbox_config_->std_output, sandbox_config_->carboncopy_stdout);
+		stderr_capture_ = make_capture(sandbox_config_->std_error, sandbox_config_->carboncopy_stderr);
+		sandbox_->set_output_capture(stdout_capture_, stderr_capture_);
 	}
 #endif
 }
@@ -66,6 +122,7 @@ void external_task::sandbox_fini()
 
 std::shared_ptr<task_results> external_task::run()
 {
+	helpers::stopwatch watch;
 	sandbox_init();
 
 	if (sandbox_ == nullptr) {
@@ -77,24 +134,74 @@ std::shared_ptr<task_results> external_task::run()
 	results_output_init();
 
 	// check if evaluation directory exists
-	if (!fs::exists(evaluation_dir_)) {
-		throw task_exception("Evaluation directory '" + evaluation_dir_.string() + "' of sandbox does not exists");
+	if (!fs::exists(data_dir_)) {
+		throw task_exception("Evaluation directory '" + data_dir_.string() + "' of sandbox does not exists");
 	}
 
 	// check if binary is executable and set it otherwise
 	make_binary_executable(task_meta_->binary);
 
+	// context of the host is recorded during all runs of the program
+	auto &host_noise = worker_config_->get_host_noise();
+	std::unique_ptr<helpers::host_monitor> host;
+	if (host_noise.enabled) { host = std::make_unique<helpers::host_monitor>(); }
+
+	// repeated runs have to start from the same data as the first one
+	fs::path snapshot;
+	if (sandbox_config_->repeat > 1) {
+		snapshot = fs::path(temp_dir_) / (task_meta_->task_id + "." + helpers::random_alphanum_string(10) + ".repeat");
+		copy_data(data_dir_, snapshot);
+	}
+
 	auto res = std::make_shared<task_results>();
+	res->timings.emplace_back("sandbox-init", watch.lap());
 	res->sandbox_status =
 		std::unique_ptr<sandbox_results>(new sandbox_results(sandbox_->run(task_meta_->binary, task_meta_->cmd_args)));
+	watch.lap();
+
+	// timing-critical programs are run repeatedly to filter out noise of the host
+	if (!snapshot.empty()) {
+		repeat_run(res, snapshot);
+		try {
+			fs::remove_all(snapshot);
+		} catch (fs::filesystem_error &e) {
+			logger_->warn("Copy of data for repeated runs not cleaned properly: {}", e.what());
+		}
+		if (res->sandbox_status->repeat != nullptr) { res->timings.emplace_back("repeat", watch.lap()); }
+	}
+
+	// sandbox phases are measured in the reported run
+	auto &sandbox_timings = sandbox_->get_timings();
+	res->timings.insert(res->timings.end(), sandbox_timings.begin(), sandbox_timings.end());
+
+	if (host != nullptr) {
+		auto &status = *res->sandbox_status;
+		status.host = host->finish(host_noise, status.cgroup.get());
+		if (status.host->tainted) {
+			std::string taints;
+			for (auto &taint : status.host->taints) { taints += (taints.empty() ? "" : ", ") + taint; }
+			logger_->warn("Run of task {} may be slowed down by the host: {}", task_meta_->task_id, taints);
+		}
+	}
 
 	// fix status if non-zero exit codes are treated as execution success
 	postprocess_exit_codes(res);
 
+#ifndef _WIN32
+	// carbon copies are written outside of the sandbox, possibly into the data kept in the box of the session
+	if (session_ != nullptr &&
+		(!sandbox_config_->carboncopy_stdout.empty() || !sandbox_config_->carboncopy_stderr.empty())) {
+		session_->sync();
+		data_dir_ = evaluation_dir_;
+	}
+#endif
+
 	// get output from stdout and stderr
 	get_results_output(res);
+	res->timings.emplace_back("output", watch.lap());
 
 	sandbox_fini();
+	res->timings.emplace_back("cleanup", watch.lap());
 
 	// Check if sandbox ran successfully, else report error
 	if (res->sandbox_status->status != isolate_status::OK) {
@@ -124,13 +231,65 @@ std::shared_ptr<sandbox_limits> external_task::get_limits()
 	return limits_;
 }
 
+void external_task::repeat_run(std::shared_ptr<task_results> result, const fs::path &snapshot)
+{
+	if (result->sandbox_status->status != isolate_status::TO) { return; }
+
+	auto samples = std::make_shared<repeat_samples>();
+	samples->time.push_back(result->sandbox_status->time);
+	samples->wall_time.push_back(result->sandbox_status->wall_time);
+
+	// the last run is reported, so that its status matches the outputs and files it left behind
+	for (std::size_t i = 1; i < sandbox_config_->repeat && result->sandbox_status->status == isolate_status::TO; ++i) {
+		logger_->debug("Repeating run {} of task {} which timed out", i + 1, task_meta_->task_id);
+		restore_data(snapshot);
+		result->sandbox_status =
+			std::make_unique<sandbox_results>(sandbox_->run(task_meta_->binary, task_meta_->cmd_args));
+		samples->time.push_back(result->sandbox_status->time);
+		samples->wall_time.push_back(result->sandbox_status->wall_time);
+	}
+
+	samples->time_min = *std::min_element(samples->time.begin(), samples->time.end());
+	samples->time_median = helpers::median(samples->time);
+	result->sandbox_status->repeat = samples;
+}
+
+void external_task::copy_data(const fs::path &src, const fs::path &dest)
+{
+	try {
+		helpers::copy_directory(src, dest, true); // true = skip symlinks for security reasons
+
+		// copied directories are created with default permissions, the sandboxed program may need more
+		for (auto &entry : fs::recursive_directory_iterator(src)) {
+			if (fs::is_directory(entry.symlink_status())) {
+				fs::permissions(dest / fs::relative(entry.path(), src), entry.status().permissions());
+			}
+		}
+		fs::permissions(dest, fs::status(src).permissions());
+	} catch (fs::filesystem_error &e) {
+		throw task_exception("Data of task cannot be copied from " + src.string() + ": " + e.what());
+	} catch (helpers::filesystem_exception &e) {
+		throw task_exception("Data of task cannot be copied from " + src.string() + ": " + e.what());
+	}
+}
+
+void external_task::restore_data(const fs::path &snapshot)
+{
+	try {
+		for (auto &entry : fs::directory_iterator(data_dir_)) { fs::remove_all(entry.path()); }
+	} catch (fs::filesystem_error &e) {
+		throw task_exception("Data of task cannot be cleaned before repeated run: " + std::string(e.what()));
+	}
+	copy_data(snapshot, data_dir_);
+}
+
 void external_task::results_output_init()
 {
 	std::string random = helpers::random_alphanum_string(10);
 
 	if (sandbox_config_->output || !sandbox_config_->carboncopy_stdout.empty()) {
 		// output from stdout/stderr or carboncopy of stdout was requested
-		if (sandbox_config_->std_output == "") {
+		if (sandbox_config_->std_output == "" && stdout_capture_ == nullptr) {
 			remove_stdout_ = true;
 			std::string stdout_file = task_meta_->task_id + "." + random + ".output.stdout";
 			sandbox_config_->std_output = (sandbox_working_dir_ / fs::path(stdout_file)).string();
@@ -139,7 +298,7 @@ void external_task::results_output_init()
 
 	if (sandbox_config_->output || !sandbox_config_->carboncopy_stderr.empty()) {
 		// output from stdout/stderr or carboncopy of stderr was requested
-		if (sandbox_config_->std_error == "") {
+		if (sandbox_config_->std_error == "" && stderr_capture_ == nullptr) {
 			remove_stderr_ = true;
 			std::string stderr_file = task_meta_->task_id + "." + random + ".output.stderr";
 			sandbox_config_->std_error = (sandbox_working_dir_ / fs::path(stderr_file)).string();
@@ -150,14 +309,16 @@ void external_task::results_output_init()
 fs::path external_task::find_path_outside_sandbox(const std::string &file)
 {
 	return helpers::find_path_outside_sandbox(
-		file, sandbox_config_->chdir, limits_->bound_dirs, evaluation_dir_.string());
+		file, sandbox_config_->chdir, limits_->bound_dirs, data_dir_.string());
 }
 
 void external_task::get_results_output(std::shared_ptr<task_results> result)
 {
-	// files were outputted inside sandbox, so we have to find path outside sandbox
-	fs::path stdout_file_path = find_path_outside_sandbox(sandbox_config_->std_output);
-	fs::path stderr_file_path = find_path_outside_sandbox(sandbox_config_->std_error);
+	// files were outputted inside sandbox, so we have to find path outside sandbox (captured streams have none)
+	fs::path stdout_file_path;
+	fs::path stderr_file_path;
+	if (stdout_capture_ == nullptr) { stdout_file_path = find_path_outside_sandbox(sandbox_config_->std_output); }
+	if (stderr_capture_ == nullptr) { stderr_file_path = find_path_outside_sandbox(sandbox_config_->std_error); }
 	process_results_output(result, stdout_file_path, stderr_file_path);
 	process_carboncopy_output(stdout_file_path, stderr_file_path);
 
@@ -175,56 +336,31 @@ void external_task::process_results_output(
 {
 	if (sandbox_config_->output) {
 		std::size_t max_length = worker_config_->get_max_output_length();
-		std::string result_stdout(max_length, 0);
-		std::string result_stderr(max_length, 0);
-
-		// open and read files
-		std::ifstream std_out(stdout_path.string());
-		std::ifstream std_err(stderr_path.string());
-		std_out.read(&result_stdout[0], max_length);
-		std_err.read(&result_stderr[0], max_length);
-
-		// if there was something in stdout, write it to result
-		if (std_out.gcount() != 0) { result->output_stdout = result_stdout.substr(0, std_out.gcount()); }
-
-		// if there was something in stderr, write it to result
-		if (std_err.gcount() != 0) { result->output_stderr = result_stderr.substr(0, std_err.gcount()); }
+		std::size_t tail_length = worker_config_->get_output_tail_length();
 
-		// be nice and close streams
-		std_out.close();
-		std_err.close();
+		// only the needed parts of the files are read, empty outputs do not allocate anything
+		if (stdout_capture_ != nullptr) {
+			result->output_stdout = stdout_capture_->str();
+		} else {
+			result->output_stdout = helpers::read_file_bounded(stdout_path, max_length, tail_length);
+		}
+		if (stderr_capture_ != nullptr) {
+			result->output_stderr = stderr_capture_->str();
+		} else {
+			result->output_stderr = helpers::read_file_bounded(stderr_path, max_length, tail_length);
+		}
 	}
 }
 
 void external_task::process_carboncopy_output(const fs::path &stdout_path, const fs::path &stderr_path)
 {
+	// captured streams were copied during the run already, files are copied by the kernel without any buffer
 	std::size_t max_length = worker_config_->get_max_carboncopy_length();
-	if (!sandbox_config_->carboncopy_stdout.empty()) {
-		std::ifstream infile(stdout_path.string(), std::ios::binary);
-		std::ofstream copy_file(sandbox_config_->carboncopy_stdout, std::ios::binary);
-
-		// make the copying, by reading the file in memory and writing it to the copy
-		std::string inmemory(max_length, 0);
-		infile.read(&inmemory[0], max_length);
-		copy_file.write(&inmemory[0], infile.gcount());
-
-		// some day we do not close streams... but it is not this day
-		infile.close();
-		copy_file.close();
+	if (!sandbox_config_->carboncopy_stdout.empty() && stdout_capture_ == nullptr) {
+		helpers::copy_file_bounded(stdout_path, sandbox_config_->carboncopy_stdout, max_length);
 	}
-
-	if (!sandbox_config_->carboncopy_stderr.empty()) {
-		std::ifstream infile(stderr_path.string(), std::ios::binary);
-		std::ofstream copy_file(sandbox_config_->carboncopy_stderr, std::ios::binary);
-
-		// make the copying, by reading the file in memory and writing it to the copy
-		std::string inmemory(max_length, 0);
-		infile.read(&inmemory[0], max_length);
-		copy_file.write(&inmemory[0], infile.gcount());
-
-		// close streams, you fools
-		infile.close();
-		copy_file.close();
+	if (!sandbox_config_->carboncopy_stderr.empty() && stderr_capture_ == nullptr) {
+		helpers::copy_file_bounded(stderr_path, sandbox_config_->carboncopy_stderr, max_length);
 	}
 }
 
@@ -7,6 +7,7 @@
 #include "create_params.h"
 #include "sandbox/sandbox_base.h"
 #include "config/sandbox_limits.h"
+#include "helpers/output_buffer.h"
 
 
 /**
@@ -80,6 +81,30 @@ private:
 	 */
 	void postprocess_exit_codes(std::shared_ptr<task_results> result);
 
+	/**
+	 * If the program exceeded its time limit and repetition is allowed in the sandbox config, run it again on the
+	 * original data until a run does not time out or the configured count of runs is reached. Results of the last
+	 * run are kept, times of all runs are stored in the results as well.
+	 * @param result results of the first run, replaced by the results of the last run
+	 * @param snapshot copy of the data directory made before the first run
+	 */
+	void repeat_run(std::shared_ptr<task_results> result, const fs::path &snapshot);
+
+	/**
+	 * Copy data of the task including permissions of directories, symlinks are skipped.
+	 * @param src directory to be copied
+	 * @param dest destination directory, created if it does not exist
+	 * @throws task_exception if the data cannot be copied
+	 */
+	void copy_data(const fs::path &src, const fs::path &dest);
+
+	/**
+	 * Replace content of the data directory by the copy made before the first run.
+	 * @param snapshot copy of the data directory
+	 * @throws task_exception if the data cannot be restored
+	 */
+	void restore_data(const fs::path &snapshot);
+
 	/**
 	 * Initialize output if requested.
 	 */
@@ -110,12 +135,22 @@ private:
 	std::string temp_dir_;
 	/** Directory outside sandbox where task will be executed */
 	fs::path evaluation_dir_;
+	/** Directory outside sandbox where data of the task are, evaluation directory or box of the session */
+	fs::path data_dir_;
 	/** Directory binded to the sandbox as default working dir */
 	fs::path sandbox_working_dir_;
 	/** After execution delete stdout file produced by sandbox */
 	bool remove_stdout_ = false;
 	/** After execution delete stderr file produced by sandbox */
 	bool remove_stderr_ = false;
+	/** Stdout captured directly into memory, @a nullptr if it goes to a file */
+	std::shared_ptr<helpers::output_buffer> stdout_capture_;
+	/** Stderr captured directly into memory, @a nullptr if it goes to a file */
+	std::shared_ptr<helpers::output_buffer> stderr_capture_;
+	/** Pool of pre-initialized isolate boxes, may be @a nullptr */
+	std::shared_ptr<isolate_box_pool> box_pool_;
+	/** Isolate box shared with other tasks of the job, may be @a nullptr */
+	std::shared_ptr<isolate_session> session_;
 };
 
 #endif // RECODEX_WORKER_EXTERNAL_TASK_HPP
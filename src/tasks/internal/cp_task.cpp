@@ -44,11 +44,11 @@ std::shared_ptr<task_results> cp_task::run()
 			if (fs::is_directory(fs::symlink_status(item->path()))) {
 				helpers::copy_directory(item->path(), target);
 			} else {
-				std::error_code error_code;
-				fs::copy(item->path(), target, error_code);
-				if (error_code) {
+				try {
+					helpers::clone_file(item->path(), target);
+				} catch (fs::filesystem_error &e) {
 					result->status = task_status::FAILED;
-					result->error_message = std::string("Cannot copy files. Error: ") + error_code.message();
+					result->error_message = std::string("Cannot copy files. Error: ") + e.code().message();
 					break;
 				}
 			}
@@ -1,9 +1,11 @@
 #include "fetch_task.h"
 
 
-fetch_task::fetch_task(
-	std::size_t id, std::shared_ptr<task_metadata> task_meta, std::shared_ptr<file_manager_interface> filemanager)
-	: task_base(id, task_meta), filemanager_(filemanager)
+fetch_task::fetch_task(std::size_t id,
+	std::shared_ptr<task_metadata> task_meta,
+	std::shared_ptr<file_manager_interface> filemanager,
+	bool readonly)
+	: task_base(id, task_meta), filemanager_(filemanager), readonly_(readonly)
 {
 	if (task_meta_->cmd_args.size() != 2) {
 		throw task_exception(
@@ -17,7 +19,11 @@ std::shared_ptr<task_results> fetch_task::run()
 	std::shared_ptr<task_results> result(new task_results());
 
 	try {
-		filemanager_->get_file(task_meta_->cmd_args[0], task_meta_->cmd_args[1]);
+		if (readonly_) {
+			filemanager_->get_readonly_file(task_meta_->cmd_args[0], task_meta_->cmd_args[1]);
+		} else {
+			filemanager_->get_file(task_meta_->cmd_args[0], task_meta_->cmd_args[1]);
+		}
 	} catch (fm_exception &e) {
 		result->status = task_status::FAILED;
 		result->error_message = std::string("Cannot fetch files. Error: ") + e.what();
@@ -18,10 +18,13 @@ public:
 	 * @param task_meta Variable containing further info about task. It's required that
 	 * @a cmd_args entry has just 2 arguments - filename to get/download and destination directory.
 	 * @param filemanager Filemanager which needs to gather requested file.
+	 * @param readonly If true, fetched file is never modified and may share data with cached file.
 	 * @throws task_exception on invalid number of arguments.
 	 */
-	fetch_task(
-		std::size_t id, std::shared_ptr<task_metadata> task_meta, std::shared_ptr<file_manager_interface> filemanager);
+	fetch_task(std::size_t id,
+		std::shared_ptr<task_metadata> task_meta,
+		std::shared_ptr<file_manager_interface> filemanager,
+		bool readonly = false);
 	/**
 	 * Destructor.
 	 */
@@ -35,6 +38,8 @@ public:
 private:
 	/** Pointer to filemanager instance. */
 	std::shared_ptr<file_manager_interface> filemanager_;
+	/** Fetched file is read-only. */
+	bool readonly_;
 };
 
 #endif // RECODEX_WORKER_INTERNAL_FETCH_TASK_H
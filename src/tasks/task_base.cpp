@@ -46,6 +46,11 @@ size_t task_base::get_priority()
 	return task_meta_->priority;
 }
 
+double task_base::get_order_hint()
+{
+	return task_meta_->order_hint;
+}
+
 bool task_base::get_fatal_failure()
 {
 	return task_meta_->fatal_failure;
@@ -71,6 +76,11 @@ task_type task_base::get_type()
 	return task_meta_->type;
 }
 
+bool task_base::is_sandboxed()
+{
+	return task_meta_->sandbox != nullptr;
+}
+
 bool task_base::is_executable()
 {
 	return execute_;
@@ -82,6 +82,12 @@ public:
 	 * @return Priority.
 	 */
 	std::size_t get_priority();
+	/**
+	 * Get scheduling hint which orders tasks with equal priority.
+	 * Bigger number = executed sooner.
+	 * @return Order hint.
+	 */
+	double get_order_hint();
 	/**
 	 * Get failing policy. If @a true than failure of this task will cause
 	 * mmediate exit of job evaluation.
@@ -110,6 +116,11 @@ public:
 	 * @return task_type enum with all possible types
 	 */
 	task_type get_type();
+	/**
+	 * Tells whether task runs in sandbox.
+	 * @return @a true if sandbox is given in @ref task_metadata structure
+	 */
+	bool is_sandboxed();
 
 	/**
 	 * Tells whether task can be safely executed or not (ie. if parent task is failed).
@@ -201,9 +212,10 @@ class task_compare
 {
 public:
 	/**
-	 * Compare @ref task_base objects by their priority and identifier. This is something like
+	 * Compare @ref task_base objects by their priority, order hint and identifier. This is something like
 	 * lesser than operator on @ref task_base objects.
 	 * Its supposed that bigger number of priority is greater priority, so this tasks will be prefered.
+	 * Among tasks with equal priority the ones with bigger order hint are prefered.
 	 * @param a First task to compare.
 	 * @param b Second task to compare.
 	 * @return @a true if parameter a is lesser than b
@@ -212,8 +224,12 @@ public:
 	{
 		if (a->get_priority() > b->get_priority()) {
 			return true;
-		} else if (a->get_priority() == b->get_priority() && a->get_id() < b->get_id()) {
-			return true;
+		} else if (a->get_priority() == b->get_priority()) {
+			if (a->get_order_hint() > b->get_order_hint()) {
+				return true;
+			} else if (a->get_order_hint() == b->get_order_hint() && a->get_id() < b->get_id()) {
+				return true;
+			}
 		}
 
 		return false;
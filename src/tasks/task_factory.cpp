@@ -1,7 +1,9 @@
 #include "task_factory.h"
 
 
-task_factory::task_factory(std::shared_ptr<file_manager_interface> fileman) : fileman_(fileman)
+task_factory::task_factory(
+	std::shared_ptr<file_manager_interface> fileman, std::shared_ptr<isolate_box_pool> box_pool)
+	: fileman_(fileman), box_pool_(box_pool)
 {
 }
 
@@ -27,6 +29,8 @@ std::shared_ptr<task_base> task_factory::create_internal_task(std::size_t id, st
 		task = std::make_shared<extract_task>(id, task_meta);
 	} else if (task_meta->binary == "fetch") {
 		task = std::make_shared<fetch_task>(id, task_meta, fileman_);
+	} else if (task_meta->binary == "fetch-ro") {
+		task = std::make_shared<fetch_task>(id, task_meta, fileman_, true);
 	} else if (task_meta->binary == "truncate") {
 		task = std::make_shared<truncate_task>(id, task_meta);
 	} else if (task_meta->binary == "exists") {
@@ -40,5 +44,7 @@ std::shared_ptr<task_base> task_factory::create_internal_task(std::size_t id, st
 
 std::shared_ptr<task_base> task_factory::create_sandboxed_task(const create_params &data)
 {
-	return std::make_shared<external_task>(data);
+	create_params params(data);
+	params.box_pool = box_pool_;
+	return std::make_shared<external_task>(params);
 }
@@ -27,8 +27,10 @@ public:
 	/**
 	 * Constructor
 	 * @param fileman Instance of file manager to be used. It's required by @ref fetch_task to work properly.
+	 * @param box_pool Optional pool of pre-initialized isolate boxes handed over to sandboxed tasks.
 	 */
-	task_factory(std::shared_ptr<file_manager_interface> fileman);
+	task_factory(
+		std::shared_ptr<file_manager_interface> fileman, std::shared_ptr<isolate_box_pool> box_pool = nullptr);
 
 	/**
 	 * Virtual destructor
@@ -59,6 +61,8 @@ public:
 private:
 	/** Pointer to given file manager instance. */
 	std::shared_ptr<file_manager_interface> fileman_;
+	/** Pool of pre-initialized isolate boxes, may be @a nullptr. */
+	std::shared_ptr<isolate_box_pool> box_pool_;
 };
 
 
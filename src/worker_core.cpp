@@ -21,8 +21,12 @@ worker_core::worker_core(std::vector<std::string> args)
 	load_config();
 	// initialize working directory
 	filesystem_init();
+	// reserve CPUs of sandboxes before any thread is started
+	placement_init();
 	// initialize logger
 	log_init();
+	// measure speed of the host before anything else runs
+	calibration_init();
 	// initialize curl
 	curl_init();
 	// construct and setup broker connection
@@ -116,6 +120,36 @@ void worker_core::force_exit(const std::string &msg)
 	exit(1);
 }
 
+void worker_core::placement_init()
+{
+#ifndef _WIN32
+	if (!config_->get_cpuset_exclusive()) { return; }
+
+	auto &placement = config_->get_cpu_placement();
+	auto cpus = placement.cpus;
+	for (auto &box : placement.box_cpus) { cpus.insert(cpus.end(), box.second.begin(), box.second.end()); }
+	try {
+		helpers::exclude_cpus(cpus);
+	} catch (std::system_error &e) {
+		force_exit("Cannot reserve CPUs for sandboxes: " + std::string(e.what()));
+	}
+#endif
+}
+
+void worker_core::calibration_init()
+{
+	auto &config = config_->get_calibration();
+	if (!config.enabled) { return; }
+
+	logger_->info("Calibrating host...");
+	calibrator_ = std::make_shared<helpers::calibrator>(config);
+	auto scores = calibrator_->run();
+	logger_->info("Host calibrated: integer {:.0f}, floating {:.0f}, memory {:.0f}",
+		scores.integer,
+		scores.floating,
+		scores.memory);
+}
+
 void worker_core::log_init()
 {
 	auto log_conf = config_->get_log_config();
@@ -183,7 +217,7 @@ void worker_core::broker_init()
 	logger_->info("Initializing broker connection...");
 	auto broker_proxy = std::make_shared<connection_proxy>(zmq_context_);
 
-	broker_ = std::make_shared<broker_connection<connection_proxy>>(config_, broker_proxy, logger_);
+	broker_ = std::make_shared<broker_connection<connection_proxy>>(config_, broker_proxy, logger_, calibrator_);
 	logger_->info("Broker connection initialized.");
 
 	return;
@@ -204,8 +238,8 @@ void worker_core::receiver_init()
 {
 	logger_->info("Initializing job receiver and evaluator...");
 	auto progr_callback = std::make_shared<progress_callback>(zmq_context_, logger_);
-	auto evaluator =
-		std::make_shared<job_evaluator>(logger_, config_, remote_fm_, cache_fm_, working_directory_, progr_callback);
+	auto evaluator = std::make_shared<job_evaluator>(
+		logger_, config_, remote_fm_, cache_fm_, working_directory_, progr_callback, calibrator_);
 	job_receiver_ = std::make_shared<job_receiver>(zmq_context_, evaluator, logger_);
 	logger_->info("Job receiver and evaluator initialized.");
 	return;
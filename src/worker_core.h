@@ -111,6 +111,16 @@ private:
 	 */
 	void filesystem_init();
 
+	/**
+	 * Remove CPUs reserved for sandboxes from affinity of the worker, if they are exclusive.
+	 */
+	void placement_init();
+
+	/**
+	 * Run the calibration benchmark of the host, if enabled.
+	 */
+	void calibration_init();
+
 
 	// PRIVATE DATA MEMBERS
 	/** Cmd line parameters */
@@ -135,6 +145,9 @@ private:
 	/** Handles evaluation and all things around */
 	std::shared_ptr<job_receiver> job_receiver_;
 
+	/** Calibration of the host, nullptr if disabled */
+	std::shared_ptr<helpers::calibrator> calibrator_;
+
 	/** Handles connection to broker, receiving submission and pushing results */
 	std::shared_ptr<broker_connection<connection_proxy>> broker_;
 
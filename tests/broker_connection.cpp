@@ -41,6 +41,45 @@ TEST(broker_connection, sends_init)
 	connection.connect();
 }
 
+TEST(broker_connection, sends_init_with_calibration)
+{
+	auto config = std::make_shared<mock_worker_config>();
+	auto proxy = std::make_shared<StrictMock<mock_connection_proxy>>();
+	helpers::calibration_config calibration_config;
+	calibration_config.duration = 1;
+	auto calibrator = std::make_shared<helpers::calibrator>(calibration_config);
+	broker_connection<mock_connection_proxy> connection(config, proxy, nullptr, calibrator);
+	calibrator->run();
+
+	std::string addr("tcp://localhost:9876");
+	std::string description("linux_worker_1");
+	std::string hwgroup = "group_1";
+	worker_config::header_map_t headers = {std::make_pair("env", "c")};
+
+	EXPECT_CALL(*config, get_broker_uri()).WillRepeatedly(ReturnRef(addr));
+	EXPECT_CALL(*config, get_headers()).WillRepeatedly(ReturnRef(headers));
+	EXPECT_CALL(*config, get_worker_description()).WillRepeatedly(ReturnRef(description));
+	EXPECT_CALL(*config, get_hwgroup()).WillRepeatedly(ReturnRef(hwgroup));
+
+	{
+		InSequence s;
+
+		EXPECT_CALL(*proxy, connect(StrEq(addr)));
+		EXPECT_CALL(*proxy,
+			send_broker(ElementsAre("init",
+				hwgroup,
+				"env=c",
+				StartsWith("calibration-integer="),
+				StartsWith("calibration-floating="),
+				StartsWith("calibration-memory="),
+				"",
+				"description=linux_worker_1")))
+			.WillOnce(Return(true));
+	}
+
+	connection.connect();
+}
+
 ACTION(ClearFlags)
 {
 	((message_origin::set &) arg0).reset();
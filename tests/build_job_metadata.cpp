@@ -2,6 +2,8 @@
 #include <gmock/gmock.h>
 
 #include "helpers/config.h"
+#include "helpers/cbor.h"
+#include <sstream>
 
 using namespace testing;
 using namespace std;
@@ -13,12 +15,14 @@ TEST(job_metadata, build_all_from_yaml)
 							   "    job-id: eval5\n"
 							   "    file-collector: localhost\n"
 							   "    log: false\n"
+							   "    job-wall-time: 60\n"
 							   "    hw-groups:\n"
 							   "        - group1\n"
 							   "tasks:\n"
 							   "    - task-id: eval\n"
 							   "      priority: 4\n"
 							   "      fatal-failure: false\n"
+							   "      memoize: false\n"
 							   "      dependencies:\n"
 							   "          - fetch_test_1\n"
 							   "          - fetch_test_2\n"
@@ -59,12 +63,15 @@ TEST(job_metadata, build_all_from_yaml)
 	EXPECT_EQ(job_meta->log, false);
 	EXPECT_EQ(job_meta->hwgroups.size(), 1u);
 	EXPECT_EQ(job_meta->hwgroups.at(0), "group1");
+	EXPECT_EQ(job_meta->memoize, true);
+	EXPECT_EQ(job_meta->job_wall_time, 60);
 	EXPECT_EQ(job_meta->tasks.size(), 1u);
 
 	auto metadata = job_meta->tasks[0];
 	EXPECT_EQ(metadata->task_id, "eval");
 	EXPECT_EQ(metadata->priority, 4u);
 	EXPECT_EQ(metadata->fatal_failure, false);
+	EXPECT_EQ(metadata->memoize, false);
 	auto deps = std::vector<std::string>{"fetch_test_1", "fetch_test_2"};
 	EXPECT_EQ(metadata->dependencies, deps);
 	EXPECT_EQ(metadata->binary, "recodex");
@@ -104,6 +111,53 @@ TEST(job_metadata, build_all_from_yaml)
 	EXPECT_EQ(dirs, limits->bound_dirs[0]);
 }
 
+TEST(job_metadata, build_all_from_cbor)
+{
+	auto job_yaml = YAML::Load("submission:\n"
+							   "    job-id: eval5\n"
+							   "    file-collector: localhost\n"
+							   "    log: true\n"
+							   "    hw-groups:\n"
+							   "        - group1\n"
+							   "tasks:\n"
+							   "    - task-id: eval\n"
+							   "      priority: 4\n"
+							   "      test-id: \"01\"\n"
+							   "      cmd:\n"
+							   "          bin: recodex\n"
+							   "          args:\n"
+							   "              - -v\n"
+							   "      sandbox:\n"
+							   "          name: fake\n"
+							   "          limits:\n"
+							   "              - hw-group-id: group1\n"
+							   "                time: 0.1\n"
+							   "                memory: 60000\n");
+
+	// same configuration encoded as job-config.cbor
+	std::stringstream encoded;
+	helpers::cbor_writer writer(encoded);
+	writer.write_yaml(job_yaml);
+	auto job_meta = helpers::build_job_metadata(helpers::cbor_to_yaml(encoded.str()));
+
+	EXPECT_EQ(job_meta->job_id, "eval5");
+	EXPECT_EQ(job_meta->file_server_url, "localhost");
+	EXPECT_EQ(job_meta->log, true);
+	EXPECT_EQ(job_meta->hwgroups, std::vector<std::string>{"group1"});
+	EXPECT_EQ(job_meta->tasks.size(), 1u);
+
+	auto metadata = job_meta->tasks[0];
+	EXPECT_EQ(metadata->task_id, "eval");
+	EXPECT_EQ(metadata->priority, 4u);
+	EXPECT_EQ(metadata->test_id, "01");
+	EXPECT_EQ(metadata->binary, "recodex");
+	EXPECT_EQ(metadata->cmd_args, std::vector<std::string>{"-v"});
+
+	auto limits = metadata->sandbox->loaded_limits.at("group1");
+	EXPECT_FLOAT_EQ(limits->cpu_time, 0.1);
+	EXPECT_EQ(limits->memory_usage, 60000u);
+}
+
 TEST(job_metadata, queue_of_tasks)
 {
 	auto job_yaml = YAML::Load("---\n"
@@ -80,3 +80,23 @@ TEST(CacheManager, PutNonexistingFile)
 	EXPECT_THROW(m.put_file((tmp / "as4df.txt").string(), "as4df.txt"), fm_exception);
 	fs::remove_all((tmp / "recodex").string());
 }
+
+TEST(CacheManager, GetReadonlyFile)
+{
+	auto tmp = fs::temp_directory_path();
+	fs::create_directory(tmp / "recodex");
+	{
+		ofstream file((tmp / "recodex" / "test.txt").string());
+		file << "testing input" << endl;
+	}
+	cache_manager m((tmp / "recodex").string());
+
+	// file is shared with the cache, repeated fetch replaces it
+	EXPECT_NO_THROW(m.get_readonly_file("test.txt", (tmp / "test.txt").string()));
+	EXPECT_NO_THROW(m.get_readonly_file("test.txt", (tmp / "test.txt").string()));
+	EXPECT_TRUE(fs::equivalent(tmp / "test.txt", tmp / "recodex" / "test.txt"));
+	EXPECT_THROW(m.get_readonly_file("nonexist.txt", (tmp / "test.txt").string()), fm_exception);
+
+	fs::remove(tmp / "test.txt");
+	fs::remove_all(tmp / "recodex");
+}
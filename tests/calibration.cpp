@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "helpers/calibration.h"
+
+using namespace testing;
+
+
+TEST(calibration, run_suite)
+{
+	auto scores = helpers::run_calibration(std::chrono::milliseconds(10));
+	EXPECT_TRUE(scores.measured);
+	EXPECT_GT(scores.integer, 0);
+	EXPECT_GT(scores.floating, 0);
+	EXPECT_GT(scores.memory, 0);
+}
+
+TEST(calibration, calibrator)
+{
+	helpers::calibration_config config;
+	config.duration = 1;
+	helpers::calibrator calibrator(config);
+	EXPECT_FALSE(calibrator.get().measured);
+	EXPECT_TRUE(calibrator.get_headers().empty());
+
+	auto scores = calibrator.run();
+	EXPECT_DOUBLE_EQ(scores.integer, calibrator.get().integer);
+	EXPECT_THAT(calibrator.get_headers(),
+		ElementsAre(StartsWith("calibration-integer="),
+			StartsWith("calibration-floating="),
+			StartsWith("calibration-memory=")));
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <fstream>
+#include <filesystem>
+
+#include "helpers/cgroup.h"
+
+namespace fs = std::filesystem;
+
+
+TEST(cgroup_test, read_metrics)
+{
+	auto dir = fs::temp_directory_path() / "recodex_cgroup_test";
+	fs::remove_all(dir);
+	fs::create_directories(dir);
+	std::ofstream(dir / "cpu.stat") << "usage_usec 1500000\nuser_usec 1000000\nsystem_usec 500000\n"
+									   "nr_periods 10\nnr_throttled 3\nthrottled_usec 250000\n";
+	std::ofstream(dir / "memory.peak") << "2097152\n";
+	std::ofstream(dir / "memory.current") << "1048576\n";
+	std::ofstream(dir / "memory.events") << "low 0\nhigh 0\nmax 4\noom 2\noom_kill 1\n";
+	std::ofstream(dir / "io.stat") << "8:0 rbytes=100 wbytes=200 rios=1 wios=2 dbytes=0 dios=0\n"
+									  "8:16 rbytes=1000 wbytes=2000 rios=1 wios=2 dbytes=0 dios=0\n";
+
+	auto metrics = helpers::read_cgroup_metrics(dir);
+	ASSERT_NE(nullptr, metrics);
+	EXPECT_FLOAT_EQ(1.5, metrics->cpu_usage);
+	EXPECT_FLOAT_EQ(1.0, metrics->cpu_user);
+	EXPECT_FLOAT_EQ(0.5, metrics->cpu_system);
+	EXPECT_EQ(3u, metrics->throttled_periods);
+	EXPECT_FLOAT_EQ(0.25, metrics->throttled_time);
+	EXPECT_EQ(2048u, metrics->memory_peak);
+	EXPECT_EQ(2u, metrics->oom);
+	EXPECT_EQ(1u, metrics->oom_kill);
+	EXPECT_EQ(1100u, metrics->io_read);
+	EXPECT_EQ(2200u, metrics->io_write);
+	EXPECT_EQ(1024u, helpers::read_cgroup_memory(dir));
+	EXPECT_DOUBLE_EQ(1.5, helpers::read_cgroup_cpu_time(dir));
+
+	fs::remove_all(dir);
+}
+
+TEST(cgroup_test, missing_files)
+{
+	auto dir = fs::temp_directory_path() / "recodex_cgroup_test";
+	fs::remove_all(dir);
+	EXPECT_EQ(nullptr, helpers::read_cgroup_metrics(dir));
+	EXPECT_EQ(0u, helpers::read_cgroup_memory(dir));
+	EXPECT_DOUBLE_EQ(0, helpers::read_cgroup_cpu_time(dir));
+
+	// controllers which are not enabled have no files
+	fs::create_directories(dir);
+	auto metrics = helpers::read_cgroup_metrics(dir);
+	ASSERT_NE(nullptr, metrics);
+	EXPECT_EQ(0u, metrics->memory_peak);
+	EXPECT_EQ(0u, metrics->io_read);
+	fs::remove_all(dir);
+}
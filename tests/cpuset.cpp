@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#include "helpers/cpuset.h"
+
+using namespace std;
+
+
+TEST(cpuset_test, parse_cpu_list)
+{
+	EXPECT_EQ(vector<size_t>({}), helpers::parse_cpu_list(""));
+	EXPECT_EQ(vector<size_t>({3}), helpers::parse_cpu_list("3"));
+	EXPECT_EQ(vector<size_t>({0, 1, 2, 3, 8, 10, 11}), helpers::parse_cpu_list("10-11,0-3,8"));
+	EXPECT_EQ(vector<size_t>({1, 2}), helpers::parse_cpu_list("1,2,1-2"));
+
+	EXPECT_THROW(helpers::parse_cpu_list("a"), invalid_argument);
+	EXPECT_THROW(helpers::parse_cpu_list("1,,2"), invalid_argument);
+	EXPECT_THROW(helpers::parse_cpu_list("3-1"), invalid_argument);
+	EXPECT_THROW(helpers::parse_cpu_list("1-"), invalid_argument);
+	EXPECT_THROW(helpers::parse_cpu_list("1x"), invalid_argument);
+}
+
+TEST(cpuset_test, format_cpu_list)
+{
+	EXPECT_EQ("", helpers::format_cpu_list({}));
+	EXPECT_EQ("0,2,3", helpers::format_cpu_list({0, 2, 3}));
+}
+
+TEST(cpuset_test, box_cpus)
+{
+	helpers::cpu_placement placement;
+	placement.cpus = {0, 1};
+	placement.box_cpus[100] = {1};
+
+	EXPECT_EQ(vector<size_t>({1}), placement.get_cpus(100));
+	EXPECT_EQ(vector<size_t>({0, 1}), placement.get_cpus(101));
+}
+
+#ifndef _WIN32
+TEST(cpuset_test, scoped_placement)
+{
+	cpu_set_t original;
+	ASSERT_EQ(0, sched_getaffinity(0, sizeof(original), &original));
+	size_t cpu = 0;
+	while (!CPU_ISSET(cpu, &original)) { ++cpu; }
+
+	{
+		helpers::scoped_placement placement({cpu}, {});
+		cpu_set_t current;
+		ASSERT_EQ(0, sched_getaffinity(0, sizeof(current), &current));
+		EXPECT_EQ(1, CPU_COUNT(&current));
+		EXPECT_TRUE(CPU_ISSET(cpu, &current));
+	}
+
+	cpu_set_t restored;
+	ASSERT_EQ(0, sched_getaffinity(0, sizeof(restored), &restored));
+	EXPECT_TRUE(CPU_EQUAL(&original, &restored));
+}
+#endif
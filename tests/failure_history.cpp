@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <filesystem>
+
+#include "job/failure_history.h"
+
+using namespace testing;
+using namespace std;
+
+
+static shared_ptr<task_results> result_with_status(task_status status)
+{
+	auto result = make_shared<task_results>();
+	result->status = status;
+	return result;
+}
+
+TEST(failure_history, compute_key)
+{
+	auto config = YAML::Load("submission:\n"
+							 "    job-id: eval5\n"
+							 "tasks:\n"
+							 "    - task-id: run\n");
+	auto other = YAML::Load("submission:\n"
+							"    job-id: eval6\n"
+							"tasks:\n"
+							"    - task-id: run\n");
+	EXPECT_EQ(failure_history::compute_key(config), failure_history::compute_key(other));
+
+	other["tasks"][0]["task-id"] = "judge";
+	EXPECT_NE(failure_history::compute_key(config), failure_history::compute_key(other));
+}
+
+TEST(failure_history, record_and_apply)
+{
+	auto file = fs::temp_directory_path() / "recodex_failure_history.yml";
+	fs::remove(file);
+
+	job_metadata job_meta;
+	job_meta.tasks.push_back(make_shared<task_metadata>("fetch", 1));
+	job_meta.tasks.push_back(make_shared<task_metadata>("run1", 1));
+	job_meta.tasks.back()->test_id = "A";
+	job_meta.tasks.push_back(make_shared<task_metadata>("run2", 1));
+	job_meta.tasks.back()->test_id = "B";
+	job_meta.tasks.push_back(make_shared<task_metadata>("judge2", 1));
+	job_meta.tasks.back()->test_id = "B";
+
+	{
+		failure_history history(file);
+		history.record("exercise",
+			job_meta,
+			{{"fetch", result_with_status(task_status::OK)},
+				{"run1", result_with_status(task_status::OK)},
+				{"run2", result_with_status(task_status::OK)},
+				{"judge2", result_with_status(task_status::FAILED)}});
+		history.record("exercise",
+			job_meta,
+			{{"fetch", result_with_status(task_status::OK)},
+				{"run1", result_with_status(task_status::FAILED)},
+				{"run2", result_with_status(task_status::SKIPPED)},
+				{"judge2", result_with_status(task_status::SKIPPED)}});
+	}
+
+	// history is loaded back from the file
+	failure_history history(file);
+	EXPECT_DOUBLE_EQ(0.5, history.get_failure_rate("exercise", "A"));
+	EXPECT_DOUBLE_EQ(1.0, history.get_failure_rate("exercise", "B"));
+	EXPECT_DOUBLE_EQ(0.0, history.get_failure_rate("exercise", "C"));
+	EXPECT_DOUBLE_EQ(0.0, history.get_failure_rate("other", "A"));
+
+	history.apply("exercise", job_meta);
+	EXPECT_DOUBLE_EQ(0.0, job_meta.tasks[0]->order_hint);
+	EXPECT_DOUBLE_EQ(0.5, job_meta.tasks[1]->order_hint);
+	EXPECT_DOUBLE_EQ(1.0, job_meta.tasks[2]->order_hint);
+	EXPECT_DOUBLE_EQ(1.0, job_meta.tasks[3]->order_hint);
+
+	fs::remove(file);
+}
@@ -84,3 +84,22 @@ TEST(fallback_file_manager, PutOperationFailed)
 	fallback_file_manager m(move(cache), move(remote));
 	EXPECT_THROW(m.put_file(local_path, remote_path), fm_exception);
 }
+
+TEST(fallback_file_manager, GetReadonlyFileFromRemote)
+{
+	auto cache = unique_ptr<mock_file_manager>(new mock_file_manager);
+	auto remote = unique_ptr<mock_file_manager>(new StrictMock<mock_file_manager>);
+
+	std::string remote_path = "file.txt";
+	std::string local_path = "/tmp/file.txt";
+
+	{
+		InSequence s;
+		EXPECT_CALL((*cache), get_readonly_file(remote_path, local_path)).WillOnce(Throw(fm_exception("")));
+		EXPECT_CALL((*remote), get_file(remote_path, local_path)).Times(1);
+		EXPECT_CALL((*cache), put_file(local_path, remote_path)).Times(1);
+	}
+
+	fallback_file_manager m(move(cache), move(remote));
+	EXPECT_NO_THROW(m.get_readonly_file(remote_path, local_path));
+}
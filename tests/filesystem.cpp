@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <fstream>
 
 #include "helpers/filesystem.h"
 
@@ -142,3 +143,97 @@ TEST(filesystem_test, test_absolute_8)
 		(fs::path("/path/outside/sandbox") / fs::path("test1") / fs::path("sub") / fs::path("output.stderr")).string(),
 		result.string());
 }
+
+TEST(filesystem_test, remove_symlinks)
+{
+	auto dir = fs::temp_directory_path() / "recodex_remove_symlinks";
+	fs::remove_all(dir);
+	fs::create_directories(dir / "sub");
+	std::ofstream(dir / "sub" / "file.txt") << "data";
+	fs::create_symlink("/etc/passwd", dir / "passwd");
+	fs::create_directory_symlink("/etc", dir / "sub" / "etc");
+
+	helpers::remove_symlinks(dir);
+
+	EXPECT_TRUE(fs::exists(dir / "sub" / "file.txt"));
+	EXPECT_FALSE(fs::exists(fs::symlink_status(dir / "passwd")));
+	EXPECT_FALSE(fs::exists(fs::symlink_status(dir / "sub" / "etc")));
+	EXPECT_TRUE(fs::exists("/etc/passwd"));
+	fs::remove_all(dir);
+}
+
+TEST(filesystem_test, clone_file)
+{
+	auto dir = fs::temp_directory_path() / "recodex_clone_file";
+	fs::remove_all(dir);
+	fs::create_directories(dir);
+	std::ofstream(dir / "source.txt") << "data";
+	fs::permissions(dir / "source.txt", fs::perms::owner_read | fs::perms::owner_write | fs::perms::owner_exec);
+
+	helpers::clone_file(dir / "source.txt", dir / "clone.txt");
+	std::ofstream(dir / "source.txt", std::ios::app) << " changed";
+
+	// clone is independent on the source and keeps its permissions
+	std::string content;
+	std::ifstream(dir / "clone.txt") >> content;
+	EXPECT_EQ("data", content);
+	EXPECT_EQ(fs::status(dir / "source.txt").permissions(), fs::status(dir / "clone.txt").permissions());
+	EXPECT_THROW(helpers::clone_file(dir / "source.txt", dir / "clone.txt"), fs::filesystem_error);
+	EXPECT_THROW(helpers::clone_file(dir / "nonexisting.txt", dir / "other.txt"), fs::filesystem_error);
+	fs::remove_all(dir);
+}
+
+TEST(filesystem_test, is_tmpfs)
+{
+	EXPECT_FALSE(helpers::is_tmpfs("/nonexistent/recodex"));
+#ifdef __linux__
+	EXPECT_FALSE(helpers::is_tmpfs("/proc"));
+	if (fs::is_directory("/dev/shm")) { EXPECT_TRUE(helpers::is_tmpfs("/dev/shm")); }
+#endif
+}
+
+TEST(filesystem_test, read_file_bounded)
+{
+	auto file = fs::temp_directory_path() / "recodex_read_bounded.txt";
+	std::ofstream(file) << "0123456789";
+
+	EXPECT_EQ("0123456789", helpers::read_file_bounded(file, 100));
+	EXPECT_EQ("0123456789", helpers::read_file_bounded(file, 10, 3));
+	EXPECT_EQ("0123", helpers::read_file_bounded(file, 4));
+	EXPECT_EQ("01789", helpers::read_file_bounded(file, 5, 3));
+	EXPECT_EQ("89", helpers::read_file_bounded(file, 2, 5));
+	EXPECT_EQ("", helpers::read_file_bounded(file, 0));
+	EXPECT_EQ("", helpers::read_file_bounded(fs::temp_directory_path() / "recodex_nonexisting.txt", 100));
+
+	std::ofstream(file, std::ios::trunc).close();
+	EXPECT_EQ("", helpers::read_file_bounded(file, 100));
+	fs::remove(file);
+}
+
+TEST(filesystem_test, copy_file_bounded)
+{
+	auto file = fs::temp_directory_path() / "recodex_copy_bounded.txt";
+	auto copy = fs::temp_directory_path() / "recodex_copy_bounded_copy.txt";
+	std::string content(100000, 'x');
+	content += "end";
+	std::ofstream(file) << content;
+
+	EXPECT_EQ(content.size(), helpers::copy_file_bounded(file, copy, 1000000));
+	EXPECT_EQ(content, helpers::read_file_bounded(copy, 1000000));
+
+	// longer file is cut, previous content of the copy is replaced
+	EXPECT_EQ(5u, helpers::copy_file_bounded(file, copy, 5));
+	EXPECT_EQ("xxxxx", helpers::read_file_bounded(copy, 100));
+
+	EXPECT_EQ(0u, helpers::copy_file_bounded(file, copy, 0));
+	EXPECT_TRUE(fs::exists(copy));
+	EXPECT_EQ(0u, fs::file_size(copy));
+
+	// missing source gives empty copy
+	helpers::copy_file_bounded(file, copy, 5);
+	EXPECT_EQ(0u, helpers::copy_file_bounded(fs::temp_directory_path() / "recodex_nonexisting.txt", copy, 100));
+	EXPECT_EQ(0u, fs::file_size(copy));
+
+	fs::remove(file);
+	fs::remove(copy);
+}
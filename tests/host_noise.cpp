@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <fstream>
+#include <filesystem>
+
+#include "helpers/host_noise.h"
+
+namespace fs = std::filesystem;
+
+
+class host_noise_test : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		root_ = fs::temp_directory_path() / "recodex_host_noise_test";
+		fs::remove_all(root_);
+		fs::create_directories(root_ / "proc");
+		fs::create_directories(root_ / "sys" / "devices" / "system" / "cpu" / "cpufreq");
+		write_state(1000, 0, 2000000);
+	}
+
+	void TearDown() override
+	{
+		fs::remove_all(root_);
+	}
+
+	/** Write /proc/stat of two CPUs with given total and steal ticks and frequency of both CPUs (kHz) */
+	void write_state(std::size_t total, std::size_t steal, std::size_t khz, const std::string &load = "0.50")
+	{
+		std::ofstream(root_ / "proc" / "stat") << "cpu  " << total - steal << " 0 0 0 0 0 0 " << steal << " 0 0\n"
+											   << "cpu0 1 0 0 0 0 0 0 0 0 0\ncpu1 1 0 0 0 0 0 0 0 0 0\nintr 5\n";
+		std::ofstream(root_ / "proc" / "loadavg") << load << " 0.40 0.30 1/100 1234\n";
+		for (auto cpu : {"cpu0", "cpu1"}) {
+			auto dir = root_ / "sys" / "devices" / "system" / "cpu" / cpu / "cpufreq";
+			fs::create_directories(dir);
+			std::ofstream(dir / "scaling_cur_freq") << khz << "\n";
+		}
+	}
+
+	fs::path root_;
+};
+
+TEST_F(host_noise_test, quiet_host)
+{
+	helpers::host_monitor monitor(root_ / "proc", root_ / "sys");
+	write_state(2000, 10, 1950000);
+
+	auto context = monitor.finish(helpers::host_noise_limits(), nullptr);
+	ASSERT_NE(nullptr, context);
+	EXPECT_FLOAT_EQ(0.01, context->steal);
+	EXPECT_EQ(2000u, context->frequency_start);
+	EXPECT_EQ(1950u, context->frequency_end);
+	EXPECT_FLOAT_EQ(0.5, context->load);
+	EXPECT_FALSE(context->tainted);
+	EXPECT_TRUE(context->taints.empty());
+}
+
+TEST_F(host_noise_test, noisy_host)
+{
+	write_state(1000, 100, 3000000);
+	helpers::host_monitor monitor(root_ / "proc", root_ / "sys");
+	write_state(2000, 300, 2000000, "4.00");
+
+	cgroup_metrics cgroup;
+	cgroup.throttled_periods = 2;
+	cgroup.throttled_time = 0.1;
+	auto context = monitor.finish(helpers::host_noise_limits(), &cgroup);
+	EXPECT_FLOAT_EQ(0.2, context->steal);
+	EXPECT_EQ(2u, context->throttled_periods);
+	EXPECT_TRUE(context->tainted);
+	EXPECT_EQ(std::vector<std::string>({"steal", "frequency", "load", "throttling"}), context->taints);
+
+	// higher thresholds
+	helpers::host_noise_limits limits;
+	limits.max_steal = 0.5;
+	limits.max_frequency_change = 0.5;
+	limits.max_load = 2;
+	limits.max_throttled = 1;
+	EXPECT_FALSE(monitor.finish(limits, &cgroup)->tainted);
+}
+
+TEST_F(host_noise_test, missing_files)
+{
+	helpers::host_monitor monitor(root_ / "nonexisting", root_ / "nonexisting");
+	auto context = monitor.finish(helpers::host_noise_limits(), nullptr);
+	EXPECT_EQ(0u, context->frequency_start);
+	EXPECT_FLOAT_EQ(0, context->load);
+	EXPECT_FALSE(context->tainted);
+}
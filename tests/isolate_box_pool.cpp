@@ -0,0 +1,135 @@
+#ifndef _WIN32
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <mutex>
+#include <map>
+#include <fstream>
+#include <filesystem>
+#include <cstdlib>
+
+#include "sandbox/isolate_box_pool.h"
+#include "sandbox/isolate_sandbox.h"
+
+using namespace testing;
+using namespace std;
+namespace fs = std::filesystem;
+
+
+/**
+ * Fake isolate which only counts initializations and cleanups of boxes.
+ */
+class fake_isolate
+{
+public:
+	isolate_box_pool::init_function init()
+	{
+		return [this](size_t id) {
+			lock_guard<mutex> lock(mutex_);
+			if (id == failing_id) { throw std::runtime_error("init failed"); }
+			++inits[id];
+			return "/box/" + to_string(id);
+		};
+	}
+
+	isolate_box_pool::cleanup_function cleanup()
+	{
+		return [this](size_t id) {
+			lock_guard<mutex> lock(mutex_);
+			++cleanups[id];
+		};
+	}
+
+	map<size_t, size_t> inits;
+	map<size_t, size_t> cleanups;
+	size_t failing_id = SIZE_MAX;
+
+private:
+	mutex mutex_;
+};
+
+TEST(isolate_box_pool, acquire_and_release)
+{
+	fake_isolate isolate;
+	{
+		isolate_box_pool pool({10, 11}, nullptr, isolate.init(), isolate.cleanup());
+
+		isolate_box_pool::box first, second;
+		ASSERT_TRUE(pool.acquire(first));
+		ASSERT_TRUE(pool.acquire(second));
+		EXPECT_NE(first.id, second.id);
+		EXPECT_EQ("/box/" + to_string(first.id), first.sandboxed_dir);
+
+		// released box is recycled and can be taken again
+		pool.release(first.id);
+		isolate_box_pool::box again;
+		ASSERT_TRUE(pool.acquire(again));
+		EXPECT_EQ(first.id, again.id);
+		pool.release(again.id);
+		pool.release(second.id);
+	}
+
+	// every initialized box is cleaned up at the end
+	for (auto &init : isolate.inits) { EXPECT_EQ(init.second + 1, isolate.cleanups[init.first]); }
+}
+
+TEST(isolate_box_pool, failed_init)
+{
+	fake_isolate isolate;
+	isolate.failing_id = 11;
+	isolate_box_pool pool({10, 11}, nullptr, isolate.init(), isolate.cleanup());
+
+	isolate_box_pool::box box;
+	ASSERT_TRUE(pool.acquire(box));
+	EXPECT_EQ(10u, box.id);
+
+	// the other box is unusable and the only usable one is taken
+	pool.release(box.id);
+	ASSERT_TRUE(pool.acquire(box));
+	EXPECT_EQ(10u, box.id);
+}
+
+TEST(isolate_box_pool, all_failed)
+{
+	fake_isolate isolate;
+	isolate.failing_id = 10;
+	isolate_box_pool pool({10}, nullptr, isolate.init(), isolate.cleanup());
+
+	isolate_box_pool::box box;
+	EXPECT_FALSE(pool.acquire(box));
+}
+
+TEST(isolate_box_pool, default_isolate_functions)
+{
+	// fake isolate binary which prints box directory on init and fails cleanup of box 12
+	auto dir = fs::temp_directory_path() / "recodex_fake_isolate";
+	fs::create_directories(dir);
+	{
+		std::ofstream script((dir / "isolate").string());
+		script << "#!/bin/sh\n"
+			   << "case \"$*\" in\n"
+			   << "  *--init*) echo \"/var/fake/${2#--box-id=}\" ;;\n"
+			   << "  *--box-id=12*) exit 2 ;;\n"
+			   << "esac\n";
+	}
+	fs::permissions(dir / "isolate", fs::perms::owner_all);
+	std::string path = getenv("PATH");
+	setenv("PATH", (dir.string() + ":" + path).c_str(), 1);
+
+	EXPECT_EQ("/var/fake/11/box", isolate_sandbox::init_box(11, sandbox_limits(), helpers::create_null_logger()));
+	EXPECT_NO_THROW(isolate_sandbox::cleanup_box(11, helpers::create_null_logger()));
+	EXPECT_THROW(isolate_sandbox::cleanup_box(12, helpers::create_null_logger()), sandbox_exception);
+
+	{
+		isolate_box_pool pool({11});
+		isolate_box_pool::box box;
+		ASSERT_TRUE(pool.acquire(box));
+		EXPECT_EQ("/var/fake/11/box", box.sandboxed_dir);
+		pool.release(box.id);
+	}
+
+	setenv("PATH", path.c_str(), 1);
+	fs::remove_all(dir);
+}
+
+#endif
@@ -180,5 +180,40 @@ TEST(IsolateSandbox, BindDirsExecuteGCC)
 	fs::remove_all(tmp / "recodex_35_test");
 }
 
+TEST(IsolateSandbox, RenameDataDir)
+{
+	auto tmp = fs::temp_directory_path();
+	std::shared_ptr<sandbox_config> config = std::make_shared<sandbox_config>();
+	config->std_output = "output.txt";
+	config->chdir = "";
+	sandbox_limits limits;
+	limits.wall_time = 10;
+	limits.cpu_time = 10;
+	limits.extra_time = 1;
+	limits.processes = 0;
+	limits.bound_dirs = {};
+
+	fs::create_directories(tmp / "recodex_36_test");
+	std::ofstream((tmp / "recodex_36_test" / "input.txt").string()) << "data";
+	fs::create_symlink("/etc/passwd", tmp / "recodex_36_test" / "passwd");
+
+	isolate_sandbox *is = nullptr;
+	auto data_dir = (tmp / "recodex_36_test").string();
+	isolate_options options;
+	options.rename_data = true;
+	EXPECT_NO_THROW(is = new isolate_sandbox(config, limits, 36, tmp.string(), data_dir, nullptr, options));
+	sandbox_results results;
+	EXPECT_NO_THROW(results = is->run("/bin/ls", std::vector<std::string>{}));
+
+	// data are back in place (renamed or copied if the box is on other filesystem), symlinks are dropped
+	EXPECT_TRUE(results.status == isolate_status::OK);
+	EXPECT_TRUE(fs::is_regular_file(tmp / "recodex_36_test" / "input.txt"));
+	EXPECT_TRUE(fs::file_size(tmp / "recodex_36_test" / "output.txt") > 0);
+	EXPECT_FALSE(fs::exists(fs::symlink_status(tmp / "recodex_36_test" / "passwd")));
+	EXPECT_TRUE(fs::is_directory(is->get_dir()));
+	delete is;
+	fs::remove_all(tmp / "recodex_36_test");
+}
+
 
 #endif
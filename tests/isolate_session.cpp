@@ -0,0 +1,170 @@
+#ifndef _WIN32
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <fstream>
+#include <filesystem>
+#include <cstdlib>
+
+#include "sandbox/isolate_sandbox.h"
+
+namespace fs = std::filesystem;
+
+
+/**
+ * Fake isolate in PATH which creates boxes in a temporary directory, logs initializations and cleanups and on run
+ * only creates file "ran" in the box and a meta file and writes to its standard output and error.
+ */
+class IsolateSession : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		root_ = fs::temp_directory_path() / "recodex_isolate_session";
+		fs::create_directories(root_ / "bin");
+		fs::create_directories(root_ / "data");
+		std::ofstream((root_ / "data" / "input.txt").string()) << "input";
+		{
+			std::ofstream script((root_ / "bin" / "isolate").string());
+			script << "#!/bin/sh\n"
+				   << "root=" << root_.string() << "\n"
+				   << "for arg; do\n"
+				   << "  case \"$arg\" in\n"
+				   << "    --box-id=*) box=\"${arg#--box-id=}\" ;;\n"
+				   << "    --meta=*) meta=\"${arg#--meta=}\" ;;\n"
+				   << "    --init) mkdir -p \"$root/boxes/$box/box\"; echo init >> \"$root/log\";"
+				   << " echo \"$root/boxes/$box\"; exit 0 ;;\n"
+				   << "    --cleanup) rm -rf \"$root/boxes/$box\"; echo cleanup >> \"$root/log\"; exit 0 ;;\n"
+				   << "    --run) touch \"$root/boxes/$box/box/ran\"; echo 'time:0.1' > \"$meta\";"
+				   << " echo \"$*\" > \"$root/args\"; echo output; echo error >&2; exit 0 ;;\n"
+				   << "  esac\n"
+				   << "done\n";
+		}
+		fs::permissions(root_ / "bin" / "isolate", fs::perms::owner_all);
+		path_ = getenv("PATH");
+		setenv("PATH", ((root_ / "bin").string() + ":" + path_).c_str(), 1);
+		config_ = std::make_shared<sandbox_config>();
+	}
+
+	void TearDown() override
+	{
+		setenv("PATH", path_.c_str(), 1);
+		fs::remove_all(root_);
+	}
+
+	sandbox_results run(std::shared_ptr<isolate_session> session,
+		const fs::path &data_dir,
+		const sandbox_limits &limits = sandbox_limits())
+	{
+		isolate_options options;
+		options.session = session;
+		isolate_sandbox sandbox(config_, limits, 37, (root_ / "tmp").string(), data_dir.string(), nullptr, options);
+		sandbox.set_output_capture(stdout_capture_, stderr_capture_);
+		return sandbox.run("/bin/true", {});
+	}
+
+	std::size_t count(const std::string &what)
+	{
+		std::ifstream log((root_ / "log").string());
+		std::size_t result = 0;
+		for (std::string line; std::getline(log, line);) {
+			if (line == what) { ++result; }
+		}
+		return result;
+	}
+
+	fs::path root_;
+	std::string path_;
+	std::shared_ptr<sandbox_config> config_;
+	std::shared_ptr<helpers::output_buffer> stdout_capture_;
+	std::shared_ptr<helpers::output_buffer> stderr_capture_;
+};
+
+TEST_F(IsolateSession, DataStayInBox)
+{
+	auto session = std::make_shared<isolate_session>();
+	auto box = root_ / "boxes" / "37" / "box";
+
+	EXPECT_EQ(isolate_status::OK, run(session, root_ / "data").status);
+	EXPECT_FALSE(fs::exists(root_ / "data"));
+	EXPECT_TRUE(fs::exists(box / "input.txt"));
+	EXPECT_EQ((root_ / "data").string(), session->get_data_dir());
+
+	// second task reuses both the box and the data
+	fs::remove(box / "ran");
+	EXPECT_EQ(isolate_status::OK, run(session, root_ / "data").status);
+	EXPECT_TRUE(fs::exists(box / "ran"));
+	EXPECT_EQ(1u, count("init"));
+	EXPECT_EQ(0u, count("cleanup"));
+
+	// data are moved back, the box stays open
+	session->sync();
+	EXPECT_TRUE(session->get_data_dir().empty());
+	EXPECT_TRUE(fs::exists(root_ / "data" / "input.txt"));
+	EXPECT_TRUE(fs::exists(root_ / "data" / "ran"));
+	EXPECT_FALSE(fs::exists(box / "input.txt"));
+
+	EXPECT_EQ(isolate_status::OK, run(session, root_ / "data").status);
+	EXPECT_EQ(1u, count("init"));
+
+	session->close();
+	EXPECT_TRUE(fs::exists(root_ / "data" / "input.txt"));
+	EXPECT_EQ(1u, count("cleanup"));
+}
+
+TEST_F(IsolateSession, DifferentDataDir)
+{
+	auto session = std::make_shared<isolate_session>();
+	fs::create_directories(root_ / "other");
+	std::ofstream((root_ / "other" / "other.txt").string()) << "other";
+
+	run(session, root_ / "data");
+	run(session, root_ / "other");
+
+	// data of the first task are moved back before the second one
+	EXPECT_TRUE(fs::exists(root_ / "data" / "input.txt"));
+	EXPECT_FALSE(fs::exists(root_ / "other"));
+	EXPECT_EQ((root_ / "other").string(), session->get_data_dir());
+	EXPECT_EQ(1u, count("init"));
+
+	// destruction closes the session
+	session = nullptr;
+	EXPECT_TRUE(fs::exists(root_ / "other" / "other.txt"));
+	EXPECT_EQ(1u, count("cleanup"));
+}
+
+TEST_F(IsolateSession, DiskQuotasReopenBox)
+{
+	auto session = std::make_shared<isolate_session>();
+	run(session, root_ / "data");
+
+	sandbox_limits limits;
+	limits.disk_quotas = true;
+	run(session, root_ / "data", limits);
+	EXPECT_EQ(2u, count("init"));
+	EXPECT_EQ(1u, count("cleanup"));
+
+	session->close();
+	EXPECT_EQ(2u, count("cleanup"));
+	EXPECT_TRUE(fs::exists(root_ / "data" / "input.txt"));
+}
+
+TEST_F(IsolateSession, OutputCapture)
+{
+	// the program inherits the pipes from isolate, which does not redirect them and stays silent
+	stdout_capture_ = std::make_shared<helpers::output_buffer>(100);
+	stderr_capture_ = std::make_shared<helpers::output_buffer>(100);
+	config_->std_output = "ignored.txt";
+	EXPECT_EQ(isolate_status::OK, run(nullptr, root_ / "data").status);
+	EXPECT_EQ("output\n", stdout_capture_->str());
+	EXPECT_EQ("error\n", stderr_capture_->str());
+
+	std::ifstream args((root_ / "args").string());
+	std::string line;
+	std::getline(args, line);
+	EXPECT_NE(std::string::npos, line.find("--silent"));
+	EXPECT_EQ(std::string::npos, line.find("--stdout"));
+	EXPECT_EQ(std::string::npos, line.find("--stderr"));
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <fstream>
 #include <type_traits>
 #include <filesystem>
+#include <thread>
 
 #include "mocks.h"
 #include "job/job.h"
@@ -40,6 +41,7 @@ sandbox_limits get_default_limits()
 	default_limits.processes = 11;
 	default_limits.disk_size = 150;
 	default_limits.disk_files = 17;
+	default_limits.instructions = 18000000000;
 	default_limits.environ_vars = {{"WORKER_CONFIG", "worker_config"}};
 	default_limits.bound_dirs = {
 		mytuple{"/tmp/recodex/worker_config", "/recodex/worker_config", sandbox_limits::dir_perm::RW}};
@@ -103,6 +105,7 @@ std::shared_ptr<job_metadata> get_worker_default_meta()
 	set_limits->processes = SIZE_MAX;
 	set_limits->disk_size = SIZE_MAX;
 	set_limits->disk_files = SIZE_MAX;
+	set_limits->instructions = SIZE_MAX;
 	set_limits->environ_vars = std::vector<std::pair<std::string, std::string>>{{"JOB_CONFIG", "job_config"}};
 	set_limits->bound_dirs =
 		std::vector<mytuple>{mytuple{"/tmp/recodex/job_config", "/recodex/job_config", sandbox_limits::dir_perm::RW}};
@@ -376,6 +379,7 @@ TEST(job_test, load_of_worker_defaults)
 	ASSERT_EQ(limits->processes, 11u);
 	ASSERT_EQ(limits->disk_size, 150u);
 	ASSERT_EQ(limits->disk_files, 17u);
+	ASSERT_EQ(limits->instructions, 18000000000u);
 
 	std::vector<std::pair<std::string, std::string>> expected_environs;
 	if (limits->environ_vars.at(0).first == "JOB_CONFIG") {
@@ -462,6 +466,17 @@ TEST(job_test, exceeded_worker_defaults)
 	job_meta->tasks[0]->sandbox->loaded_limits["group1"]->disk_files = 28;
 	EXPECT_THROW(job(job_meta, worker_conf, dir_root, dir, temp_directory_path(), factory, nullptr), job_exception);
 
+	// instructions exceeded worker defaults
+	EXPECT_CALL((*factory), create_internal_task(0, _)).WillOnce(Return(empty_task));
+	job_meta->tasks[0]->sandbox->loaded_limits["group1"]->disk_files = 2;
+	job_meta->tasks[0]->sandbox->loaded_limits["group1"]->instructions = 19000000000;
+	EXPECT_THROW(job(job_meta, worker_conf, dir_root, dir, temp_directory_path(), factory, nullptr), job_exception);
+
+	// instructions within worker defaults, but the sandbox cannot count them
+	EXPECT_CALL((*factory), create_internal_task(0, _)).WillOnce(Return(empty_task));
+	job_meta->tasks[0]->sandbox->loaded_limits["group1"]->instructions = 1000;
+	EXPECT_THROW(job(job_meta, worker_conf, dir_root, dir, temp_directory_path(), factory, nullptr), job_exception);
+
 	// cleanup after yourself
 	remove_all(dir_root);
 }
@@ -790,3 +805,224 @@ TEST(job_test, job_variables)
 	// cleanup after yourself
 	remove_all(dir_root);
 }
+
+TEST(job_test, readonly_data)
+{
+	path dir_root = temp_directory_path() / "isoeval";
+	path dir = dir_root / "job_test";
+	path res_dir = dir_root / "job_test_results";
+	auto worker_conf = std::make_shared<mock_worker_config>();
+	auto factory = std::make_shared<mock_task_factory>();
+
+	auto job_meta = get_correct_meta();
+	auto fetch_meta = get_simple_task("fetch", 5, {});
+	fetch_meta->binary = "fetch-ro";
+	fetch_meta->cmd_args = {"abcdef", "${DATA_DIR}/01.in"};
+	job_meta->tasks.push_back(fetch_meta);
+	job_meta->tasks[0]->sandbox->std_input = "${EVAL_DATA_DIR}/01.in";
+
+	auto default_limits = get_default_limits();
+	std::string group_name = "group1";
+	EXPECT_CALL((*worker_conf), get_hwgroup()).WillRepeatedly(ReturnRef(group_name));
+	EXPECT_CALL((*worker_conf), get_worker_id()).WillRepeatedly(Return(8));
+	EXPECT_CALL((*worker_conf), get_limits()).WillRepeatedly(ReturnRef(default_limits));
+
+	create_directories(dir);
+	create_directories(res_dir);
+	std::ofstream((dir / "hello").string()) << "hello" << std::endl;
+
+	EXPECT_CALL((*factory), create_internal_task(0, _)).WillOnce(Return(std::make_shared<mock_task>()));
+	EXPECT_CALL((*factory), create_sandboxed_task(_)).WillOnce(Return(std::make_shared<mock_task>(1, "eval")));
+	EXPECT_CALL((*factory), create_internal_task(2, fetch_meta))
+		.WillOnce(Return(std::make_shared<mock_task>(2, "fetch")));
+
+	job j(job_meta, worker_conf, dir_root, dir, res_dir, factory, nullptr);
+
+	// data directory is created and bound read-only to the sandbox
+	path data_dir = dir_root / "readonly-data";
+	EXPECT_TRUE(is_directory(data_dir));
+	EXPECT_EQ((data_dir / "01.in").string(), fetch_meta->cmd_args[1]);
+	EXPECT_EQ("/data/01.in", job_meta->tasks[0]->sandbox->std_input);
+	auto bnd_dirs = job_meta->tasks[0]->sandbox->loaded_limits["group1"]->bound_dirs;
+	ASSERT_FALSE(bnd_dirs.empty());
+	EXPECT_EQ(data_dir.string(), std::get<0>(bnd_dirs.back()));
+	EXPECT_EQ("/data", std::get<1>(bnd_dirs.back()));
+	EXPECT_EQ(sandbox_limits::dir_perm::RO, std::get<2>(bnd_dirs.back()));
+
+	remove_all(dir_root);
+}
+
+TEST(job_test, streamed_task_results)
+{
+	// prepare all things which need to be prepared
+	path dir_root = temp_directory_path() / "isoeval";
+	path dir = dir_root / "job_test";
+
+	auto job_meta = get_correct_meta();
+
+	/*
+	 * TASK TREE:
+	 *
+	 *      A
+	 *      |
+	 *      B
+	 *
+	 * Calling order: A, B
+	 *
+	 * progress_callback: only results of B (evaluation) are streamed
+	 */
+	job_meta->tasks.clear();
+	job_meta->tasks.push_back(get_simple_task("A", 1, {}));
+	job_meta->tasks.push_back(get_simple_task("B", 2, {"A"}));
+	job_meta->tasks.back()->type = task_type::EVALUATION;
+
+	auto worker_conf = std::make_shared<mock_worker_config>();
+	auto default_limits = get_default_limits();
+	std::string group_name = "group1";
+	EXPECT_CALL((*worker_conf), get_hwgroup()).WillRepeatedly(ReturnRef(group_name));
+	EXPECT_CALL((*worker_conf), get_worker_id()).WillRepeatedly(Return(8));
+	EXPECT_CALL((*worker_conf), get_limits()).WillRepeatedly(ReturnRef(default_limits));
+	EXPECT_CALL((*worker_conf), get_stream_results()).WillRepeatedly(Return(true));
+
+	auto progress_callback = std::make_shared<mock_progress_callback>();
+	auto factory = std::make_shared<mock_task_factory>();
+	auto empty_task = std::make_shared<mock_task>();
+	auto task_a = std::make_shared<mock_task>(1, job_meta->tasks[0]);
+	auto task_b = std::make_shared<mock_task>(2, job_meta->tasks[1]);
+	auto empty_results = std::make_shared<task_results>();
+
+	EXPECT_CALL((*factory), create_internal_task(0, _)).WillOnce(Return(empty_task));
+	EXPECT_CALL((*factory), create_internal_task(1, job_meta->tasks[0])).WillOnce(Return(task_a));
+	EXPECT_CALL((*factory), create_internal_task(2, job_meta->tasks[1])).WillOnce(Return(task_b));
+	EXPECT_CALL(*task_a, run()).WillOnce(Return(empty_results));
+	EXPECT_CALL(*task_b, run()).WillOnce(Return(empty_results));
+
+	{
+		InSequence s;
+		EXPECT_CALL(*progress_callback, job_started(_)).Times(1);
+		EXPECT_CALL(*progress_callback, task_completed(_, "A")).Times(1);
+		EXPECT_CALL(*progress_callback, task_results(_, "B", HasSubstr("task-id: B"))).Times(1);
+		EXPECT_CALL(*progress_callback, task_completed(_, "B")).Times(1);
+		EXPECT_CALL(*progress_callback, job_ended(_)).Times(1);
+	}
+
+	create_directories(dir);
+	std::ofstream hello((dir / "hello").string());
+	hello << "hello" << std::endl;
+	hello.close();
+
+	// construct and run
+	job result(job_meta, worker_conf, dir_root, dir, temp_directory_path(), factory, progress_callback);
+	result.run();
+
+	// cleanup after yourself
+	remove_all(dir_root);
+}
+
+TEST(job_test, job_wall_time_budget)
+{
+	// prepare all things which need to be prepared
+	path dir_root = temp_directory_path() / "isoeval";
+	path dir = dir_root / "job_test";
+
+	auto job_meta = get_correct_meta();
+	job_meta->job_wall_time = 0.01;
+
+	/*
+	 * TASK TREE:
+	 *
+	 *      A
+	 *      |
+	 *      B
+	 *
+	 * Calling order: A (exceeds the budget), B is skipped
+	 */
+	job_meta->tasks.clear();
+	job_meta->tasks.push_back(get_simple_task("A", 1, {}));
+	job_meta->tasks.push_back(get_simple_task("B", 2, {"A"}));
+
+	auto worker_conf = std::make_shared<mock_worker_config>();
+	auto default_limits = get_default_limits();
+	std::string group_name = "group1";
+	EXPECT_CALL((*worker_conf), get_hwgroup()).WillRepeatedly(ReturnRef(group_name));
+	EXPECT_CALL((*worker_conf), get_worker_id()).WillRepeatedly(Return(8));
+	EXPECT_CALL((*worker_conf), get_limits()).WillRepeatedly(ReturnRef(default_limits));
+	EXPECT_CALL((*worker_conf), get_job_wall_time()).WillRepeatedly(Return(1));
+
+	auto factory = std::make_shared<mock_task_factory>();
+	auto empty_task = std::make_shared<mock_task>();
+	auto task_a = std::make_shared<mock_task>(1, job_meta->tasks[0]);
+	auto task_b = std::make_shared<mock_task>(2, job_meta->tasks[1]);
+	auto empty_results = std::make_shared<task_results>();
+
+	EXPECT_CALL((*factory), create_internal_task(0, _)).WillOnce(Return(empty_task));
+	EXPECT_CALL((*factory), create_internal_task(1, job_meta->tasks[0])).WillOnce(Return(task_a));
+	EXPECT_CALL((*factory), create_internal_task(2, job_meta->tasks[1])).WillOnce(Return(task_b));
+	EXPECT_CALL(*task_a, run()).WillOnce(InvokeWithoutArgs([&]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		return empty_results;
+	}));
+	EXPECT_CALL(*task_b, run()).Times(0);
+
+	create_directories(dir);
+	std::ofstream hello((dir / "hello").string());
+	hello << "hello" << std::endl;
+	hello.close();
+
+	// construct and run
+	job result(job_meta, worker_conf, dir_root, dir, temp_directory_path(), factory, nullptr);
+	auto results = result.run();
+
+	ASSERT_EQ(results.size(), 2u);
+	EXPECT_EQ(results[1].first, "B");
+	EXPECT_EQ(results[1].second->status, task_status::SKIPPED);
+	EXPECT_THAT(results[1].second->error_message, HasSubstr("budget"));
+	EXPECT_TRUE(result.is_budget_exceeded());
+
+	// cleanup after yourself
+	remove_all(dir_root);
+}
+
+TEST(job_test, job_wall_time_caps_task)
+{
+	path dir_root = temp_directory_path() / "isoeval";
+	path dir = dir_root / "job_test";
+
+	// the task may run 6 seconds, only 2 remain in the budget
+	auto job_meta = get_correct_meta();
+	job_meta->job_wall_time = 2;
+	job_meta->tasks[0]->type = task_type::EXECUTION;
+	auto limits = job_meta->tasks[0]->sandbox->loaded_limits["group1"];
+
+	auto worker_conf = std::make_shared<mock_worker_config>();
+	auto default_limits = get_default_limits();
+	std::string group_name = "group1";
+	EXPECT_CALL((*worker_conf), get_hwgroup()).WillRepeatedly(ReturnRef(group_name));
+	EXPECT_CALL((*worker_conf), get_worker_id()).WillRepeatedly(Return(8));
+	EXPECT_CALL((*worker_conf), get_limits()).WillRepeatedly(ReturnRef(default_limits));
+	EXPECT_CALL((*worker_conf), get_job_wall_time()).WillRepeatedly(Return(0));
+
+	auto factory = std::make_shared<mock_task_factory>();
+	auto task = std::make_shared<mock_task>(1, job_meta->tasks[0]);
+	auto timed_out = std::make_shared<task_results>();
+	timed_out->status = task_status::FAILED;
+	timed_out->sandbox_status = std::make_unique<sandbox_results>();
+	timed_out->sandbox_status->status = isolate_status::TO;
+
+	EXPECT_CALL((*factory), create_internal_task(0, _)).WillOnce(Return(std::make_shared<mock_task>()));
+	EXPECT_CALL((*factory), create_sandboxed_task(_)).WillOnce(Return(task));
+	EXPECT_CALL(*task, run()).WillOnce(InvokeWithoutArgs([&]() {
+		EXPECT_GT(limits->wall_time, 0);
+		EXPECT_LE(limits->wall_time, 2);
+		return timed_out;
+	}));
+
+	create_directories(dir);
+	std::ofstream((dir / "hello").string()) << "hello" << std::endl;
+
+	job result(job_meta, worker_conf, dir_root, dir, temp_directory_path(), factory, nullptr);
+	result.run();
+	EXPECT_TRUE(result.is_budget_exceeded());
+
+	remove_all(dir_root);
+}
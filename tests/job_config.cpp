@@ -106,6 +106,55 @@ TEST(job_config_test, bad_format)
 					  "                    ISOLATE_TMP: /tmp\n"
 					  "...\n");
 	EXPECT_THROW(build_job_metadata(yaml), config_exception);
+
+	// zero repeat count
+	yaml = YAML::Load("---\n"
+					  "submission:\n"
+					  "    job-id: 5\n"
+					  "    file-collector: localhost\n"
+					  "    hw-groups:\n"
+					  "        - group1\n"
+					  "tasks:\n"
+					  "    - task-id: cp\n"
+					  "      priority: 1\n"
+					  "      fatal-failure: true\n"
+					  "      cmd:\n"
+					  "          bin: cp\n"
+					  "          args:\n"
+					  "              - hello.cpp\n"
+					  "              - hello_world.cpp\n"
+					  "    - task-id: eval\n"
+					  "      priority: 4\n"
+					  "      fatal-failure: false\n"
+					  "      dependencies:\n"
+					  "          - cp\n"
+					  "      cmd:\n"
+					  "          bin: recodex\n"
+					  "          args:\n"
+					  "              - -v\n"
+					  "              - \"-f 01.in\"\n"
+					  "      sandbox:\n"
+					  "          name: fake\n"
+					  "          stdin: 01.in\n"
+					  "          stdout: 01.out\n"
+					  "          stderr: 01.err\n"
+					  "          repeat:\n"
+					  "              count: 0\n"
+					  "          limits:\n"
+					  "              - hw-group-id: group1\n"
+					  "                time: 5\n"
+					  "                wall-time: 5\n"
+					  "                extra-time: 5\n"
+					  "                stack-size: 50000\n"
+					  "                memory: 50000\n"
+					  "                parallel: 1\n"
+					  "                disk-size: 50\n"
+					  "                disk-files: 5\n"
+					  "                environ-variable:\n"
+					  "                    ISOLATE_BOX: /box\n"
+					  "                    ISOLATE_TMP: /tmp\n"
+					  "...\n");
+	EXPECT_THROW(build_job_metadata(yaml), config_exception);
 }
 
 TEST(job_config_test, correct_format)
@@ -210,6 +259,8 @@ TEST(job_config_test, config_data)
 						   "          carboncopy-stderr: carbon-copy-stderr\n"
 						   "          chdir: /eval\n"
 						   "          working-directory: working\n"
+						   "          repeat:\n"
+						   "              count: 3\n"
 						   "          limits:\n"
 						   "              - hw-group-id: group1\n"
 						   "                time: 5\n"
@@ -220,6 +271,7 @@ TEST(job_config_test, config_data)
 						   "                parallel: 1\n"
 						   "                disk-size: 50\n"
 						   "                disk-files: 10\n"
+						   "                instructions: 1000000000\n"
 						   "                environ-variable:\n"
 						   "                    ISOLATE_BOX: /box\n"
 						   "                    ISOLATE_TMP: /tmp\n"
@@ -277,6 +329,7 @@ TEST(job_config_test, config_data)
 	ASSERT_EQ(task2->sandbox->carboncopy_stderr, "carbon-copy-stderr");
 	ASSERT_EQ(task2->sandbox->chdir, "/eval");
 	ASSERT_EQ(task2->sandbox->working_directory, "working");
+	ASSERT_EQ(task2->sandbox->repeat, 3u);
 
 	ASSERT_EQ(task2->sandbox->loaded_limits.size(), 2u);
 	EXPECT_NO_THROW(task2->sandbox->loaded_limits.at("group1"));
@@ -291,6 +344,7 @@ TEST(job_config_test, config_data)
 	ASSERT_EQ(limit1->processes, 1u);
 	ASSERT_EQ(limit1->disk_size, 50u);
 	ASSERT_EQ(limit1->disk_files, 10u);
+	ASSERT_EQ(limit1->instructions, 1000000000u);
 
 	// Both combinations are valid (YAML doesn't sort them)
 	std::vector<std::pair<std::string, std::string>> expected_environ_1 = {
@@ -316,6 +370,7 @@ TEST(job_config_test, config_data)
 	ASSERT_EQ(limit2->processes, SIZE_MAX);
 	ASSERT_EQ(limit2->disk_size, SIZE_MAX);
 	ASSERT_EQ(limit2->disk_files, SIZE_MAX);
+	ASSERT_EQ(limit2->instructions, SIZE_MAX);
 	ASSERT_EQ(limit2->environ_vars.size(), 0u);
 	ASSERT_EQ(limit2->bound_dirs.size(), 0u);
 }
@@ -41,6 +41,32 @@ public:
 	MOCK_CONST_METHOD0(get_worker_description, const std::string &());
 	MOCK_CONST_METHOD0(get_limits, const sandbox_limits &());
 	MOCK_CONST_METHOD0(get_max_output_length, std::size_t());
+	MOCK_CONST_METHOD0(get_output_tail_length, std::size_t());
+	MOCK_CONST_METHOD0(get_stream_results, bool());
+	MOCK_CONST_METHOD0(get_job_wall_time, float());
+	MOCK_CONST_METHOD0(get_failure_history_enabled, bool());
+	MOCK_CONST_METHOD0(get_failure_history_file, const std::string &());
+	MOCK_CONST_METHOD0(get_result_format, const std::string &());
+	MOCK_CONST_METHOD0(get_box_pool_size, std::size_t());
+	MOCK_CONST_METHOD0(get_box_pool_first_id, std::size_t());
+	MOCK_CONST_METHOD0(get_box_data_transfer, const std::string &());
+	MOCK_CONST_METHOD0(get_cgroup_metrics_enabled, bool());
+	MOCK_CONST_METHOD0(get_cgroup_root, const std::string &());
+	MOCK_CONST_METHOD0(get_cgroup_sample_interval, std::size_t());
+	MOCK_CONST_METHOD0(get_namespace_cgroup_root, const std::string &());
+	MOCK_CONST_METHOD0(get_namespace_uid, std::size_t());
+	MOCK_CONST_METHOD0(get_namespace_gid, std::size_t());
+	MOCK_CONST_METHOD0(get_cpu_placement, const helpers::cpu_placement &());
+	MOCK_CONST_METHOD0(get_cpuset_exclusive, bool());
+	MOCK_CONST_METHOD0(get_tmpfs_dir, const std::string &());
+	MOCK_CONST_METHOD0(get_tmpfs_min_free, std::size_t());
+	MOCK_CONST_METHOD0(get_box_session, bool());
+	MOCK_CONST_METHOD0(get_perf_counters, bool());
+	MOCK_CONST_METHOD0(get_max_repeat, std::size_t());
+	MOCK_CONST_METHOD0(get_host_noise, const helpers::host_noise_limits &());
+	MOCK_CONST_METHOD0(get_calibration, const helpers::calibration_config &());
+	MOCK_CONST_METHOD0(get_output_capture, const std::string &());
+	MOCK_CONST_METHOD0(get_results_config, const std::string &());
 };
 
 /**
@@ -71,6 +97,7 @@ public:
 	MOCK_CONST_METHOD0(get_caching_dir, std::string());
 	MOCK_METHOD2(put_file, void(const std::string &name, const std::string &dst_path));
 	MOCK_METHOD2(get_file, void(const std::string &src_name, const std::string &dst_path));
+	MOCK_METHOD2(get_readonly_file, void(const std::string &src_name, const std::string &dst_path));
 };
 
 /**
@@ -135,6 +162,7 @@ public:
 	MOCK_METHOD2(task_completed, void(const std::string &, const std::string &));
 	MOCK_METHOD2(task_failed, void(const std::string &, const std::string &));
 	MOCK_METHOD2(task_skipped, void(const std::string &, const std::string &));
+	MOCK_METHOD3(task_results, void(const std::string &, const std::string &, const std::string &));
 };
 
 /**
@@ -0,0 +1,239 @@
+#ifndef _WIN32
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+
+#include "sandbox/namespace_sandbox.h"
+
+namespace fs = std::filesystem;
+
+
+TEST(namespace_sandbox, mount_points)
+{
+	sandbox_limits limits;
+	limits.bound_dirs.clear();
+	limits.bound_dirs.emplace_back("/tmp", "data", sandbox_limits::dir_perm::RW);
+	limits.bound_dirs.emplace_back("/nonexistent/recodex", "/missing", sandbox_limits::dir_perm::MAYBE);
+
+	auto mounts = namespace_sandbox::get_mount_points(limits, "/var/recodex/eval");
+	ASSERT_FALSE(mounts.empty());
+	EXPECT_EQ("/var/recodex/eval", mounts[0].source);
+	EXPECT_EQ("/box", mounts[0].target);
+	EXPECT_EQ(sandbox_limits::dir_perm::RW, mounts[0].flags);
+
+	auto find = [&](const std::string &target) {
+		return std::find_if(mounts.begin(), mounts.end(), [&](auto &mp) { return mp.target == target; });
+	};
+	ASSERT_NE(mounts.end(), find("/data"));
+	EXPECT_EQ("/tmp", find("/data")->source);
+	EXPECT_EQ(mounts.end(), find("/missing"));
+	EXPECT_EQ(mounts.end(), find("/etc"));
+	EXPECT_EQ(sandbox_limits::dir_perm::FS, find("/proc")->flags);
+
+	// empty data directory is replaced by temporary filesystem, shared network needs /etc
+	limits.share_net = true;
+	mounts = namespace_sandbox::get_mount_points(limits, "");
+	EXPECT_EQ(sandbox_limits::dir_perm::TMP, mounts[0].flags);
+	EXPECT_NE(mounts.end(), find("/etc"));
+}
+
+#ifdef TEST_NAMESPACE_SANDBOX
+
+class NamespaceSandbox : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		temp_ = fs::temp_directory_path() / "recodex_namespace_sandbox";
+		data_ = temp_ / "data";
+		fs::create_directories(data_);
+		config_ = std::make_shared<sandbox_config>();
+		limits_.wall_time = 2;
+		limits_.cpu_time = 2;
+		limits_.extra_time = 0.5;
+		limits_.memory_usage = 100000;
+		limits_.bound_dirs.clear();
+
+		// root worker has to run programs under an unprivileged user
+		if (getuid() == 0) { uid_ = gid_ = 65534; }
+	}
+
+	void TearDown() override
+	{
+		fs::remove_all(temp_);
+	}
+
+	sandbox_results run(const std::string &binary, const std::vector<std::string> &arguments)
+	{
+		namespace_sandbox sandbox(config_,
+			limits_,
+			37,
+			(temp_ / "tmp").string(),
+			data_.string(),
+			nullptr,
+			cgroup_root_,
+			helpers::cpu_placement(),
+			perf_counters_,
+			uid_,
+			gid_);
+		EXPECT_EQ(data_.string(), sandbox.get_dir());
+		sandbox.set_output_capture(stdout_capture_, stderr_capture_);
+		return sandbox.run(binary, arguments);
+	}
+
+	fs::path temp_;
+	fs::path data_;
+	std::shared_ptr<sandbox_config> config_;
+	sandbox_limits limits_;
+	bool perf_counters_ = false;
+	std::string cgroup_root_;
+	uid_t uid_ = 0;
+	gid_t gid_ = 0;
+	std::shared_ptr<helpers::output_buffer> stdout_capture_;
+	std::shared_ptr<helpers::output_buffer> stderr_capture_;
+};
+
+TEST_F(NamespaceSandbox, NormalCommand)
+{
+	config_->std_output = "output.txt";
+	auto results = run("/bin/sh", {"-c", "echo $$; id -u; touch created"});
+
+	EXPECT_EQ(isolate_status::OK, results.status);
+	EXPECT_EQ(0, results.exitcode);
+	EXPECT_TRUE(results.message.empty());
+	EXPECT_TRUE(results.wall_time > 0);
+	EXPECT_TRUE(fs::exists(data_ / "created"));
+
+	// program is the first process after init of the sandbox and runs as unprivileged user mapped to itself
+	std::ifstream output((data_ / "output.txt").string());
+	std::string pid, uid;
+	output >> pid >> uid;
+	EXPECT_EQ("2", pid);
+	EXPECT_EQ(std::to_string(uid_ != 0 ? uid_ : getuid()), uid);
+	EXPECT_NE("0", uid);
+}
+
+TEST_F(NamespaceSandbox, ReadOnlyBindStaysReadOnly)
+{
+	fs::create_directories(temp_ / "ro");
+	limits_.bound_dirs.push_back(std::make_tuple((temp_ / "ro").string(), "ro", sandbox_limits::RO));
+	config_->std_output = "caps.txt";
+	auto results =
+		run("/bin/sh", {"-c", "grep CapEff /proc/self/status; mount -o remount,bind,rw /ro; touch /ro/pwned"});
+
+	EXPECT_EQ(isolate_status::RE, results.status);
+	EXPECT_FALSE(fs::exists(temp_ / "ro" / "pwned"));
+
+	// the program has no capabilities, even in its own namespace
+	std::ifstream output((data_ / "caps.txt").string());
+	std::string name, caps;
+	output >> name >> caps;
+	EXPECT_EQ("CapEff:", name);
+	EXPECT_EQ("0000000000000000", caps);
+}
+
+TEST_F(NamespaceSandbox, RootWorkerNeedsUser)
+{
+	if (getuid() != 0) { GTEST_SKIP() << "worker is not root"; }
+	EXPECT_THROW(namespace_sandbox(config_, limits_, 37, (temp_ / "tmp").string(), data_.string()), sandbox_exception);
+}
+
+TEST_F(NamespaceSandbox, TimeoutCommand)
+{
+	limits_.wall_time = 0.5;
+	auto results = run("/bin/sleep", {"5"});
+
+	EXPECT_EQ(isolate_status::TO, results.status);
+	EXPECT_TRUE(results.killed);
+	EXPECT_EQ("Time limit exceeded (wall clock)", results.message);
+	EXPECT_TRUE(results.wall_time >= 0.5);
+}
+
+TEST_F(NamespaceSandbox, CpuTimeOfAllProcesses)
+{
+	// delegated cgroup v2 directory has to be given in the environment
+	auto cgroup_root = getenv("RECODEX_TEST_CGROUP_ROOT");
+	if (cgroup_root == nullptr) { GTEST_SKIP() << "RECODEX_TEST_CGROUP_ROOT not set"; }
+	cgroup_root_ = cgroup_root;
+
+	// each process stays below the limit, together they exceed it
+	limits_.cpu_time = 0.5;
+	limits_.extra_time = 0;
+	limits_.wall_time = 5;
+	auto results = run("/bin/sh", {"-c", "timeout 0.8 yes > /dev/null & timeout 0.8 yes > /dev/null & wait; sleep 3"});
+
+	EXPECT_EQ(isolate_status::TO, results.status);
+	EXPECT_EQ("Time limit exceeded", results.message);
+	EXPECT_TRUE(results.time > 0.5);
+	EXPECT_TRUE(results.wall_time < 3);
+}
+
+TEST_F(NamespaceSandbox, NonzeroReturnCommand)
+{
+	auto results = run("/bin/false", {});
+
+	EXPECT_EQ(isolate_status::RE, results.status);
+	EXPECT_FALSE(results.killed);
+	EXPECT_EQ("Exited with error status 1", results.message);
+}
+
+TEST_F(NamespaceSandbox, MissingBinary)
+{
+	auto results = run("/box/nonexistent", {});
+
+	EXPECT_EQ(isolate_status::XX, results.status);
+	EXPECT_EQ("execve failed: No such file or directory", results.message);
+}
+
+TEST_F(NamespaceSandbox, PerfCounters)
+{
+	perf_counters_ = true;
+	auto busy_loop = std::vector<std::string>{"-c", "i=0; while [ $i -lt 100000 ]; do i=$((i+1)); done"};
+	auto results = run("/bin/sh", busy_loop);
+
+	EXPECT_EQ(isolate_status::OK, results.status);
+	ASSERT_NE(nullptr, results.perf);
+	EXPECT_TRUE(results.perf->task_clock > 0);
+	EXPECT_TRUE(results.perf->task_clock <= results.time + 0.1);
+
+	// instructions are counted only by hardware counters
+	if (results.perf->hardware) {
+		EXPECT_TRUE(results.perf->instructions > 1000000);
+		limits_.instructions = 1000000;
+		results = run("/bin/sh", busy_loop);
+		EXPECT_EQ(isolate_status::TO, results.status);
+		EXPECT_EQ("Instruction limit exceeded", results.message);
+	} else {
+		EXPECT_EQ(0u, results.perf->instructions);
+	}
+}
+
+TEST_F(NamespaceSandbox, OutputCapture)
+{
+	// output larger than the pipe buffer is drained while the program runs
+	stdout_capture_ = std::make_shared<helpers::output_buffer>(8, 4);
+	stderr_capture_ = std::make_shared<helpers::output_buffer>(8);
+	auto results = run("/bin/sh", {"-c", "echo start; head -c 1000000 /dev/zero; echo end; echo error >&2"});
+
+	EXPECT_EQ(isolate_status::OK, results.status);
+	EXPECT_EQ(1000010u, stdout_capture_->size());
+	EXPECT_EQ("starend\n", stdout_capture_->str());
+	EXPECT_EQ("error\n", stderr_capture_->str());
+	EXPECT_FALSE(fs::exists(data_ / "output.txt"));
+
+	// stream is killed as soon as it exceeds the file size limit
+	limits_.files_size = 100;
+	results = run("/bin/sh", {"-c", "while true; do echo output; done"});
+	EXPECT_EQ(isolate_status::SG, results.status);
+	EXPECT_EQ(SIGXFSZ, results.exitsig);
+	EXPECT_EQ("Output limit exceeded", results.message);
+	EXPECT_TRUE(stdout_capture_->size() > 100 * 1024);
+	EXPECT_TRUE(stderr_capture_->str().empty());
+}
+
+#endif
+#endif
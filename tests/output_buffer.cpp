@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+#include "helpers/output_buffer.h"
+#include "helpers/filesystem.h"
+
+namespace fs = std::filesystem;
+
+
+TEST(output_buffer, head_only)
+{
+	helpers::output_buffer buffer(4);
+	buffer.reset();
+	EXPECT_EQ("", buffer.str());
+	buffer.append("01", 2);
+	EXPECT_EQ("01", buffer.str());
+	buffer.append("23456789", 8);
+	EXPECT_EQ("0123", buffer.str());
+	EXPECT_EQ(10u, buffer.size());
+
+	buffer.reset();
+	EXPECT_EQ(0u, buffer.size());
+	EXPECT_EQ("", buffer.str());
+}
+
+TEST(output_buffer, head_and_tail)
+{
+	// all splits of the stream give the same result as reading of a file
+	auto file = fs::temp_directory_path() / "recodex_output_buffer.txt";
+	std::string stream = "0123456789abcdefghij";
+	std::ofstream(file) << stream;
+
+	for (std::size_t length = 1; length <= stream.size(); ++length) {
+		for (std::size_t max_length = 1; max_length <= 12; ++max_length) {
+			for (std::size_t tail_length = 0; tail_length <= max_length; ++tail_length) {
+				for (std::size_t chunk = 1; chunk <= 7; ++chunk) {
+					helpers::output_buffer buffer(max_length, tail_length);
+					buffer.reset();
+					for (std::size_t pos = 0; pos < length; pos += chunk) {
+						buffer.append(stream.data() + pos, std::min(chunk, length - pos));
+					}
+					std::ofstream(file, std::ios::trunc) << stream.substr(0, length);
+					ASSERT_EQ(helpers::read_file_bounded(file, max_length, tail_length), buffer.str())
+						<< "length " << length << ", max " << max_length << ", tail " << tail_length << ", chunk "
+						<< chunk;
+				}
+			}
+		}
+	}
+	fs::remove(file);
+}
+
+TEST(output_buffer, carboncopy)
+{
+	auto file = fs::temp_directory_path() / "recodex_output_buffer_copy.txt";
+	helpers::output_buffer buffer(2, 0, file, 5);
+	buffer.reset();
+	buffer.append("0123", 4);
+	buffer.append("4567", 4);
+	buffer.finish();
+
+	std::stringstream content;
+	content << std::ifstream(file).rdbuf();
+	EXPECT_EQ("01234", content.str());
+	EXPECT_EQ("01", buffer.str());
+
+	// next run truncates the copy
+	buffer.reset();
+	buffer.finish();
+	EXPECT_EQ(0u, fs::file_size(file));
+	fs::remove(file);
+
+	helpers::output_buffer invalid(2, 0, fs::temp_directory_path() / "nonexisting_dir" / "copy.txt", 5);
+	EXPECT_THROW(invalid.reset(), std::runtime_error);
+}
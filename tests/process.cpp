@@ -0,0 +1,57 @@
+#ifndef _WIN32
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <system_error>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "helpers/process.h"
+
+
+namespace
+{
+	/** Start a child which exits with given code after given number of milliseconds */
+	pid_t start_child(int code, unsigned int delay)
+	{
+		pid_t pid = fork();
+		if (pid == 0) {
+			usleep(delay * 1000);
+			_exit(code);
+		}
+		return pid;
+	}
+} // namespace
+
+TEST(process, exit_status)
+{
+	pid_t pid = start_child(3, 50);
+	ASSERT_NE(-1, pid);
+	std::size_t samples = 0;
+	int status = helpers::wait_or_kill(pid, std::chrono::seconds(5), 5, [&]() { ++samples; });
+
+	EXPECT_TRUE(WIFEXITED(status));
+	EXPECT_EQ(3, WEXITSTATUS(status));
+	EXPECT_TRUE(samples > 0);
+}
+
+TEST(process, timeout_kills)
+{
+	pid_t pid = start_child(0, 5000);
+	ASSERT_NE(-1, pid);
+	int status = helpers::wait_or_kill(pid, std::chrono::milliseconds(50));
+
+	EXPECT_TRUE(WIFSIGNALED(status));
+	EXPECT_EQ(SIGKILL, WTERMSIG(status));
+}
+
+TEST(process, not_a_child)
+{
+	// already reaped child cannot be waited for, it must not look like a clean exit
+	pid_t pid = start_child(0, 0);
+	ASSERT_NE(-1, pid);
+	waitpid(pid, nullptr, 0);
+	EXPECT_THROW(helpers::wait_or_kill(pid, std::chrono::seconds(5)), std::system_error);
+}
+
+#endif
@@ -28,6 +28,7 @@ TEST(progress_callback, basic)
 		callback.task_completed(job_id, task_id);
 		callback.task_failed(job_id, task_id);
 		callback.task_skipped(job_id, task_id);
+		callback.task_results(job_id, task_id, "task-id: test_task_id");
 		callback.job_ended(job_id);
 		callback.job_aborted(job_id);
 		callback.job_results_uploaded(job_id);
@@ -67,6 +68,11 @@ TEST(progress_callback, basic)
 	helpers::recv_from_socket(socket, result, &terminate);
 	ASSERT_EQ(result, expected);
 
+	// receive message with task results
+	expected = {command, job_id, "TASK", task_id, "RESULTS", "task-id: test_task_id"};
+	helpers::recv_from_socket(socket, result, &terminate);
+	ASSERT_EQ(result, expected);
+
 	// receive message job ended
 	expected = {command, job_id, "ENDED"};
 	helpers::recv_from_socket(socket, result, &terminate);
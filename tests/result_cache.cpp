@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <filesystem>
+#include <fstream>
+
+#include "job/result_cache.h"
+#include "helpers/hash.h"
+#include "helpers/filesystem.h"
+
+using namespace testing;
+using namespace std;
+
+
+TEST(result_cache, sha1)
+{
+	EXPECT_EQ("da39a3ee5e6b4b0d3255bfef95601890afd80709", helpers::sha1_string(""));
+	EXPECT_EQ("a9993e364706816aba3e25717850c26c9cd0d89d", helpers::sha1_string("abc"));
+
+	auto file = fs::temp_directory_path() / "recodex_result_cache_sha1.txt";
+	{
+		ofstream out(file.string());
+		out << "abc";
+	}
+	EXPECT_EQ("a9993e364706816aba3e25717850c26c9cd0d89d", helpers::sha1_file(file));
+	fs::remove(file);
+
+	EXPECT_THROW(helpers::sha1_file(file), helpers::filesystem_exception);
+}
+
+TEST(result_cache, compute_key)
+{
+	auto source = fs::temp_directory_path() / "recodex_result_cache_source";
+	fs::create_directories(source / "subdir");
+	{
+		ofstream((source / "main.c").string()) << "int main() { return 0; }";
+		ofstream((source / "subdir" / "input.txt").string()) << "42";
+		ofstream((source / "job-config.yml").string()) << "ignored";
+	}
+
+	auto config = YAML::Load("submission:\n"
+							 "    job-id: student_1\n"
+							 "    hw-groups: [group1]\n"
+							 "tasks: []\n");
+	auto rejudged_config = YAML::Load("submission:\n"
+									  "    job-id: student_2\n"
+									  "    hw-groups: [group1]\n"
+									  "tasks: []\n");
+	auto other_config = YAML::Load("submission:\n"
+								   "    job-id: student_1\n"
+								   "    hw-groups: [group2]\n"
+								   "tasks: []\n");
+
+	auto key = result_cache::compute_key(source, config, "group1", "limits: []", "1.0.0");
+	EXPECT_EQ(40u, key.size());
+	EXPECT_EQ(key, result_cache::compute_key(source, rejudged_config, "group1", "limits: []", "1.0.0"));
+	EXPECT_NE(key, result_cache::compute_key(source, other_config, "group1", "limits: []", "1.0.0"));
+	EXPECT_NE(key, result_cache::compute_key(source, config, "group2", "limits: []", "1.0.0"));
+	EXPECT_NE(key, result_cache::compute_key(source, config, "group1", "limits: []", "1.0.1"));
+	EXPECT_NE(key, result_cache::compute_key(source, config, "group1", "max-output-length: 10", "1.0.0"));
+
+	// job configuration file itself is not part of the key, but other files are
+	ofstream((source / "job-config.yml").string()) << "changed";
+	EXPECT_EQ(key, result_cache::compute_key(source, config, "group1", "limits: []", "1.0.0"));
+	ofstream((source / "subdir" / "input.txt").string()) << "43";
+	EXPECT_NE(key, result_cache::compute_key(source, config, "group1", "limits: []", "1.0.0"));
+
+	fs::remove_all(source);
+}
+
+TEST(result_cache, store_and_fetch)
+{
+	auto tmp = fs::temp_directory_path();
+	auto cache_dir = tmp / "recodex_result_cache";
+	result_cache cache(cache_dir);
+	EXPECT_TRUE(fs::is_directory(cache_dir));
+
+	{
+		ofstream((tmp / "recodex_result.zip").string()) << "results";
+	}
+
+	EXPECT_FALSE(cache.fetch("key", tmp / "recodex_fetched.zip"));
+	EXPECT_FALSE(fs::exists(tmp / "recodex_fetched.zip"));
+
+	cache.store("key", tmp / "recodex_result.zip");
+	EXPECT_TRUE(fs::is_regular_file(cache_dir / "key.zip"));
+	EXPECT_TRUE(cache.fetch("key", tmp / "recodex_fetched.zip"));
+
+	string content;
+	ifstream((tmp / "recodex_fetched.zip").string()) >> content;
+	EXPECT_EQ("results", content);
+
+	// storing nonexisting file only leaves original entry untouched
+	cache.store("key", tmp / "recodex_nonexisting.zip");
+	EXPECT_TRUE(fs::is_regular_file(cache_dir / "key.zip"));
+	EXPECT_EQ(1, distance(fs::directory_iterator(cache_dir), fs::directory_iterator()));
+
+	fs::remove(tmp / "recodex_result.zip");
+	fs::remove(tmp / "recodex_fetched.zip");
+	fs::remove_all(cache_dir);
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+#include "job/yaml_results_writer.h"
+#include "job/cbor_results_writer.h"
+#include "job/job_exception.h"
+#include "helpers/results.h"
+#include "helpers/cbor.h"
+#include "helpers/timings.h"
+
+using namespace testing;
+using namespace std;
+
+
+static string read_file(const fs::path &file)
+{
+	ifstream in(file.string(), ios::binary);
+	stringstream buffer;
+	buffer << in.rdbuf();
+	return buffer.str();
+}
+
+static void write_sample(results_writer &writer, YAML::Node &expected)
+{
+	task_results first;
+	first.status = task_status::OK;
+	first.output_stdout = "p\xC5\x99\xC3\xADli\xC5\xA1 \xC5\xBElu\xC5\xA5ou\xC4\x8Dk\xC3\xBD";
+	task_results second;
+	second.status = task_status::FAILED;
+	second.error_message = "failed";
+	second.sandbox_status = make_unique<sandbox_results>();
+	second.sandbox_status->exitcode = 1;
+	second.sandbox_status->time = 0.25;
+	second.sandbox_status->memory = 4096;
+	second.sandbox_status->cgroup = make_shared<cgroup_metrics>();
+	second.sandbox_status->cgroup->cpu_usage = 0.5;
+	second.sandbox_status->cgroup->io_write = 1024;
+	second.sandbox_status->perf = make_shared<perf_metrics>();
+	second.sandbox_status->perf->instructions = 123456789;
+	second.sandbox_status->perf->task_clock = 0.125;
+	second.sandbox_status->repeat = make_shared<repeat_samples>();
+	second.sandbox_status->repeat->time = {0.5, 0.25, 0.375};
+	second.sandbox_status->repeat->wall_time = {1, 0.5, 0.75};
+	second.sandbox_status->repeat->time_min = 0.25;
+	second.sandbox_status->repeat->time_median = 0.375;
+	second.sandbox_status->host = make_shared<host_context>();
+	second.sandbox_status->host->steal = 0.125;
+	second.sandbox_status->host->frequency_start = 3000;
+	second.sandbox_status->host->frequency_end = 2000;
+	second.sandbox_status->host->tainted = true;
+	second.sandbox_status->host->taints = {"steal", "frequency"};
+	YAML::Node timings;
+	timings["job"]["run"] = 1.5;
+
+	writer.write("A", first);
+	writer.write("B", second);
+	writer.finish(timings);
+	EXPECT_THROW(writer.write("C", first), job_exception);
+
+	expected["job-id"] = "eval5";
+	expected["hw-group"] = "group1";
+	expected["results"].push_back(helpers::task_results_to_yaml("A", first));
+	expected["results"].push_back(helpers::task_results_to_yaml("B", second));
+	expected["timings"] = timings;
+}
+
+TEST(results_writer, same_as_yaml_tree)
+{
+	auto file = fs::temp_directory_path() / "recodex_results_writer.yml";
+
+	YAML::Node expected;
+	yaml_results_writer writer(file, "eval5", "group1");
+	write_sample(writer, expected);
+
+	auto loaded = YAML::LoadFile(file.string());
+	EXPECT_EQ(helpers::yaml_to_string(expected), helpers::yaml_to_string(loaded));
+	fs::remove(file);
+}
+
+TEST(results_writer, no_results)
+{
+	auto file = fs::temp_directory_path() / "recodex_results_writer_empty.yml";
+
+	yaml_results_writer writer(file, "eval5", "group1");
+	writer.finish();
+
+	auto loaded = YAML::LoadFile(file.string());
+	EXPECT_EQ("eval5", loaded["job-id"].as<string>());
+	EXPECT_EQ("group1", loaded["hw-group"].as<string>());
+	EXPECT_FALSE(loaded["results"]);
+	EXPECT_FALSE(loaded["timings"]);
+	fs::remove(file);
+
+	EXPECT_THROW(yaml_results_writer(fs::temp_directory_path() / "nonexisting_dir" / "result.yml", "eval5", "group1"),
+		job_exception);
+}
+
+TEST(results_writer, cbor_same_as_yaml_tree)
+{
+	auto file = fs::temp_directory_path() / "recodex_results_writer.cbor";
+
+	YAML::Node expected;
+	cbor_results_writer writer(file, "eval5", "group1");
+	write_sample(writer, expected);
+
+	auto data = read_file(file);
+	auto loaded = helpers::cbor_to_yaml(data);
+	EXPECT_EQ(helpers::yaml_to_string(expected), helpers::yaml_to_string(loaded));
+
+	// values keep their types
+	std::size_t pos = 0;
+	EXPECT_EQ('\xbf', data[pos++]);
+	EXPECT_EQ("job-id", helpers::cbor_to_yaml(data, pos).as<string>());
+
+	cbor_results_writer::rewrite_job_id(file, "eval123456");
+	loaded = helpers::cbor_to_yaml(read_file(file));
+	expected["job-id"] = "eval123456";
+	EXPECT_EQ(helpers::yaml_to_string(expected), helpers::yaml_to_string(loaded));
+	fs::remove(file);
+}
+
+TEST(results_writer, cbor_encoding)
+{
+	stringstream out;
+	helpers::cbor_writer writer(out);
+	writer.write_uint(10);
+	writer.write_uint(500);
+	writer.write_int(-1000);
+	writer.write_bool(true);
+	writer.write_null();
+	writer.write_string("a");
+	writer.begin_array(2);
+	writer.write_double(1.5);
+	writer.write_float(1.5);
+	writer.begin_map();
+	writer.end_indefinite();
+
+	EXPECT_EQ(string("\x0a\x19\x01\xf4\x39\x03\xe7\xf5\xf6\x61"
+					 "a\x82\xfb\x3f\xf8\x00\x00\x00\x00\x00\x00\xfa\x3f\xc0\x00\x00\xbf\xff",
+				  28),
+		out.str());
+
+	// decoding of all items in sequence
+	auto data = out.str();
+	std::size_t pos = 0;
+	EXPECT_EQ(10u, helpers::cbor_to_yaml(data, pos).as<unsigned>());
+	EXPECT_EQ(500u, helpers::cbor_to_yaml(data, pos).as<unsigned>());
+	EXPECT_EQ(-1000, helpers::cbor_to_yaml(data, pos).as<int>());
+	EXPECT_TRUE(helpers::cbor_to_yaml(data, pos).as<bool>());
+	EXPECT_TRUE(helpers::cbor_to_yaml(data, pos).IsNull());
+	EXPECT_EQ("a", helpers::cbor_to_yaml(data, pos).as<string>());
+	auto array = helpers::cbor_to_yaml(data, pos);
+	EXPECT_EQ(2u, array.size());
+	EXPECT_EQ(1.5, array[0].as<double>());
+	EXPECT_EQ(1.5, array[1].as<double>());
+	EXPECT_EQ(pos, helpers::cbor_skip(data, pos) - 2);
+	EXPECT_THROW(helpers::cbor_to_yaml(data.substr(0, data.size() - 1)), helpers::cbor_exception);
+}
+
+/**
+ * Comparison of emitting and parsing costs of both formats on a job with 1000 tasks.
+ * Run explicitly with --gtest_also_run_disabled_tests.
+ */
+TEST(results_writer, DISABLED_benchmark)
+{
+	const std::size_t task_count = 1000;
+	auto yaml_file = fs::temp_directory_path() / "recodex_results_benchmark.yml";
+	auto cbor_file = fs::temp_directory_path() / "recodex_results_benchmark.cbor";
+
+	task_results result;
+	result.status = task_status::OK;
+	result.output_stdout = string(4096, 'x');
+	result.sandbox_status = make_unique<sandbox_results>();
+	result.sandbox_status->time = 0.125;
+	result.sandbox_status->memory = 123456;
+
+	helpers::stopwatch watch;
+	{
+		yaml_results_writer writer(yaml_file, "eval5", "group1");
+		for (std::size_t i = 0; i < task_count; ++i) { writer.write("task" + to_string(i), result); }
+		writer.finish();
+	}
+	double yaml_emit = watch.lap();
+	auto yaml = YAML::LoadFile(yaml_file.string());
+	double yaml_parse = watch.lap();
+
+	{
+		cbor_results_writer writer(cbor_file, "eval5", "group1");
+		for (std::size_t i = 0; i < task_count; ++i) { writer.write("task" + to_string(i), result); }
+		writer.finish();
+	}
+	double cbor_emit = watch.lap();
+	auto cbor = helpers::cbor_to_yaml(read_file(cbor_file));
+	double cbor_parse = watch.lap();
+
+	EXPECT_EQ(task_count, yaml["results"].size());
+	EXPECT_EQ(task_count, cbor["results"].size());
+	cout << "yaml: emit " << yaml_emit << "s, parse " << yaml_parse << "s, size " << fs::file_size(yaml_file) << endl;
+	cout << "cbor: emit " << cbor_emit << "s, parse " << cbor_parse << "s, size " << fs::file_size(cbor_file) << endl;
+
+	fs::remove(yaml_file);
+	fs::remove(cbor_file);
+}
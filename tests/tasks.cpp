@@ -273,3 +273,57 @@ TEST(Tasks, TaskFactory)
 	EXPECT_NE(std::dynamic_pointer_cast<external_task>(task), nullptr);
 #endif
 }
+
+#ifdef TEST_NAMESPACE_SANDBOX
+#include <unistd.h>
+#include "helpers/logger.h"
+
+TEST(Tasks, ExternalTaskRepeatRestoresData)
+{
+	auto temp = fs::temp_directory_path() / "recodex_external_task_repeat";
+	fs::remove_all(temp);
+	fs::create_directories(temp / "eval");
+	fs::create_directories(temp / "tmp");
+	std::ofstream((temp / "eval" / "data.txt").string()) << "data\n";
+	fs::permissions(temp / "eval" / "data.txt", fs::perms::all);
+
+	auto worker_conf = std::make_shared<NiceMock<mock_worker_config>>();
+	std::string empty, capture = "file";
+	helpers::cpu_placement placement;
+	helpers::host_noise_limits host_noise;
+	ON_CALL(*worker_conf, get_namespace_cgroup_root()).WillByDefault(ReturnRef(empty));
+	ON_CALL(*worker_conf, get_cpu_placement()).WillByDefault(ReturnRef(placement));
+	ON_CALL(*worker_conf, get_host_noise()).WillByDefault(ReturnRef(host_noise));
+	ON_CALL(*worker_conf, get_output_capture()).WillByDefault(ReturnRef(capture));
+	// root worker has to run programs under an unprivileged user
+	if (getuid() == 0) {
+		ON_CALL(*worker_conf, get_namespace_uid()).WillByDefault(Return(65534));
+		ON_CALL(*worker_conf, get_namespace_gid()).WillByDefault(Return(65534));
+	}
+
+	// every run times out, each one has to see the data as they were before the first run
+	auto meta = get_task_meta();
+	meta->binary = "/bin/sh";
+	meta->cmd_args = {"-c", "echo run >> data.txt; sleep 5"};
+	meta->sandbox->name = "namespace";
+	meta->sandbox->repeat = 3;
+	auto limits = std::make_shared<sandbox_limits>();
+	limits->wall_time = 0.3;
+	limits->bound_dirs.clear();
+
+	std::string temp_dir = (temp / "tmp").string();
+	create_params params = {
+		worker_conf, 1, meta, limits, helpers::create_null_logger(), temp_dir, temp / "eval", fs::path("/box")};
+	auto res = external_task(params).run();
+
+	EXPECT_EQ(isolate_status::TO, res->sandbox_status->status);
+	ASSERT_NE(nullptr, res->sandbox_status->repeat);
+	EXPECT_EQ(3u, res->sandbox_status->repeat->time.size());
+	std::ifstream data((temp / "eval" / "data.txt").string());
+	std::string content((std::istreambuf_iterator<char>(data)), std::istreambuf_iterator<char>());
+	EXPECT_EQ("data\nrun\n", content);
+	EXPECT_TRUE(fs::is_empty(temp / "tmp"));
+
+	fs::remove_all(temp);
+}
+#endif
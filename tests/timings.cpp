@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <thread>
+
+#include "helpers/timings.h"
+
+
+TEST(timings, stopwatch)
+{
+	helpers::stopwatch watch;
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	double first = watch.lap();
+	double second = watch.lap();
+
+	EXPECT_GE(first, 0.02);
+	EXPECT_LT(second, first);
+	EXPECT_GE(watch.elapsed(), first + second);
+}
+
+TEST(timings, stats)
+{
+	helpers::timing_stats stats;
+	stats.add({{"download", 1.0}, {"run", 2.0}});
+	stats.add({{"download", 3.0}});
+	stats.add({{"run", 0.5}}, "task.");
+
+	EXPECT_EQ("download: count 2 total 4.000s max 3.000s, run: count 1 total 2.000s max 2.000s, "
+			  "task.run: count 1 total 0.500s max 0.500s",
+		stats.to_string());
+}
+
+TEST(timings, median)
+{
+	EXPECT_FLOAT_EQ(0, helpers::median({}));
+	EXPECT_FLOAT_EQ(2, helpers::median({3, 1, 2}));
+	EXPECT_FLOAT_EQ(2.5, helpers::median({4, 1, 3, 2}));
+}
@@ -402,6 +402,47 @@ TEST(topological_sort_test, top_sort_6)
 	ASSERT_EQ(result, expected_result);
 }
 
+TEST(topological_sort_test, top_sort_order_hint)
+{
+	// initialization
+	std::size_t id = 0;
+	vector<shared_ptr<task_base>> result;
+	vector<shared_ptr<task_base>> expected_result;
+
+
+	/*
+	 * TASK TREE:
+	 *
+	 *       A
+	 *    / | | \
+	 *   B  C D  E
+	 *
+	 * priority: A = 1, B = 2, C = 2, D = 2, E = 3
+	 * order hint: C = 0.5, D = 0.25, E = 0
+	 *
+	 * expected = A, E, C, D, B
+	 */
+	shared_ptr<task_base> A = make_shared<test_task>(id++, std::make_shared<task_metadata>("A", 1));
+	shared_ptr<task_base> B = make_shared<test_task>(id++, std::make_shared<task_metadata>("B", 2));
+	auto C_meta = std::make_shared<task_metadata>("C", 2);
+	C_meta->order_hint = 0.5;
+	shared_ptr<task_base> C = make_shared<test_task>(id++, C_meta);
+	auto D_meta = std::make_shared<task_metadata>("D", 2);
+	D_meta->order_hint = 0.25;
+	shared_ptr<task_base> D = make_shared<test_task>(id++, D_meta);
+	shared_ptr<task_base> E = make_shared<test_task>(id++, std::make_shared<task_metadata>("E", 3));
+	for (auto &child : {B, C, D, E}) {
+		A->add_children(child);
+		child->add_parent(A);
+	}
+	expected_result = {A, E, C, D, B};
+
+	// sort itself
+	helpers::topological_sort(A, result);
+	// and check it
+	ASSERT_EQ(result, expected_result);
+}
+
 TEST(topological_sort_test, top_sort_cycle_1)
 {
 	// initialization
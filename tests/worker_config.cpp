@@ -42,6 +42,7 @@ TEST(worker_config, load_yaml_basic)
 						   "    parallel: 1\n"
 						   "    disk-size: 50\n"
 						   "    disk-files: 7\n"
+						   "    instructions: 2000000000\n"
 						   "    environ-variable:\n"
 						   "        ISOLATE_BOX: /box\n"
 						   "        ISOLATE_TMP: /tmp\n"
@@ -53,8 +54,51 @@ TEST(worker_config, load_yaml_basic)
 						   "          dst: share\n"
 						   "          mode: MAYBE\n"
 						   "max-output-length: 1024\n"
+						   "output-tail-length: 256\n"
 						   "max-carboncopy-length: 1048576\n"
 						   "cleanup-submission: true\n"
+						   "result-cache:\n"
+						   "    enabled: true\n"
+						   "    cache-dir: /tmp/isoeval/results\n"
+						   "result-timings: true\n"
+						   "stream-results: true\n"
+						   "job-wall-time: 120.5\n"
+						   "failure-history:\n"
+						   "    enabled: true\n"
+						   "    file: /tmp/history.yml\n"
+						   "result-format: cbor\n"
+						   "box-pool:\n"
+						   "    size: 2\n"
+						   "    first-box-id: 100\n"
+						   "box-data-transfer: rename\n"
+						   "cgroup-metrics:\n"
+						   "    enabled: true\n"
+						   "    root: /sys/fs/cgroup/isolate\n"
+						   "    sample-interval: 50\n"
+						   "namespace-sandbox:\n"
+						   "    cgroup-root: /sys/fs/cgroup/recodex\n"
+						   "    uid: 60000\n"
+						   "    gid: 60001\n"
+						   "cpuset:\n"
+						   "    cpus: 2-3\n"
+						   "    mems: 0\n"
+						   "    exclusive: true\n"
+						   "    boxes:\n"
+						   "        100: 3\n"
+						   "tmpfs:\n"
+						   "    dir: /dev/shm/recodex\n"
+						   "    min-free: 65536\n"
+						   "box-session: true\n"
+						   "perf-counters: true\n"
+						   "max-repeat: 3\n"
+						   "host-noise:\n"
+						   "    enabled: true\n"
+						   "    max-steal: 0.02\n"
+						   "    max-load: 2\n"
+						   "calibration:\n"
+						   "    enabled: true\n"
+						   "    duration: 50\n"
+						   "output-capture: pipe\n"
 						   "...");
 
 	worker_config config(yaml);
@@ -71,6 +115,7 @@ TEST(worker_config, load_yaml_basic)
 	expected_limits.stack_size = 50000;
 	expected_limits.disk_size = 50;
 	expected_limits.disk_files = 7;
+	expected_limits.instructions = 2000000000;
 	expected_limits.bound_dirs = {std::tuple<std::string, std::string, sp>{"/usr/local/bin", "localbin", sp::RW},
 		std::tuple<std::string, std::string, sp>{"/usr/share", "share", sp::MAYBE}};
 	if (config.get_limits().environ_vars.at(0).first == "ISOLATE_TMP") {
@@ -109,8 +154,44 @@ TEST(worker_config, load_yaml_basic)
 	ASSERT_EQ(std::chrono::milliseconds(5487), config.get_broker_ping_interval());
 	ASSERT_EQ((std::size_t) 1245, config.get_max_broker_liveness());
 	ASSERT_EQ((std::size_t) 1024, config.get_max_output_length());
+	ASSERT_EQ((std::size_t) 256, config.get_output_tail_length());
 	ASSERT_EQ((std::size_t) 1048576, config.get_max_carboncopy_length());
 	ASSERT_EQ(true, config.get_cleanup_submission());
+	ASSERT_EQ(true, config.get_result_cache_enabled());
+	ASSERT_EQ("/tmp/isoeval/results", config.get_result_cache_dir());
+	ASSERT_EQ(true, config.get_result_timings());
+	ASSERT_EQ(true, config.get_stream_results());
+	ASSERT_EQ(120.5, config.get_job_wall_time());
+	ASSERT_EQ(true, config.get_failure_history_enabled());
+	ASSERT_EQ("/tmp/history.yml", config.get_failure_history_file());
+	ASSERT_EQ("cbor", config.get_result_format());
+	ASSERT_EQ(2u, config.get_box_pool_size());
+	ASSERT_EQ(100u, config.get_box_pool_first_id());
+	ASSERT_EQ("rename", config.get_box_data_transfer());
+	ASSERT_TRUE(config.get_cgroup_metrics_enabled());
+	ASSERT_EQ("/sys/fs/cgroup/isolate", config.get_cgroup_root());
+	ASSERT_EQ(50u, config.get_cgroup_sample_interval());
+	ASSERT_EQ("/sys/fs/cgroup/recodex", config.get_namespace_cgroup_root());
+	ASSERT_EQ(60000u, config.get_namespace_uid());
+	ASSERT_EQ(60001u, config.get_namespace_gid());
+	ASSERT_EQ(std::vector<std::size_t>({2, 3}), config.get_cpu_placement().cpus);
+	ASSERT_EQ(std::vector<std::size_t>({0}), config.get_cpu_placement().mems);
+	ASSERT_EQ(std::vector<std::size_t>({3}), config.get_cpu_placement().get_cpus(100));
+	ASSERT_TRUE(config.get_cpuset_exclusive());
+	ASSERT_EQ("/dev/shm/recodex", config.get_tmpfs_dir());
+	ASSERT_EQ(65536u, config.get_tmpfs_min_free());
+	ASSERT_TRUE(config.get_box_session());
+	ASSERT_TRUE(config.get_perf_counters());
+	ASSERT_EQ(3u, config.get_max_repeat());
+	ASSERT_TRUE(config.get_host_noise().enabled);
+	ASSERT_FLOAT_EQ(0.02, config.get_host_noise().max_steal);
+	ASSERT_FLOAT_EQ(0.1, config.get_host_noise().max_frequency_change);
+	ASSERT_FLOAT_EQ(2, config.get_host_noise().max_load);
+	ASSERT_TRUE(config.get_calibration().enabled);
+	ASSERT_EQ(50u, config.get_calibration().duration);
+	ASSERT_EQ("pipe", config.get_output_capture());
+	ASSERT_THAT(config.get_results_config(), testing::HasSubstr("max-output-length"));
+	ASSERT_THAT(config.get_results_config(), testing::Not(testing::HasSubstr("worker-id")));
 }
 
 /**
@@ -161,3 +242,44 @@ TEST(worker_config, invalid_broker_uri)
 
 	ASSERT_THROW(worker_config config(yaml), config_error);
 }
+
+/**
+ * Unknown format of results causes an exception
+ */
+TEST(worker_config, invalid_result_format)
+{
+	auto yaml = YAML::Load("worker-id: 1\n"
+						   "broker-uri: tcp://localhost:1234\n"
+						   "headers:\n"
+						   "    env:\n"
+						   "        - c\n"
+						   "hwgroup: group_1\n"
+						   "file-managers:\n"
+						   "    - hostname: http://localhost:80\n"
+						   "      username: \"654321\"\n"
+						   "      password: \"123456\"\n"
+						   "result-format: xml\n");
+
+	ASSERT_THROW(worker_config config(yaml), config_error);
+}
+
+/**
+ * Malformed list of CPUs causes an exception
+ */
+TEST(worker_config, invalid_cpuset)
+{
+	auto yaml = YAML::Load("worker-id: 1\n"
+						   "broker-uri: tcp://localhost:1234\n"
+						   "headers:\n"
+						   "    env:\n"
+						   "        - c\n"
+						   "hwgroup: group_1\n"
+						   "file-managers:\n"
+						   "    - hostname: http://localhost:80\n"
+						   "      username: \"654321\"\n"
+						   "      password: \"123456\"\n"
+						   "cpuset:\n"
+						   "    cpus: 3-1\n");
+
+	ASSERT_THROW(worker_config config(yaml), config_error);
+}